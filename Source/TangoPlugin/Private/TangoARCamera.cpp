@@ -16,12 +16,9 @@ limitations under the License.*/
 #include "TangoARCamera.h"
 #include "TangoDevice.h"
 #include "TangoARHelpers.h"
+#include "TangoViewExtension.h"
 
-UTangoARCamera::~UTangoARCamera()
-{
-}
-
-UTangoARCamera::UTangoARCamera(const FObjectInitializer& Init) : ARScreen(nullptr), bScreenIsVisible(true), Super(Init)
+UTangoARCamera::UTangoARCamera(const FObjectInitializer& Init) : ARScreen(nullptr), bScreenIsVisible(true), bLateUpdate(false), bHasCameraPose(false), Super(Init)
 {
 	PrimaryComponentTick.bCanEverTick = true;
 	bWantsInitializeComponent = true;
@@ -42,6 +39,26 @@ USceneComponent * UTangoARCamera::AsSceneComponent()
 void UTangoARCamera::BeginPlay()
 {
 	Super::BeginPlay();
+	//Registered even while bLateUpdate is off so it can be switched at runtime, it does nothing until then
+	if (GEngine != nullptr && !ViewExtension.IsValid())
+	{
+		ViewExtension = MakeShareable(new FTangoViewExtension(this));
+		GEngine->ViewExtensions.Add(ViewExtension);
+	}
+}
+
+void UTangoARCamera::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (ViewExtension.IsValid())
+	{
+		if (GEngine != nullptr)
+		{
+			GEngine->ViewExtensions.Remove(ViewExtension);
+		}
+		ViewExtension.Reset();
+	}
+	bHasCameraPose = false;
+	Super::EndPlay(EndPlayReason);
 }
 
 void UTangoARCamera::InitializeComponent()
@@ -111,6 +128,7 @@ void UTangoARCamera::TickComponent(float DeltaTime, enum ELevelTick TickType, FA
 				AActor* Owner = GetOwner();
 				Owner->SetActorLocation(LatestPose.Position);
 				Owner->SetActorRotation(LatestPose.Rotation);
+				bHasCameraPose = true;
 				//UE_LOG(TangoPlugin, Log, TEXT("Set Pose %s %s, %s"), *Owner->GetName(), *LatestPose.Position.ToString(), *LatestPose.Rotation.ToString());
 			}
 			else
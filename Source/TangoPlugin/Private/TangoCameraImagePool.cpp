@@ -0,0 +1,262 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+
+#include "TangoPluginPrivatePCH.h"
+#include "TangoCameraImagePool.h"
+#include "TangoImageKernels.h"
+
+DECLARE_CYCLE_STAT(TEXT("Camera Luma Pyramid"), STAT_TangoCameraLumaPyramid, STATGROUP_Tango);
+
+FTangoLumaImage FTangoCameraImage::GetLumaLayout(int32 Level) const
+{
+	FTangoLumaImage Result;
+	if (Level == 0)
+	{
+		Result.Data = GetY();
+		Result.Width = Width;
+		Result.Height = Height;
+		Result.Stride = Stride;
+		return Result;
+	}
+	const uint8* LevelData = LumaPyramid.GetData();
+	for (int32 i = 1; i < Level; ++i)
+	{
+		LevelData += (Width >> i) * (Height >> i);
+	}
+	Result.Data = LevelData;
+	Result.Width = Width >> Level;
+	Result.Height = Height >> Level;
+	Result.Stride = Result.Width;
+	return Result;
+}
+
+FTangoLumaImage FTangoCameraImage::GetLuma(int32 Level) const
+{
+	if (Level < 0 || Level >= NumLumaLevels || Data.Num() == 0)
+	{
+		return FTangoLumaImage();
+	}
+	if (Level >= NumBuiltLumaLevels)
+	{
+		FScopeLock Lock(&LumaPyramidLock);
+		SCOPE_CYCLE_COUNTER(STAT_TangoCameraLumaPyramid);
+		if (NumBuiltLumaLevels == 1)
+		{
+			int32 NumBytes = 0;
+			for (int32 i = 1; i < NumLumaLevels; ++i)
+			{
+				NumBytes += (Width >> i) * (Height >> i);
+			}
+			LumaPyramid.SetNumUninitialized(NumBytes, false);
+		}
+		//Each level is built from the one above, so asking for the smallest builds them all
+		while (NumBuiltLumaLevels <= Level)
+		{
+			const int32 Built = NumBuiltLumaLevels;
+			const FTangoLumaImage Above = GetLumaLayout(Built - 1);
+			const FTangoLumaImage Below = GetLumaLayout(Built);
+			TangoImageKernels::DownsampleLuma(Above.Data, Above.Width, Above.Height, Above.Stride, const_cast<uint8*>(Below.Data), Below.Stride);
+			FPlatformMisc::MemoryBarrier();
+			FPlatformAtomics::InterlockedExchange(&NumBuiltLumaLevels, Built + 1);
+		}
+	}
+	//Pairs with the barrier before a level is published
+	FPlatformMisc::MemoryBarrier();
+	return GetLumaLayout(Level);
+}
+
+TangoCameraImagePool::TangoCameraImagePool(int32 NumImages)
+{
+	//One image is usually held by the slowest consumer, so we need at least two to make progress
+	Images.SetNum(FMath::Clamp(NumImages, 2, 16));
+	for (TSharedPtr<FTangoCameraImage, ESPMode::ThreadSafe>& Image : Images)
+	{
+		Image = MakeShareable(new FTangoCameraImage());
+	}
+}
+
+int32 TangoCameraImagePool::GetNumHeld() const
+{
+	int32 NumHeld = 0;
+	for (const TSharedPtr<FTangoCameraImage, ESPMode::ThreadSafe>& Image : Images)
+	{
+		if (!Image.IsUnique())
+		{
+			NumHeld++;
+		}
+	}
+	return NumHeld;
+}
+
+bool TangoCameraImagePool::GetCopyRegion(int32 Width, int32 Height, const FTangoCameraImageRequest& Request, FIntRect& OutRect, int32& OutDecimation)
+{
+	OutDecimation = 1 << FMath::Min((int32)FMath::FloorLog2((uint32)FMath::Max(Request.Decimation, 1)), 3);
+	//A chroma sample of the copy covers Block x Block camera pixels, so the region is widened to whole blocks
+	const int32 Block = 2 * OutDecimation;
+	auto GetRange = [Block](float Min, float Max, int32 Size, int32& OutMin, int32& OutMax)
+	{
+		OutMin = FMath::Clamp(FMath::FloorToInt(Min * Size), 0, Size) / Block * Block;
+		OutMax = OutMin + Align(FMath::Clamp(FMath::CeilToInt(Max * Size), 0, Size) - OutMin, Block);
+		if (OutMax > Size)
+		{
+			OutMax -= Block;
+		}
+		return OutMax > OutMin;
+	};
+	return GetRange(Request.Region.Min.X, Request.Region.Max.X, Width, OutRect.Min.X, OutRect.Max.X)
+		&& GetRange(Request.Region.Min.Y, Request.Region.Max.Y, Height, OutRect.Min.Y, OutRect.Max.Y);
+}
+
+#if PLATFORM_ANDROID
+FTangoCameraImagePtr TangoCameraImagePool::Write(const TangoImageBuffer* Buffer)
+{
+	if (Buffer == nullptr)
+	{
+		return nullptr;
+	}
+	return Write(Buffer, FIntRect(0, 0, Buffer->width, Buffer->height), 1);
+}
+
+FTangoCameraImagePtr TangoCameraImagePool::Write(const TangoImageBuffer* Buffer, const FIntRect& Rect, int32 Decimation)
+{
+	if (Buffer == nullptr || Buffer->data == nullptr)
+	{
+		return nullptr;
+	}
+	const int32 Stride = Buffer->stride;
+	const int32 Height = Buffer->height;
+	ETangoImageFormat Format;
+	int32 ChromaStride;
+	if (Buffer->format == TANGO_HAL_PIXEL_FORMAT_YCrCb_420_SP)
+	{
+		Format = ETangoImageFormat::TANGO_HAL_PIXEL_FORMAT_YCrCb_420_SP;
+		ChromaStride = Stride;
+	}
+	else if (Buffer->format == TANGO_HAL_PIXEL_FORMAT_YV12)
+	{
+		//Android aligns the rows of the chroma planes to 16 bytes
+		Format = ETangoImageFormat::TANGO_HAL_PIXEL_FORMAT_YV12;
+		ChromaStride = Align(Stride / 2, 16);
+	}
+	else
+	{
+		static bool bWarned = false;
+		if (!bWarned)
+		{
+			bWarned = true;
+			UE_LOG(TangoPlugin, Warning, TEXT("TangoCameraImagePool::Write: Camera image format %d is not supported"), (int32)Buffer->format);
+		}
+		return nullptr;
+	}
+	const bool bYV12 = Format == ETangoImageFormat::TANGO_HAL_PIXEL_FORMAT_YV12;
+	const bool bFullImage = Decimation == 1 && Rect == FIntRect(0, 0, Buffer->width, Height);
+
+	//Only the pool references a unique image, so no consumer can be reading it. Only this thread hands out new references.
+	const int32 Index = Images.IndexOfByPredicate([](const TSharedPtr<FTangoCameraImage, ESPMode::ThreadSafe>& Pooled) { return Pooled.IsUnique(); });
+	if (Index == INDEX_NONE)
+	{
+		DroppedImages.Increment();
+		return nullptr;
+	}
+	FTangoCameraImage* Image = Images[Index].Get();
+	//The buffer is only valid during the callback, so the planes are copied out of it
+	if (bFullImage)
+	{
+		//Both layouts hold half a luma plane of chroma
+		const int32 NumBytes = Stride * Height + (bYV12 ? ChromaStride * Height : Stride * Height / 2);
+		Image->Data.SetNumUninitialized(NumBytes, false);
+		FMemory::Memcpy(Image->Data.GetData(), Buffer->data, NumBytes);
+		Image->Width = Buffer->width;
+		Image->Height = Height;
+		Image->Stride = Stride;
+		Image->ChromaStride = ChromaStride;
+	}
+	else
+	{
+		const int32 Width = Rect.Width() / Decimation;
+		const int32 OutHeight = Rect.Height() / Decimation;
+		//YV12 copies keep the Android layout, rows of a multiple of 32 bytes give chroma rows of a multiple of 16
+		const int32 OutStride = bYV12 ? Align(Width, 32) : Width;
+		const int32 OutChromaStride = bYV12 ? OutStride / 2 : OutStride;
+		Image->Data.SetNumUninitialized(OutStride * OutHeight + (bYV12 ? OutChromaStride * OutHeight : OutStride * OutHeight / 2), false);
+		Image->Width = Width;
+		Image->Height = OutHeight;
+		Image->Stride = OutStride;
+		Image->ChromaStride = OutChromaStride;
+
+		const uint8* InY = Buffer->data;
+		uint8* OutY = Image->Data.GetData();
+		for (int32 Y = 0; Y < OutHeight; ++Y)
+		{
+			const uint8* InRow = InY + (Rect.Min.Y + Y * Decimation) * Stride + Rect.Min.X;
+			uint8* OutRow = OutY + Y * OutStride;
+			if (Decimation == 1)
+			{
+				FMemory::Memcpy(OutRow, InRow, Width);
+				continue;
+			}
+			for (int32 X = 0; X < Width; ++X)
+			{
+				OutRow[X] = InRow[X * Decimation];
+			}
+		}
+
+		//Chroma rows and columns of the region, in chroma samples
+		const int32 ChromaX = Rect.Min.X / 2;
+		const int32 ChromaY = Rect.Min.Y / 2;
+		const int32 ChromaWidth = Width / 2;
+		const uint8* InChroma = InY + Stride * Height;
+		uint8* OutChroma = OutY + OutStride * OutHeight;
+		//NV21 has one plane of VU pairs, YV12 a V plane followed by a U plane
+		const int32 NumPlanes = bYV12 ? 2 : 1;
+		const int32 SampleBytes = bYV12 ? 1 : 2;
+		for (int32 Plane = 0; Plane < NumPlanes; ++Plane)
+		{
+			const uint8* InPlane = InChroma + Plane * ChromaStride * Height / 2;
+			uint8* OutPlane = OutChroma + Plane * OutChromaStride * OutHeight / 2;
+			for (int32 Y = 0; Y < OutHeight / 2; ++Y)
+			{
+				const uint8* InRow = InPlane + (ChromaY + Y * Decimation) * ChromaStride + ChromaX * SampleBytes;
+				uint8* OutRow = OutPlane + Y * OutChromaStride;
+				if (Decimation == 1)
+				{
+					FMemory::Memcpy(OutRow, InRow, ChromaWidth * SampleBytes);
+					continue;
+				}
+				for (int32 X = 0; X < ChromaWidth; ++X)
+				{
+					for (int32 Byte = 0; Byte < SampleBytes; ++Byte)
+					{
+						OutRow[X * SampleBytes + Byte] = InRow[X * Decimation * SampleBytes + Byte];
+					}
+				}
+			}
+		}
+	}
+	Image->Format = Format;
+	Image->Timestamp = Buffer->timestamp;
+	Image->FrameNumber = Buffer->frame_number;
+	Image->Origin = Rect.Min;
+	Image->Decimation = Decimation;
+	Image->ResetLumaPyramid();
+	Image->Buffer = *Buffer;
+	Image->Buffer.width = Image->Width;
+	Image->Buffer.height = Image->Height;
+	Image->Buffer.stride = Image->Stride;
+	Image->Buffer.data = Image->Data.GetData();
+	CopiedImages.Increment();
+	return Images[Index];
+}
+#endif
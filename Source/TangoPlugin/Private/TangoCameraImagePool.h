@@ -0,0 +1,58 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+
+#pragma once
+
+#include "TangoImageComponent.h"
+
+#if PLATFORM_ANDROID
+#include "tango_client_api.h"
+#endif
+
+/**
+ * A fixed number of owned colour camera images, written by the Tango frame callback and shared with consumers on any thread.
+ * Each image, or the region of it a listener asked for, is copied out of the callback once. Consumers keep it alive by holding the returned pointer.
+ * An image is recycled once only the pool references it. If consumers hold every image, the new one is dropped instead.
+ */
+class TangoCameraImagePool
+{
+public:
+	TangoCameraImagePool(int32 NumImages);
+
+	/**
+	 * The camera pixels and decimation a request copies from an image of Width x Height, see FTangoCameraImageRequest.
+	 * Returns false if the region holds no whole chroma sample of the decimated image.
+	 */
+	static bool GetCopyRegion(int32 Width, int32 Height, const FTangoCameraImageRequest& Request, FIntRect& OutRect, int32& OutDecimation);
+
+#if PLATFORM_ANDROID
+	/** Copies Buffer into a free image. Returns null if the format is not supported or every image is held. Camera callback thread only. */
+	FTangoCameraImagePtr Write(const TangoImageBuffer* Buffer);
+	/** Copies every Decimation-th pixel of Rect of Buffer, Rect as returned by GetCopyRegion. Camera callback thread only. */
+	FTangoCameraImagePtr Write(const TangoImageBuffer* Buffer, const FIntRect& Rect, int32 Decimation);
+#endif
+
+	int32 GetNumImages() const { return Images.Num(); }
+	/** Number of images held by a consumer. Only a snapshot, consumers release images on their own threads. */
+	int32 GetNumHeld() const;
+	int32 GetDroppedImageCount() const { return DroppedImages.GetValue(); }
+	int32 GetCopiedImageCount() const { return CopiedImages.GetValue(); }
+
+private:
+	//Never resized, so the stats can walk it from other threads
+	TArray<TSharedPtr<FTangoCameraImage, ESPMode::ThreadSafe>> Images;
+	FThreadSafeCounter DroppedImages;
+	FThreadSafeCounter CopiedImages;
+};
@@ -24,10 +24,80 @@ limitations under the License.*/
 namespace 
 {
 
-	static TMap<ETangoCoordinateFrameType, TMap<ETangoCoordinateFrameType, TangoSpaceConversions::TangoSpaceConversionPair>> TangoSpaceConversionPairMapper;
+	//Indexed by base and target frame, only pairs that can be converted are valid
+	static TangoSpaceConversions::TangoSpaceConversionPair TangoSpaceConversionTable[TangoSpaceConversions::NumFrames][TangoSpaceConversions::NumFrames];
+	static bool bIsConvertible[TangoSpaceConversions::NumFrames][TangoSpaceConversions::NumFrames];
 
 	static bool bMatricesArePrepared = false;
 
+	struct FFrameToUETable
+	{
+		FMatrix FrameToUE[TangoSpaceConversions::NumFrames];
+
+		FFrameToUETable()
+		{
+			FMatrix ADFtoUE;
+			FMatrix DEVICEtoUE;
+			FMatrix IMUtoUE;
+			FMatrix COLORtoUE;
+			FMatrix DISPLAYtoUE;
+
+			ADFtoUE = FMatrix::Identity;ADFtoUE.M[0][0] = 0;ADFtoUE.M[1][1] = 0;ADFtoUE.M[2][2] = 0;
+			ADFtoUE.M[0][1] = 1;
+			ADFtoUE.M[1][0] = 1;
+			ADFtoUE.M[2][2] = 1;
+			DEVICEtoUE = FMatrix::Identity;DEVICEtoUE.M[0][0] = 0;DEVICEtoUE.M[1][1] = 0;DEVICEtoUE.M[2][2] = 0;
+			DEVICEtoUE.M[0][2] = -1;
+			DEVICEtoUE.M[1][0] = 1;
+			DEVICEtoUE.M[2][1] = 1;
+			IMUtoUE = FMatrix::Identity;IMUtoUE.M[0][0] = 0;IMUtoUE.M[1][1] = 0;IMUtoUE.M[2][2] = 0;
+			IMUtoUE.M[0][2] = -1;
+			IMUtoUE.M[1][1] = 1;
+			IMUtoUE.M[2][0] = -1;
+			COLORtoUE = FMatrix::Identity;COLORtoUE.M[0][0] = 0;COLORtoUE.M[1][1] = 0;COLORtoUE.M[2][2] = 0;
+			COLORtoUE.M[0][2] = 1;
+			COLORtoUE.M[1][0] = 1;
+			COLORtoUE.M[2][1] = -1;
+			DISPLAYtoUE = FMatrix::Identity;DISPLAYtoUE.M[0][0] = 0;DISPLAYtoUE.M[1][1] = 0;DISPLAYtoUE.M[2][2] = 0;
+			DISPLAYtoUE.M[0][2] = -1;
+			DISPLAYtoUE.M[1][0] = 1;
+			DISPLAYtoUE.M[2][1] = 1;
+
+			//There is no axis convention for GLOBAL_WGS84, it is never converted
+			FrameToUE[(int32)ETangoCoordinateFrameType::GLOBAL_WGS84] =			FMatrix::Identity;
+			FrameToUE[(int32)ETangoCoordinateFrameType::AREA_DESCRIPTION] =		ADFtoUE;
+			FrameToUE[(int32)ETangoCoordinateFrameType::START_OF_SERVICE] =		ADFtoUE;
+			FrameToUE[(int32)ETangoCoordinateFrameType::PREVIOUS_DEVICE_POSE] =	DEVICEtoUE;
+			FrameToUE[(int32)ETangoCoordinateFrameType::DEVICE] =				DEVICEtoUE;
+			FrameToUE[(int32)ETangoCoordinateFrameType::IMU] =					IMUtoUE;
+			FrameToUE[(int32)ETangoCoordinateFrameType::DISPLAY] =				DISPLAYtoUE;
+			FrameToUE[(int32)ETangoCoordinateFrameType::CAMERA_COLOR] =			COLORtoUE;
+			FrameToUE[(int32)ETangoCoordinateFrameType::CAMERA_DEPTH] =			COLORtoUE;
+			FrameToUE[(int32)ETangoCoordinateFrameType::CAMERA_FISHEYE] =		COLORtoUE;
+		}
+	};
+
+	static const FFrameToUETable& GetFrameToUETable()
+	{
+		//The axis conventions are constants, they do not need the service
+		static const FFrameToUETable Table;
+		return Table;
+	}
+
+	//Every frame to UE conversion is a reflection, its negation is a proper rotation
+	static FMatrix NegateRotation(const FMatrix& Matrix)
+	{
+		FMatrix Result = Matrix;
+		for (int32 Row = 0; Row < 3; ++Row)
+		{
+			for (int32 Column = 0; Column < 3; ++Column)
+			{
+				Result.M[Row][Column] = -Result.M[Row][Column];
+			}
+		}
+		return Result;
+	}
+
 	static bool GetOffsetMatrix(FTangoCoordinateFramePair Pair,FMatrix& Matrix)
 	{
 #if PLATFORM_ANDROID
@@ -53,12 +123,6 @@ namespace
 		{
 			return true;
 		}
-		FMatrix ADFtoUE;
-		FMatrix DEVICEtoUE;
-		FMatrix IMUtoUE;
-		FMatrix COLORtoUE;
-		FMatrix DISPLAYtoUE;
-
 		FMatrix IMUtoDEVICE;
 		FMatrix IMUtoCOLOR;
 		FMatrix IMUtoDEPTH;
@@ -73,40 +137,8 @@ namespace
 
 		FMatrix DEVICEtoIMU = IMUtoDEVICE.Inverse();
 
-		ADFtoUE = FMatrix::Identity;ADFtoUE.M[0][0] = 0;ADFtoUE.M[1][1] = 0;ADFtoUE.M[2][2] = 0;
-		ADFtoUE.M[0][1] = 1;
-		ADFtoUE.M[1][0] = 1;
-		ADFtoUE.M[2][2] = 1;
-		DEVICEtoUE = FMatrix::Identity;DEVICEtoUE.M[0][0] = 0;DEVICEtoUE.M[1][1] = 0;DEVICEtoUE.M[2][2] = 0;
-		DEVICEtoUE.M[0][2] = -1;
-		DEVICEtoUE.M[1][0] = 1;
-		DEVICEtoUE.M[2][1] = 1;
-		IMUtoUE = FMatrix::Identity;IMUtoUE.M[0][0] = 0;IMUtoUE.M[1][1] = 0;IMUtoUE.M[2][2] = 0;
-		IMUtoUE.M[0][2] = -1;
-		IMUtoUE.M[1][1] = 1;
-		IMUtoUE.M[2][0] = -1;
-		COLORtoUE = FMatrix::Identity;COLORtoUE.M[0][0] = 0;COLORtoUE.M[1][1] = 0;COLORtoUE.M[2][2] = 0;
-		COLORtoUE.M[0][2] = 1;
-		COLORtoUE.M[1][0] = 1;
-		COLORtoUE.M[2][1] = -1;
-		DISPLAYtoUE = FMatrix::Identity;DISPLAYtoUE.M[0][0] = 0;DISPLAYtoUE.M[1][1] = 0;DISPLAYtoUE.M[2][2] = 0;
-		DISPLAYtoUE.M[0][2] = -1;
-		DISPLAYtoUE.M[1][0] = 1;
-		DISPLAYtoUE.M[2][1] = 1;
-
-		TMap<ETangoCoordinateFrameType, FMatrix> ToUESpace;
 		TMap<ETangoCoordinateFrameType, FMatrix> DeviceToOffset;
 
-		ToUESpace.Emplace(ETangoCoordinateFrameType::AREA_DESCRIPTION,		ADFtoUE);
-		ToUESpace.Emplace(ETangoCoordinateFrameType::START_OF_SERVICE,		ADFtoUE);
-		ToUESpace.Emplace(ETangoCoordinateFrameType::PREVIOUS_DEVICE_POSE,	DEVICEtoUE);
-		ToUESpace.Emplace(ETangoCoordinateFrameType::DEVICE,				DEVICEtoUE);
-		ToUESpace.Emplace(ETangoCoordinateFrameType::IMU,					IMUtoUE);
-		ToUESpace.Emplace(ETangoCoordinateFrameType::DISPLAY,				DISPLAYtoUE);
-		ToUESpace.Emplace(ETangoCoordinateFrameType::CAMERA_COLOR,			COLORtoUE);
-		ToUESpace.Emplace(ETangoCoordinateFrameType::CAMERA_DEPTH,			COLORtoUE);
-		ToUESpace.Emplace(ETangoCoordinateFrameType::CAMERA_FISHEYE,		COLORtoUE);
-
 		DeviceToOffset.Emplace(ETangoCoordinateFrameType::CAMERA_COLOR,		IMUtoCOLOR * DEVICEtoIMU);
 		DeviceToOffset.Emplace(ETangoCoordinateFrameType::CAMERA_DEPTH,		IMUtoCOLOR * DEVICEtoIMU);
 		DeviceToOffset.Emplace(ETangoCoordinateFrameType::CAMERA_FISHEYE,	IMUtoFISHEYE * DEVICEtoIMU);
@@ -114,12 +146,14 @@ namespace
 		DeviceToOffset.Emplace(ETangoCoordinateFrameType::IMU,				DEVICEtoIMU);
 		DeviceToOffset.Emplace(ETangoCoordinateFrameType::DEVICE,			FMatrix::Identity);
 
-		TangoSpaceConversionPairMapper.Empty(9);
-		for (int32 i = 1; i < 10; ++i)//Iterate over ETangoCoordinateFrameType and igore GLOBAL_WGS84
+		const FFrameToUETable& ToUESpace = GetFrameToUETable();
+		FMemory::Memzero(bIsConvertible);
+		for (int32 i = 1; i < TangoSpaceConversions::NumFrames; ++i)//Iterate over ETangoCoordinateFrameType and igore GLOBAL_WGS84
 		{
-			for (int32 j = 1; j < 10; ++j)//Iterate over ETangoCoordinateFrameType and igore GLOBAL_WGS84
+			for (int32 j = 1; j < TangoSpaceConversions::NumFrames; ++j)//Iterate over ETangoCoordinateFrameType and igore GLOBAL_WGS84
 			{
 				TangoSpaceConversions::TangoSpaceConversionPair P;
+				FMatrix OffsetFromDevice;
 				P.Pair.BaseFrame = (ETangoCoordinateFrameType)i;
 				P.Pair.TargetFrame = (ETangoCoordinateFrameType)j;
 
@@ -129,8 +163,8 @@ namespace
 					continue;
 				}
 
-				P.UEtoBaseFrame = ToUESpace[P.Pair.BaseFrame].Inverse();
-				P.TargetFrameToUE = ToUESpace[P.Pair.TargetFrame];
+				const FMatrix UEtoBaseFrame = ToUESpace.FrameToUE[i].Inverse();
+				const FMatrix TargetFrameToUE = ToUESpace.FrameToUE[j];
 
 				if (DeviceToOffset.Contains(P.Pair.BaseFrame))//If we are querying from something on the device ...
 				{
@@ -142,7 +176,7 @@ namespace
 					else //... yo something on the device ...
 					{
 						//... we have a static query that never changes
-						P.OffsetFromDevice = DeviceToOffset[P.Pair.BaseFrame].Inverse() * DeviceToOffset[P.Pair.TargetFrame];
+						OffsetFromDevice = DeviceToOffset[P.Pair.BaseFrame].Inverse() * DeviceToOffset[P.Pair.TargetFrame];
 						P.bIsStatic = true;
 						P.bNeedToBeQueriedFromDevice = false;
 					}
@@ -150,58 +184,83 @@ namespace
 				else if (DeviceToOffset.Contains(P.Pair.TargetFrame)) //If we query from a world base frame to something on the device...
 				{
 					// ... we need to query to device and apply the offset manually
-					P.OffsetFromDevice = DeviceToOffset[P.Pair.TargetFrame];
+					OffsetFromDevice = DeviceToOffset[P.Pair.TargetFrame];
 					P.bNeedToBeQueriedFromDevice = true;
 					P.bIsStatic = false;
 				}
 				else // Anything else is just fine
 				{
-					P.OffsetFromDevice = FMatrix::Identity;
+					OffsetFromDevice = FMatrix::Identity;
 					P.bIsStatic = false;
 					P.bNeedToBeQueriedFromDevice = false;
 				}
 
-				TangoSpaceConversionPairMapper.FindOrAdd(P.Pair.BaseFrame).Emplace(P.Pair.TargetFrame, P);
+				//Precompose TargetFrameToUE * OffsetFromDevice * Pose * UEtoBaseFrame, see TangoSpaceConversionPair
+				P.PreRotation = FQuat(NegateRotation(UEtoBaseFrame));
+				P.PostRotation = FQuat(NegateRotation(TargetFrameToUE) * OffsetFromDevice);
+				P.PostTranslation = OffsetFromDevice.GetOrigin();
+				TangoSpaceConversionTable[i][j] = P;
+				bIsConvertible[i][j] = true;
 			}
 		}
 
+		//Other threads only read the table once they see the flag
+		FPlatformMisc::MemoryBarrier();
 		bMatricesArePrepared = bSuccess;
 		return bSuccess;
 	}
 }
 
+bool TangoSpaceConversions::AreConversionsPrepared()
+{
+	return bMatricesArePrepared;
+}
+
+const TangoSpaceConversions::TangoSpaceConversionPair* TangoSpaceConversions::FindSpaceConversionPair(const FTangoCoordinateFramePair& RefPair)
+{
+	//Only the game thread may build the table, other threads have to wait until it is prepared
+	if (!bMatricesArePrepared && (!IsInGameThread() || !PrepareMatrices()))
+	{
+		return nullptr;
+	}
+	const int32 Base = (int32)RefPair.BaseFrame;
+	const int32 Target = (int32)RefPair.TargetFrame;
+	if (Base >= NumFrames || Target >= NumFrames || !bIsConvertible[Base][Target])
+	{
+		return nullptr;
+	}
+	return &TangoSpaceConversionTable[Base][Target];
+}
+
 bool TangoSpaceConversions::GetSpaceConversionPair(TangoSpaceConversionPair& Pair, const FTangoCoordinateFramePair& RefPair)
 {
-	bool bResult = PrepareMatrices();
-	bResult = bResult && TangoSpaceConversionPairMapper.Contains(RefPair.BaseFrame);
-	if (bResult)
+	const TangoSpaceConversionPair* Found = FindSpaceConversionPair(RefPair);
+	if (Found != nullptr)
 	{
-		bResult = bResult && TangoSpaceConversionPairMapper[RefPair.BaseFrame].Contains(RefPair.TargetFrame);
-		if (bResult)
-		{
-			Pair = TangoSpaceConversionPairMapper[RefPair.BaseFrame][RefPair.TargetFrame];
-		}
+		Pair = *Found;
 	}
-	return bResult;
+	return Found != nullptr;
+}
+
+const FMatrix& TangoSpaceConversions::GetFrameToUE(ETangoCoordinateFrameType Frame)
+{
+	return GetFrameToUETable().FrameToUE[FMath::Min((int32)Frame, NumFrames - 1)];
 }
 
 void TangoSpaceConversions::ModifyPose(FTangoPoseData& Pose, const TangoSpaceConversionPair& Converter)
 {
 	if (Converter.bIsStatic)//Just querying extrinsics
 	{
-		FTransform Transform = FTransform(Converter.TargetFrameToUE * Converter.OffsetFromDevice * Converter.UEtoBaseFrame);
-		Pose.Position = Transform.GetLocation() * UTangoDevice::Get().GetMetersToWorldScale();
-		Pose.QuatRotation = Transform.GetRotation();
-		Pose.Rotation = Transform.GetRotation().Rotator();
-		Pose.FrameOfReference = Converter.Pair;
+		Pose.QuatRotation = Converter.PreRotation * Converter.PostRotation;
+		Pose.Position = Converter.PreRotation.RotateVector(Converter.PostTranslation) * -UTangoDevice::Get().GetMetersToWorldScale();
 		Pose.StatusCode = ETangoPoseStatus::VALID;
 	}
 	else
 	{
-		FTransform Transform = FTransform(Converter.TargetFrameToUE *  Converter.OffsetFromDevice *  FTransform(Pose.QuatRotation, Pose.Position).ToMatrixNoScale()* Converter.UEtoBaseFrame);
-		Pose.Position = Transform.GetLocation() * UTangoDevice::Get().GetMetersToWorldScale();
-		Pose.QuatRotation = Transform.GetRotation();
-		Pose.Rotation = Transform.GetRotation().Rotator();
-		Pose.FrameOfReference = Converter.Pair;
+		const FVector Position = Pose.QuatRotation.RotateVector(Converter.PostTranslation) + Pose.Position;
+		Pose.QuatRotation = Converter.PreRotation * Pose.QuatRotation * Converter.PostRotation;
+		Pose.Position = Converter.PreRotation.RotateVector(Position) * -UTangoDevice::Get().GetMetersToWorldScale();
 	}
-}
\ No newline at end of file
+	Pose.Rotation = Pose.QuatRotation.Rotator();
+	Pose.FrameOfReference = Converter.Pair;
+}
@@ -18,17 +18,32 @@ limitations under the License.*/
 class TangoSpaceConversions
 {
 public:
+	enum { NumFrames = (int32)ETangoCoordinateFrameType::CAMERA_FISHEYE + 1 };
+
+	/**
+	 * Converts a pose of a Tango frame pair into UE space, precomposed with the offset from the device for frames on the device.
+	 * Tango and UE differ in handedness, so the conversion is a reflection on both ends. Those cancel out for the rotation:
+	 * Rotation = PreRotation * PoseRotation * PostRotation, Position = -PreRotation(Pose(PostTranslation)).
+	 */
 	struct TangoSpaceConversionPair
 	{
 		FTangoCoordinateFramePair Pair;
-		FMatrix UEtoBaseFrame;
-		FMatrix TargetFrameToUE;
-		FMatrix OffsetFromDevice;
+		FQuat PreRotation;
+		FQuat PostRotation;
+		FVector PostTranslation;
 		bool bNeedToBeQueriedFromDevice;
 		bool bIsStatic;
 	};
 
+	//The conversion table is only rebuilt until it succeeds once, after that it may be read from any thread.
+	static bool AreConversionsPrepared();
+
 	static bool GetSpaceConversionPair(TangoSpaceConversionPair& Pair,const FTangoCoordinateFramePair& RefPair);
+	//Like GetSpaceConversionPair but without the copy. Null if the pair cannot be converted or the table is not prepared yet.
+	static const TangoSpaceConversionPair* FindSpaceConversionPair(const FTangoCoordinateFramePair& RefPair);
+
+	//Axis conversion from a Tango frame to UE space, without any scaling
+	static const FMatrix& GetFrameToUE(ETangoCoordinateFrameType Frame);
 	
 	static void ModifyPose(FTangoPoseData& Pose, const TangoSpaceConversionPair& Converter);
 };
\ No newline at end of file
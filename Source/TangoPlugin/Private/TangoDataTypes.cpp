@@ -46,13 +46,14 @@ void FTangoAreaDescription::SetFilename(const FString NewValue)
 }
 
 FTangoPoseData::FTangoPoseData(FVector NewPosition, FRotator NewRotation, FQuat NewQuatRotation, FTangoCoordinateFramePair NewFrameOfReference,
-	ETangoPoseStatus NewStatusCode, float NewTimestamp) {
+	ETangoPoseStatus NewStatusCode, double NewTimestamp) {
 	Position = NewPosition;
 	Rotation = NewRotation;
 	QuatRotation = NewQuatRotation;
 	FrameOfReference = NewFrameOfReference;
 	StatusCode = NewStatusCode;
 	Timestamp = NewTimestamp;
+	PreciseTimestamp = NewTimestamp;
 }
 
 FTangoAreaDescriptionMetaData::FTangoAreaDescriptionMetaData(const FString InFileName, const int64 InMillisecondsSinceUnixEpoch, double const InPosition[], double const InOrientation[])
@@ -0,0 +1,166 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+
+#include "TangoPluginPrivatePCH.h"
+#include "TangoDepthImageComponent.h"
+#include "TangoDepthRasterizer.h"
+#include "TangoDevice.h"
+
+float FTangoDepthImage::GetDepth(int32 X, int32 Y) const
+{
+	if (X < 0 || Y < 0 || X >= Width || Y >= Height)
+	{
+		return 0;
+	}
+	return Depth[Y * Width + X];
+}
+
+float FTangoDepthImage::GetDepthAtUV(const FVector2D& UV) const
+{
+	return GetDepth(FMath::FloorToInt(UV.X * Width), FMath::FloorToInt(UV.Y * Height));
+}
+
+bool FTangoDepthImage::IsOccluded(const FVector2D& UV, float InDepth, float Tolerance) const
+{
+	const float SurfaceDepth = GetDepthAtUV(UV);
+	return SurfaceDepth > 0 && SurfaceDepth + Tolerance < InDepth;
+}
+
+UTangoDepthImageComponent::UTangoDepthImageComponent() : Super(),
+	bUseFilteredPoints(false),
+	Downscale(4),
+	HoleFilling(ETangoDepthHoleFilling::NEAREST),
+	FillRadius(2),
+	BilateralDepthSigma(5.0f),
+	bUpdateTexture(false),
+	DepthTexture(nullptr),
+	Rasterizer(nullptr),
+	bHasIntrinsics(false),
+	LastPushedGeneration(0)
+{
+	bWantsInitializeComponent = false;
+	PrimaryComponentTick.bCanEverTick = true;
+}
+
+void UTangoDepthImageComponent::BeginPlay()
+{
+	Super::BeginPlay();
+	TangoDepthRasterizer::FSettings Settings;
+	Settings.Downscale = FMath::Clamp(Downscale, 1, 16);
+	Settings.HoleFilling = HoleFilling;
+	Settings.FillRadius = FMath::Clamp(FillRadius, 1, 8);
+	Settings.BilateralDepthSigma = BilateralDepthSigma;
+	Settings.MetersToWorldScale = UTangoDevice::Get().GetMetersToWorldScale();
+	Rasterizer = new TangoDepthRasterizer(Settings);
+	//Points are projected from the depth camera, so the local stream is all we need
+	TangoDevicePointCloud::AddStreamRequest(ETangoPointSpace::LOCAL, bUseFilteredPoints);
+}
+
+void UTangoDepthImageComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (Rasterizer != nullptr)
+	{
+		TangoDevicePointCloud::RemoveStreamRequest(ETangoPointSpace::LOCAL, bUseFilteredPoints);
+		delete Rasterizer;
+		Rasterizer = nullptr;
+	}
+	LatestImage.Reset();
+	DepthTexture = nullptr;
+	bHasIntrinsics = false;
+	Super::EndPlay(EndPlayReason);
+}
+
+void UTangoDepthImageComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	if (Rasterizer == nullptr || UTangoDevice::Get().GetTangoDevicePointCloudPointer() == nullptr)
+	{
+		return;
+	}
+
+	//The intrinsics can only be read once the service is running
+	if (UTangoDevice::Get().GetTangoDeviceImagePointer() != nullptr)
+	{
+		const double ColorTimestamp = UTangoDevice::Get().GetTangoDeviceImagePointer()->GetLastTimestamp();
+		if (bHasIntrinsics)
+		{
+			Rasterizer->SetColorTimestamp(ColorTimestamp);
+		}
+		else
+		{
+			const FTangoCameraIntrinsics Intrinsics = UTangoDevice::Get().GetCameraIntrinsics(ETangoCameraType::COLOR);
+			bHasIntrinsics = Intrinsics.Width > 0 && Intrinsics.Height > 0;
+			if (bHasIntrinsics)
+			{
+				Rasterizer->SetColorCamera(Intrinsics, ColorTimestamp);
+			}
+		}
+	}
+	if (!bHasIntrinsics)
+	{
+		return;
+	}
+
+	FTangoPointCloudFramePtr Frame = UTangoDevice::Get().GetTangoDevicePointCloudPointer()->GetLatestFrame(ETangoPointSpace::LOCAL, bUseFilteredPoints);
+	if (Frame.IsValid() && Frame->Generation != LastPushedGeneration)
+	{
+		LastPushedGeneration = Frame->Generation;
+		Rasterizer->PushFrame(Frame);
+	}
+
+	FTangoDepthImagePtr Image = Rasterizer->GetLatestImage();
+	if (Image.IsValid() && Image != LatestImage)
+	{
+		LatestImage = Image;
+		if (bUpdateTexture)
+		{
+			UpdateTexture();
+		}
+	}
+}
+
+void UTangoDepthImageComponent::UpdateTexture()
+{
+	if (DepthTexture == nullptr || DepthTexture->GetSizeX() != LatestImage->Width || DepthTexture->GetSizeY() != LatestImage->Height)
+	{
+		DepthTexture = UTexture2D::CreateTransient(LatestImage->Width, LatestImage->Height, PF_R32_FLOAT);
+		DepthTexture->SRGB = false;
+		DepthTexture->Filter = TF_Nearest;
+		DepthTexture->UpdateResource();
+	}
+	if (DepthTexture->Resource == nullptr)
+	{
+		return;
+	}
+	//The command holds a reference, so the rasterizer will not reuse the image before it is uploaded
+	ENQUEUE_UNIQUE_RENDER_COMMAND_TWOPARAMETER(UpdateTangoDepthTexture,
+		FTexture2DResource*, Resource, (FTexture2DResource*)DepthTexture->Resource,
+		FTangoDepthImagePtr, Image, LatestImage,
+		{
+			const FUpdateTextureRegion2D Region(0, 0, 0, 0, Image->Width, Image->Height);
+			RHIUpdateTexture2D(Resource->GetTexture2DRHI(), 0, Region, Image->Width * sizeof(float), (const uint8*)Image->Depth.GetData());
+		});
+}
+
+bool UTangoDepthImageComponent::GetDepthAtUV(FVector2D UV, float& Depth)
+{
+	Depth = LatestImage.IsValid() ? LatestImage->GetDepthAtUV(UV) : 0;
+	return Depth > 0;
+}
+
+bool UTangoDepthImageComponent::IsOccludedAtUV(FVector2D UV, float Depth, float Tolerance)
+{
+	return LatestImage.IsValid() && LatestImage->IsOccluded(UV, Depth, Tolerance);
+}
@@ -0,0 +1,297 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+
+#include "TangoPluginPrivatePCH.h"
+#include "TangoDepthRasterizer.h"
+
+#if PLATFORM_ANDROID
+#include "tango_client_api.h"
+#include "tango_support_api.h"
+#endif
+
+DECLARE_CYCLE_STAT(TEXT("Depth Image Rasterization"), STAT_TangoDepthRasterization, STATGROUP_Tango);
+DECLARE_CYCLE_STAT(TEXT("Depth Image Hole Filling"), STAT_TangoDepthHoleFilling, STATGROUP_Tango);
+
+TangoDepthRasterizer::TangoDepthRasterizer(const FSettings& InSettings)
+	: Settings(InSettings)
+	, ColorTimestamp(0)
+{
+	Settings.Downscale = FMath::Clamp(Settings.Downscale, 1, 16);
+	Settings.FillRadius = FMath::Clamp(Settings.FillRadius, 1, 8);
+	Settings.BilateralDepthSigma = FMath::Max(Settings.BilateralDepthSigma, 0.1f);
+
+	//Spatial part of the bilateral weights only depends on the offset
+	const int32 Size = 2 * Settings.FillRadius + 1;
+	const float SpatialSigma = FMath::Max(Settings.FillRadius * 0.5f, 0.5f);
+	SpatialWeights.SetNumUninitialized(Size * Size);
+	for (int32 Y = 0; Y < Size; ++Y)
+	{
+		for (int32 X = 0; X < Size; ++X)
+		{
+			const float DX = X - Settings.FillRadius;
+			const float DY = Y - Settings.FillRadius;
+			SpatialWeights[Y * Size + X] = FMath::Exp(-(DX * DX + DY * DY) / (2 * SpatialSigma * SpatialSigma));
+		}
+	}
+	StartThread(TEXT("TangoDepthRasterizer"));
+}
+
+TangoDepthRasterizer::~TangoDepthRasterizer()
+{
+	StopThread();
+}
+
+void TangoDepthRasterizer::SetColorCamera(const FTangoCameraIntrinsics& InIntrinsics, double InColorTimestamp)
+{
+	FScopeLock Lock(&CameraLock);
+	Intrinsics = InIntrinsics;
+	ColorTimestamp = InColorTimestamp;
+}
+
+void TangoDepthRasterizer::SetColorTimestamp(double InColorTimestamp)
+{
+	FScopeLock Lock(&CameraLock);
+	ColorTimestamp = InColorTimestamp;
+}
+
+FTangoDepthImagePtr TangoDepthRasterizer::GetLatestImage()
+{
+	FScopeLock Lock(&LatestLock);
+	return LatestImage;
+}
+
+TSharedPtr<FTangoDepthImage, ESPMode::ThreadSafe> TangoDepthRasterizer::AcquireImage()
+{
+	for (const TSharedPtr<FTangoDepthImage, ESPMode::ThreadSafe>& Image : ImagePool)
+	{
+		//Only the pool references it, so no consumer can be reading it
+		if (Image.IsUnique())
+		{
+			return Image;
+		}
+	}
+	ImagePool.Add(MakeShareable(new FTangoDepthImage()));
+	return ImagePool.Last();
+}
+
+void TangoDepthRasterizer::ProcessFrame(const FTangoPointCloudFrame& Frame)
+{
+	if (Frame.Space != ETangoPointSpace::LOCAL)
+	{
+		return;
+	}
+	FTangoCameraIntrinsics Camera;
+	double CameraTimestamp;
+	{
+		FScopeLock Lock(&CameraLock);
+		Camera = Intrinsics;
+		CameraTimestamp = ColorTimestamp;
+	}
+	if (Camera.Width <= 0 || Camera.Height <= 0 || Camera.Fx <= 0 || Camera.Fy <= 0)
+	{
+		return;
+	}
+
+	//Maps a depth camera point in Tango conventions (x right, y down, z forward, meters)
+	//to the color camera at the time of its latest image
+	FMatrix DepthToColor = FMatrix::Identity;
+#if PLATFORM_ANDROID
+	TangoPoseData pose_color_camera_t0_T_depth_camera_t1;
+	if (TangoSupport_calculateRelativePose(
+		CameraTimestamp, TANGO_COORDINATE_FRAME_CAMERA_COLOR,
+		Frame.Timestamp, TANGO_COORDINATE_FRAME_CAMERA_DEPTH,
+		&pose_color_camera_t0_T_depth_camera_t1) != TANGO_SUCCESS)
+	{
+		UE_LOG(TangoPlugin, Warning, TEXT("TangoDepthRasterizer::ProcessFrame: could not calculate relative pose"));
+		return;
+	}
+	const double* Q = pose_color_camera_t0_T_depth_camera_t1.orientation;
+	const double* T = pose_color_camera_t0_T_depth_camera_t1.translation;
+	DepthToColor = FQuatRotationTranslationMatrix(FQuat((float)Q[0], (float)Q[1], (float)Q[2], (float)Q[3]), FVector((float)T[0], (float)T[1], (float)T[2]));
+#endif
+
+	SCOPE_CYCLE_COUNTER(STAT_TangoDepthRasterization);
+	TSharedPtr<FTangoDepthImage, ESPMode::ThreadSafe> Image = AcquireImage();
+	const int32 Downscale = Settings.Downscale;
+	Image->Width = FMath::Max(Camera.Width / Downscale, 1);
+	Image->Height = FMath::Max(Camera.Height / Downscale, 1);
+	Image->Timestamp = Frame.Timestamp;
+	Image->ColorTimestamp = CameraTimestamp;
+	Image->Generation = Frame.Generation;
+	Image->Depth.SetNumUninitialized(Image->Width * Image->Height);
+	FMemory::Memzero(Image->Depth.GetData(), Image->Depth.Num() * sizeof(float));
+
+	//Intrinsics of the down scaled image
+	const float Fx = Camera.Fx / Downscale;
+	const float Fy = Camera.Fy / Downscale;
+	const float Cx = (float)Camera.Cx / Downscale;
+	const float Cy = (float)Camera.Cy / Downscale;
+	const float Scale = Settings.MetersToWorldScale;
+	const float InvScale = 1.0f / Scale;
+	float* Depth = Image->Depth.GetData();
+	int32 NumProjected = 0;
+	for (const FVector& Point : Frame.Points)
+	{
+		//Back from Unreal conventions to the depth camera
+		const FVector DepthPoint(Point.Y * InvScale, -Point.Z * InvScale, Point.X * InvScale);
+		const FVector ColorPoint(DepthToColor.TransformPosition(DepthPoint));
+		if (ColorPoint.Z <= KINDA_SMALL_NUMBER)
+		{
+			continue;
+		}
+		const float InvZ = 1.0f / ColorPoint.Z;
+		const int32 X = FMath::FloorToInt(Fx * ColorPoint.X * InvZ + Cx);
+		const int32 Y = FMath::FloorToInt(Fy * ColorPoint.Y * InvZ + Cy);
+		if (X < 0 || Y < 0 || X >= Image->Width || Y >= Image->Height)
+		{
+			continue;
+		}
+		//Keep the closest surface when several points land in the same pixel
+		const float PointDepth = ColorPoint.Z * Scale;
+		float& Pixel = Depth[Y * Image->Width + X];
+		if (Pixel == 0 || PointDepth < Pixel)
+		{
+			Pixel = PointDepth;
+		}
+		++NumProjected;
+	}
+	Image->NumProjectedPoints = NumProjected;
+
+	switch (Settings.HoleFilling)
+	{
+	case ETangoDepthHoleFilling::NEAREST:
+		FillNearest(*Image);
+		break;
+	case ETangoDepthHoleFilling::BILATERAL:
+		FillBilateral(*Image);
+		break;
+	default:
+		break;
+	}
+
+	FScopeLock Lock(&LatestLock);
+	LatestImage = Image;
+}
+
+void TangoDepthRasterizer::FillNearest(FTangoDepthImage& Image)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TangoDepthHoleFilling);
+	const int32 Width = Image.Width;
+	const int32 Height = Image.Height;
+	//Each pass grows the known pixels by one, so after N passes every hole takes the depth of a pixel
+	//at most N away. Among equally near neighbours the closer surface wins.
+	for (int32 Pass = 0; Pass < Settings.FillRadius; ++Pass)
+	{
+		Scratch = Image.Depth;
+		const float* Source = Scratch.GetData();
+		float* Target = Image.Depth.GetData();
+		int32 NumFilled = 0;
+		for (int32 Y = 0; Y < Height; ++Y)
+		{
+			for (int32 X = 0; X < Width; ++X)
+			{
+				if (Source[Y * Width + X] != 0)
+				{
+					continue;
+				}
+				float Best = 0;
+				for (int32 NY = FMath::Max(Y - 1, 0); NY <= FMath::Min(Y + 1, Height - 1); ++NY)
+				{
+					for (int32 NX = FMath::Max(X - 1, 0); NX <= FMath::Min(X + 1, Width - 1); ++NX)
+					{
+						const float Neighbour = Source[NY * Width + NX];
+						if (Neighbour != 0 && (Best == 0 || Neighbour < Best))
+						{
+							Best = Neighbour;
+						}
+					}
+				}
+				if (Best != 0)
+				{
+					Target[Y * Width + X] = Best;
+					++NumFilled;
+				}
+			}
+		}
+		if (NumFilled == 0)
+		{
+			break;
+		}
+	}
+}
+
+void TangoDepthRasterizer::FillBilateral(FTangoDepthImage& Image)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TangoDepthHoleFilling);
+	const int32 Width = Image.Width;
+	const int32 Height = Image.Height;
+	const int32 Radius = Settings.FillRadius;
+	const int32 Size = 2 * Radius + 1;
+	const float RangeFactor = -1.0f / (2 * Settings.BilateralDepthSigma * Settings.BilateralDepthSigma);
+	Scratch = Image.Depth;
+	const float* Source = Scratch.GetData();
+	float* Target = Image.Depth.GetData();
+	for (int32 Y = 0; Y < Height; ++Y)
+	{
+		for (int32 X = 0; X < Width; ++X)
+		{
+			if (Source[Y * Width + X] != 0)
+			{
+				continue;
+			}
+			const int32 MinX = FMath::Max(X - Radius, 0);
+			const int32 MaxX = FMath::Min(X + Radius, Width - 1);
+			const int32 MinY = FMath::Max(Y - Radius, 0);
+			const int32 MaxY = FMath::Min(Y + Radius, Height - 1);
+			//The range weights are relative to the closest neighbour so that holes on an edge
+			//take the foreground depth instead of a blend of both surfaces
+			float Closest = 0;
+			for (int32 NY = MinY; NY <= MaxY; ++NY)
+			{
+				for (int32 NX = MinX; NX <= MaxX; ++NX)
+				{
+					const float Neighbour = Source[NY * Width + NX];
+					if (Neighbour != 0 && (Closest == 0 || Neighbour < Closest))
+					{
+						Closest = Neighbour;
+					}
+				}
+			}
+			if (Closest == 0)
+			{
+				continue;
+			}
+			float WeightSum = 0;
+			float DepthSum = 0;
+			for (int32 NY = MinY; NY <= MaxY; ++NY)
+			{
+				const int32 WeightRow = (NY - Y + Radius) * Size + Radius - X;
+				for (int32 NX = MinX; NX <= MaxX; ++NX)
+				{
+					const float Neighbour = Source[NY * Width + NX];
+					if (Neighbour == 0)
+					{
+						continue;
+					}
+					const float Difference = Neighbour - Closest;
+					const float Weight = SpatialWeights[WeightRow + NX] * FMath::Exp(Difference * Difference * RangeFactor);
+					WeightSum += Weight;
+					DepthSum += Weight * Neighbour;
+				}
+			}
+			Target[Y * Width + X] = WeightSum > 0 ? DepthSum / WeightSum : Closest;
+		}
+	}
+}
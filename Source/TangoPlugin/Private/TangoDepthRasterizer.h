@@ -0,0 +1,68 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+
+#pragma once
+
+#include "TangoDepthImageComponent.h"
+#include "TangoPointCloudWorker.h"
+
+/**
+ * Rasterizes depth frames in depth camera space into a depth image of the color camera on its own thread.
+ * Images come from a small pool and are only reused once no consumer holds them any more.
+ */
+class TangoDepthRasterizer : public TangoPointCloudWorker
+{
+public:
+	struct FSettings
+	{
+		int32 Downscale;
+		ETangoDepthHoleFilling HoleFilling;
+		int32 FillRadius;
+		float BilateralDepthSigma;
+		float MetersToWorldScale;
+	};
+
+	TangoDepthRasterizer(const FSettings& InSettings);
+	virtual ~TangoDepthRasterizer();
+
+	/** Sets the color camera the frames are projected into. Game thread. */
+	void SetColorCamera(const FTangoCameraIntrinsics& InIntrinsics, double InColorTimestamp);
+	/** Sets the timestamp of the latest color image, frames are projected into the camera at that time. Game thread. */
+	void SetColorTimestamp(double InColorTimestamp);
+
+	FTangoDepthImagePtr GetLatestImage();
+
+protected:
+	virtual void ProcessFrame(const FTangoPointCloudFrame& Frame) override;
+
+private:
+	TSharedPtr<FTangoDepthImage, ESPMode::ThreadSafe> AcquireImage();
+	void FillNearest(FTangoDepthImage& Image);
+	void FillBilateral(FTangoDepthImage& Image);
+
+	FSettings Settings;
+
+	FCriticalSection CameraLock;
+	FTangoCameraIntrinsics Intrinsics;
+	double ColorTimestamp;
+
+	FCriticalSection LatestLock;
+	FTangoDepthImagePtr LatestImage;
+
+	//Only touched by the rasterizer thread
+	TArray<TSharedPtr<FTangoDepthImage, ESPMode::ThreadSafe>> ImagePool;
+	TArray<float> Scratch;
+	TArray<float> SpatialWeights;
+};
@@ -0,0 +1,257 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+
+#include "TangoPluginPrivatePCH.h"
+#include "TangoDepthRecorder.h"
+#include "TangoDepthRecordingFormat.h"
+#include "TangoFromToCObject.h"
+
+#if PLATFORM_ANDROID
+#include "tango_client_api.h"
+#endif
+
+DECLARE_CYCLE_STAT(TEXT("Depth Recording"), STAT_TangoDepthRecording, STATGROUP_Tango);
+
+namespace
+{
+	//Frames waiting for the writer beyond this are dropped
+	static const int32 MaxQueuedFrames = 8;
+}
+
+TangoDepthRecorder::TangoDepthRecorder()
+	: Thread(nullptr)
+	, QueueHead(0)
+	, QueueTail(0)
+	, MaxFramePoints(0)
+	, File(nullptr)
+	, BaseFrame(ETangoCoordinateFrameType::START_OF_SERVICE)
+	, DepthExtrinsicsTranslation(FVector::ZeroVector)
+	, DepthExtrinsicsOrientation(FQuat::Identity)
+{
+	FrameEvent = FPlatformProcess::GetSynchEventFromPool();
+}
+
+TangoDepthRecorder::~TangoDepthRecorder()
+{
+	Finish();
+	FPlatformProcess::ReturnSynchEventToPool(FrameEvent);
+	FrameEvent = nullptr;
+}
+
+bool TangoDepthRecorder::Start(const FString& Filename, ETangoCoordinateFrameType InBaseFrame, int32 MaxPoints)
+{
+	if (IsRecording())
+	{
+		UE_LOG(TangoPlugin, Warning, TEXT("TangoDepthRecorder::Start: Already recording"));
+		return false;
+	}
+	File = FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*Filename);
+	if (File == nullptr)
+	{
+		UE_LOG(TangoPlugin, Error, TEXT("TangoDepthRecorder::Start: Could not open %s for writing"), *Filename);
+		return false;
+	}
+	BaseFrame = InBaseFrame;
+	DepthExtrinsicsTranslation = FVector::ZeroVector;
+	DepthExtrinsicsOrientation = FQuat::Identity;
+#if PLATFORM_ANDROID
+	TangoPoseData Extrinsics;
+	if (TangoService_getPoseAtTime(0.0, ToCObject(FTangoCoordinateFramePair(ETangoCoordinateFrameType::DEVICE, ETangoCoordinateFrameType::CAMERA_DEPTH)), &Extrinsics) == TANGO_SUCCESS)
+	{
+		DepthExtrinsicsTranslation = FVector((float)Extrinsics.translation[0], (float)Extrinsics.translation[1], (float)Extrinsics.translation[2]);
+		DepthExtrinsicsOrientation = FQuat((float)Extrinsics.orientation[0], (float)Extrinsics.orientation[1], (float)Extrinsics.orientation[2], (float)Extrinsics.orientation[3]);
+	}
+	else
+	{
+		UE_LOG(TangoPlugin, Warning, TEXT("TangoDepthRecorder::Start: Could not query the depth camera extrinsics, recording device poses"));
+	}
+#endif
+
+	TangoDepthRecordingFormat::FFileHeader Header;
+	Header.Magic = TangoDepthRecordingFormat::FileMagic;
+	Header.Version = TangoDepthRecordingFormat::Version;
+	Header.BaseFrame = (uint8)BaseFrame;
+	Header.QuantizationStep = TangoDepthRecordingFormat::DefaultQuantizationStep;
+	HeaderBytes.Reset();
+	FMemoryWriter Writer(HeaderBytes);
+	Writer << Header;
+	File->Write(HeaderBytes.GetData(), HeaderBytes.Num());
+
+	IndexTimestamps.Reset();
+	IndexOffsets.Reset();
+	//Allocated here so the callback never allocates. Kept for the next recording.
+	QueuedFrames.SetNum(MaxQueuedFrames + 1);
+	for (FQueuedFrame& Frame : QueuedFrames)
+	{
+		Frame.Points.Reserve(MaxPoints);
+	}
+	MaxFramePoints = MaxPoints;
+	QueueHead = 0;
+	QueueTail = 0;
+	RecordedFrames.Reset();
+	DroppedFrames.Reset();
+	bRunning = true;
+	Thread = FRunnableThread::Create(this, TEXT("TangoDepthRecorder"));
+	UE_LOG(TangoPlugin, Log, TEXT("TangoDepthRecorder::Start: Recording depth to %s"), *Filename);
+	return true;
+}
+
+void TangoDepthRecorder::Finish()
+{
+	if (Thread == nullptr)
+	{
+		return;
+	}
+	Stop();
+	Thread->WaitForCompletion();
+	delete Thread;
+	Thread = nullptr;
+
+	WriteIndex();
+	delete File;
+	File = nullptr;
+	UE_LOG(TangoPlugin, Log, TEXT("TangoDepthRecorder::Finish: Recorded %d frames, dropped %d"), RecordedFrames.GetValue(), DroppedFrames.GetValue());
+}
+
+void TangoDepthRecorder::Stop()
+{
+	bRunning = false;
+	FrameEvent->Trigger();
+}
+
+void TangoDepthRecorder::AddFrame(const float(*Points)[4], int32 NumPoints, double Timestamp)
+{
+	if (!bRunning)
+	{
+		return;
+	}
+	const int32 Head = QueueHead;
+	const int32 NextHead = (Head + 1) % QueuedFrames.Num();
+	if (NextHead == QueueTail || NumPoints > MaxFramePoints)
+	{
+		DroppedFrames.Increment();
+		return;
+	}
+	FQueuedFrame& Frame = QueuedFrames[Head];
+	Frame.Timestamp = Timestamp;
+	Frame.Points.SetNumUninitialized(NumPoints, false);
+	if (NumPoints > 0)
+	{
+		FMemory::Memcpy(Frame.Points.GetData(), Points, NumPoints * sizeof(FVector4));
+	}
+	//The frame has to be complete before the writer can see it
+	FPlatformMisc::MemoryBarrier();
+	FPlatformAtomics::InterlockedExchange(&QueueHead, NextHead);
+	FrameEvent->Trigger();
+}
+
+uint32 TangoDepthRecorder::Run()
+{
+	for (;;)
+	{
+		//Read the flag before the queue, so nothing queued before Finish is lost
+		const bool bStillRunning = bRunning;
+		FPlatformMisc::MemoryBarrier();
+		while (QueueTail != QueueHead)
+		{
+			FPlatformMisc::MemoryBarrier();
+			WriteFrame(QueuedFrames[QueueTail]);
+			FPlatformAtomics::InterlockedExchange(&QueueTail, (QueueTail + 1) % QueuedFrames.Num());
+		}
+		if (!bStillRunning)
+		{
+			break;
+		}
+		FrameEvent->Wait(100);
+	}
+	return 0;
+}
+
+void TangoDepthRecorder::WriteFrame(const FQueuedFrame& Frame)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TangoDepthRecording);
+	TangoDepthRecordingFormat::FFrameHeader Header;
+	Header.Magic = TangoDepthRecordingFormat::FrameMagic;
+	Header.Timestamp = Frame.Timestamp;
+	Header.NumPoints = Frame.Points.Num();
+	Header.bPoseValid = 0;
+	FVector Translation = FVector::ZeroVector;
+	FQuat Orientation = FQuat::Identity;
+#if PLATFORM_ANDROID
+	TangoPoseData Pose;
+	if (TangoService_getPoseAtTime(Frame.Timestamp, ToCObject(FTangoCoordinateFramePair(BaseFrame, ETangoCoordinateFrameType::DEVICE)), &Pose) == TANGO_SUCCESS
+		&& Pose.status_code == TANGO_POSE_VALID)
+	{
+		//Base from depth = base from device * device from depth
+		const FQuat DeviceOrientation((float)Pose.orientation[0], (float)Pose.orientation[1], (float)Pose.orientation[2], (float)Pose.orientation[3]);
+		const FVector DeviceTranslation((float)Pose.translation[0], (float)Pose.translation[1], (float)Pose.translation[2]);
+		Translation = DeviceTranslation + DeviceOrientation.RotateVector(DepthExtrinsicsTranslation);
+		Orientation = DeviceOrientation * DepthExtrinsicsOrientation;
+		Header.bPoseValid = 1;
+	}
+#endif
+	Header.Translation[0] = Translation.X;
+	Header.Translation[1] = Translation.Y;
+	Header.Translation[2] = Translation.Z;
+	Header.Orientation[0] = Orientation.X;
+	Header.Orientation[1] = Orientation.Y;
+	Header.Orientation[2] = Orientation.Z;
+	Header.Orientation[3] = Orientation.W;
+
+	TangoDepthRecordingFormat::EncodePoints(Frame.Points.GetData(), Frame.Points.Num(), TangoDepthRecordingFormat::DefaultQuantizationStep, Payload);
+	int32 CompressedSize = FCompression::CompressMemoryBound(COMPRESS_ZLIB, Payload.Num());
+	CompressedPayload.SetNumUninitialized(CompressedSize);
+	if (!FCompression::CompressMemory((ECompressionFlags)(COMPRESS_ZLIB | COMPRESS_BiasSpeed), CompressedPayload.GetData(), CompressedSize, Payload.GetData(), Payload.Num()))
+	{
+		UE_LOG(TangoPlugin, Warning, TEXT("TangoDepthRecorder::WriteFrame: Could not compress frame %f"), Frame.Timestamp);
+		DroppedFrames.Increment();
+		return;
+	}
+	Header.UncompressedSize = Payload.Num();
+	Header.CompressedSize = CompressedSize;
+
+	HeaderBytes.Reset();
+	FMemoryWriter Writer(HeaderBytes);
+	Writer << Header;
+	const int64 Offset = File->Tell();
+	if (!File->Write(HeaderBytes.GetData(), HeaderBytes.Num()) || !File->Write(CompressedPayload.GetData(), CompressedSize))
+	{
+		UE_LOG(TangoPlugin, Error, TEXT("TangoDepthRecorder::WriteFrame: Write failed, is the storage full?"));
+		DroppedFrames.Increment();
+		return;
+	}
+	IndexTimestamps.Add(Frame.Timestamp);
+	IndexOffsets.Add(Offset);
+	RecordedFrames.Increment();
+}
+
+void TangoDepthRecorder::WriteIndex()
+{
+	TArray<uint8> IndexBytes;
+	FMemoryWriter Writer(IndexBytes);
+	for (int32 i = 0; i < IndexTimestamps.Num(); ++i)
+	{
+		TangoDepthRecordingFormat::FIndexEntry Entry;
+		Entry.Timestamp = IndexTimestamps[i];
+		Entry.Offset = IndexOffsets[i];
+		Writer << Entry;
+	}
+	TangoDepthRecordingFormat::FFooter Footer;
+	Footer.Magic = TangoDepthRecordingFormat::IndexMagic;
+	Footer.NumFrames = IndexTimestamps.Num();
+	Footer.IndexOffset = File->Tell();
+	Writer << Footer;
+	File->Write(IndexBytes.GetData(), IndexBytes.Num());
+}
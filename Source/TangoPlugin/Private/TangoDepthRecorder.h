@@ -0,0 +1,89 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+
+#pragma once
+
+#include "TangoDataTypes.h"
+
+class IFileHandle;
+
+/**
+ * Streams raw depth frames and the depth camera pose at their timestamp to a compact binary file.
+ * Frames are copied on the Tango callback thread into a ring of frames allocated by Start, without locking,
+ * and quantized, compressed and written on a writer thread.
+ * If the writer falls behind by more than a few frames, new frames are dropped rather than queued.
+ * See TangoDepthRecordingFormat.h for the file layout.
+ */
+class TangoDepthRecorder : public FRunnable
+{
+public:
+	TangoDepthRecorder();
+	virtual ~TangoDepthRecorder();
+
+	/** Creates Filename and starts the writer. Poses are recorded relative to BaseFrame, frames hold up to MaxPoints. Game thread. */
+	bool Start(const FString& Filename, ETangoCoordinateFrameType BaseFrame, int32 MaxPoints);
+	/** Writes the frames still queued, then the index, and closes the file. Game thread. */
+	void Finish();
+	bool IsRecording() const { return Thread != nullptr; }
+
+	/**
+	 * Queues a copy of the frame. Packed {X, Y, Z, C} values in meters, in the depth camera frame.
+	 * Only one thread may add frames, and only between Start and Finish.
+	 */
+	void AddFrame(const float(*Points)[4], int32 NumPoints, double Timestamp);
+
+	int32 GetRecordedFrameCount() const { return RecordedFrames.GetValue(); }
+	int32 GetDroppedFrameCount() const { return DroppedFrames.GetValue(); }
+
+	//FRunnable interface
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+	struct FQueuedFrame
+	{
+		double Timestamp;
+		TArray<FVector4> Points;
+	};
+
+	void WriteFrame(const FQueuedFrame& Frame);
+	void WriteIndex();
+
+	FRunnableThread* Thread;
+	FEvent* FrameEvent;
+	FThreadSafeBool bRunning;
+
+	//Single producer, single consumer ring. The callback fills QueuedFrames[QueueHead] and publishes it by advancing QueueHead,
+	//the writer frees a slot by advancing QueueTail once the frame is written. One slot always stays empty.
+	TArray<FQueuedFrame> QueuedFrames;
+	volatile int32 QueueHead;
+	volatile int32 QueueTail;
+	int32 MaxFramePoints;
+
+	FThreadSafeCounter RecordedFrames;
+	FThreadSafeCounter DroppedFrames;
+
+	//Only touched by the writer thread once it is running
+	IFileHandle* File;
+	ETangoCoordinateFrameType BaseFrame;
+	//Pose of the depth camera relative to the device, queried once when the recording starts
+	FVector DepthExtrinsicsTranslation;
+	FQuat DepthExtrinsicsOrientation;
+	TArray<uint8> Payload;
+	TArray<uint8> CompressedPayload;
+	TArray<uint8> HeaderBytes;
+	TArray<double> IndexTimestamps;
+	TArray<int64> IndexOffsets;
+};
@@ -0,0 +1,86 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+
+#include "TangoPluginPrivatePCH.h"
+#include "TangoDepthRecordingFormat.h"
+
+namespace
+{
+	FORCEINLINE uint16 ZigZag(int16 Value)
+	{
+		return (uint16)(((uint16)Value << 1) ^ (uint16)(Value >> 15));
+	}
+
+	FORCEINLINE int16 UnZigZag(uint16 Value)
+	{
+		return (int16)((Value >> 1) ^ (uint16)(-(int16)(Value & 1)));
+	}
+
+	//Bytes per point: two byte planes for each of the three axes and one for the confidence
+	static const int32 BytesPerPoint = 7;
+}
+
+void TangoDepthRecordingFormat::EncodePoints(const FVector4* Points, int32 Num, float QuantizationStep, TArray<uint8>& Out)
+{
+	Out.SetNumUninitialized(Num * BytesPerPoint);
+	const float InvStep = 1.0f / QuantizationStep;
+	uint8* Planes = Out.GetData();
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		uint8* Low = Planes + Axis * 2 * Num;
+		uint8* High = Low + Num;
+		int16 Previous = 0;
+		for (int32 i = 0; i < Num; ++i)
+		{
+			const int16 Quantized = (int16)FMath::Clamp(FMath::RoundToInt(Points[i][Axis] * InvStep), -32767, 32767);
+			//Wraps around on purpose, decoding wraps back the same way
+			const uint16 Delta = ZigZag((int16)(uint16)((uint16)Quantized - (uint16)Previous));
+			Previous = Quantized;
+			Low[i] = (uint8)(Delta & 0xFF);
+			High[i] = (uint8)(Delta >> 8);
+		}
+	}
+	uint8* Confidence = Planes + 6 * Num;
+	for (int32 i = 0; i < Num; ++i)
+	{
+		Confidence[i] = (uint8)FMath::Clamp(FMath::RoundToInt(Points[i].W * 255.0f), 0, 255);
+	}
+}
+
+bool TangoDepthRecordingFormat::DecodePoints(const uint8* Payload, int32 PayloadSize, int32 Num, float QuantizationStep, TArray<FVector4>& Out)
+{
+	if (Num < 0 || PayloadSize < Num * BytesPerPoint)
+	{
+		return false;
+	}
+	Out.SetNumUninitialized(Num);
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		const uint8* Low = Payload + Axis * 2 * Num;
+		const uint8* High = Low + Num;
+		int16 Previous = 0;
+		for (int32 i = 0; i < Num; ++i)
+		{
+			Previous = (int16)(uint16)((uint16)Previous + (uint16)UnZigZag((uint16)(Low[i] | (High[i] << 8))));
+			Out[i][Axis] = Previous * QuantizationStep;
+		}
+	}
+	const uint8* Confidence = Payload + 6 * Num;
+	for (int32 i = 0; i < Num; ++i)
+	{
+		Out[i].W = Confidence[i] / 255.0f;
+	}
+	return true;
+}
@@ -0,0 +1,109 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+
+#pragma once
+
+/**
+ * On-disk layout of depth recordings, shared by TangoDepthRecorder and TangoDepthRecordingReader.
+ *
+ * File header, then one record per frame, then an index of all frames and a fixed size footer.
+ * A recording that was not closed properly has no index, the reader then rebuilds it by walking the records.
+ * Points are stored in meters in the depth camera frame, quantized to QuantizationStep. Every coordinate axis is
+ * delta coded against the previous point, zigzag mapped to an unsigned 16 bit value and split into a low and a
+ * high byte plane, followed by one byte of confidence per point. The payload is then zlib compressed.
+ */
+namespace TangoDepthRecordingFormat
+{
+	static const uint32 FileMagic = 0x52445054; //"TPDR"
+	static const uint32 FrameMagic = 0x4D524654; //"TFRM"
+	static const uint32 IndexMagic = 0x58444954; //"TIDX"
+	static const uint32 Version = 1;
+
+	//Quantization step in meters, gives a range of +-16 meters around the camera
+	static const float DefaultQuantizationStep = 0.0005f;
+
+	struct FFileHeader
+	{
+		uint32 Magic;
+		uint32 Version;
+		//ETangoCoordinateFrameType the depth poses are relative to
+		uint8 BaseFrame;
+		float QuantizationStep;
+
+		friend FArchive& operator<<(FArchive& Ar, FFileHeader& Header)
+		{
+			return Ar << Header.Magic << Header.Version << Header.BaseFrame << Header.QuantizationStep;
+		}
+		static const int64 Size = 4 + 4 + 1 + 4;
+	};
+
+	struct FFrameHeader
+	{
+		uint32 Magic;
+		double Timestamp;
+		int32 NumPoints;
+		uint8 bPoseValid;
+		//Pose of the depth camera in the base frame, Tango conventions: translation in meters, orientation x, y, z, w
+		double Translation[3];
+		double Orientation[4];
+		int32 UncompressedSize;
+		int32 CompressedSize;
+
+		friend FArchive& operator<<(FArchive& Ar, FFrameHeader& Header)
+		{
+			Ar << Header.Magic << Header.Timestamp << Header.NumPoints << Header.bPoseValid;
+			for (double& Value : Header.Translation)
+			{
+				Ar << Value;
+			}
+			for (double& Value : Header.Orientation)
+			{
+				Ar << Value;
+			}
+			return Ar << Header.UncompressedSize << Header.CompressedSize;
+		}
+		static const int64 Size = 4 + 8 + 4 + 1 + 3 * 8 + 4 * 8 + 4 + 4;
+	};
+
+	struct FIndexEntry
+	{
+		double Timestamp;
+		int64 Offset;
+
+		friend FArchive& operator<<(FArchive& Ar, FIndexEntry& Entry)
+		{
+			return Ar << Entry.Timestamp << Entry.Offset;
+		}
+		static const int64 Size = 8 + 8;
+	};
+
+	struct FFooter
+	{
+		uint32 Magic;
+		int32 NumFrames;
+		int64 IndexOffset;
+
+		friend FArchive& operator<<(FArchive& Ar, FFooter& Footer)
+		{
+			return Ar << Footer.Magic << Footer.NumFrames << Footer.IndexOffset;
+		}
+		static const int64 Size = 4 + 4 + 8;
+	};
+
+	/** Quantizes and delta codes Num points, Out is resized to the uncompressed payload size. */
+	void EncodePoints(const FVector4* Points, int32 Num, float QuantizationStep, TArray<uint8>& Out);
+	/** Reverses EncodePoints. Returns false if Payload is too small for Num points. */
+	bool DecodePoints(const uint8* Payload, int32 PayloadSize, int32 Num, float QuantizationStep, TArray<FVector4>& Out);
+}
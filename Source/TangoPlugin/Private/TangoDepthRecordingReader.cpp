@@ -0,0 +1,248 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+
+#include "TangoPluginPrivatePCH.h"
+#include "TangoDepthRecordingReader.h"
+#include "TangoDepthRecordingFormat.h"
+#include "Serialization/BufferReader.h"
+
+#if PLATFORM_ANDROID || PLATFORM_LINUX
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define TANGO_DEPTH_RECORDING_MMAP 1
+#else
+#define TANGO_DEPTH_RECORDING_MMAP 0
+#endif
+
+TangoDepthRecordingReader::TangoDepthRecordingReader()
+	: Data(nullptr)
+	, Size(0)
+	, bMapped(false)
+	, BaseFrame(ETangoCoordinateFrameType::START_OF_SERVICE)
+	, QuantizationStep(TangoDepthRecordingFormat::DefaultQuantizationStep)
+{
+}
+
+TangoDepthRecordingReader::~TangoDepthRecordingReader()
+{
+	Close();
+}
+
+bool TangoDepthRecordingReader::Open(const FString& Filename)
+{
+	Close();
+#if TANGO_DEPTH_RECORDING_MMAP
+	const FString AbsolutePath = IFileManager::Get().ConvertToAbsolutePathForExternalAppForRead(*Filename);
+	const int Handle = open(TCHAR_TO_UTF8(*AbsolutePath), O_RDONLY);
+	if (Handle >= 0)
+	{
+		struct stat Stat;
+		if (fstat(Handle, &Stat) == 0 && Stat.st_size > 0)
+		{
+			void* Mapping = mmap(nullptr, Stat.st_size, PROT_READ, MAP_PRIVATE, Handle, 0);
+			if (Mapping != MAP_FAILED)
+			{
+				Data = (uint8*)Mapping;
+				Size = Stat.st_size;
+				bMapped = true;
+			}
+		}
+		//The mapping stays valid without the descriptor
+		close(Handle);
+	}
+#endif
+	if (Data == nullptr)
+	{
+		if (!FFileHelper::LoadFileToArray(LoadedData, *Filename))
+		{
+			UE_LOG(TangoPlugin, Error, TEXT("TangoDepthRecordingReader::Open: Could not read %s"), *Filename);
+			return false;
+		}
+		Data = LoadedData.GetData();
+		Size = LoadedData.Num();
+	}
+
+	TangoDepthRecordingFormat::FFileHeader Header;
+	if (Size < TangoDepthRecordingFormat::FFileHeader::Size)
+	{
+		Header.Magic = 0;
+	}
+	else
+	{
+		FBufferReader Reader(Data, Size, false);
+		Reader << Header;
+	}
+	if (Header.Magic != TangoDepthRecordingFormat::FileMagic || Header.Version != TangoDepthRecordingFormat::Version)
+	{
+		UE_LOG(TangoPlugin, Error, TEXT("TangoDepthRecordingReader::Open: %s is not a depth recording of a supported version"), *Filename);
+		Close();
+		return false;
+	}
+	BaseFrame = (ETangoCoordinateFrameType)Header.BaseFrame;
+	QuantizationStep = Header.QuantizationStep;
+
+	if (!ReadIndex())
+	{
+		UE_LOG(TangoPlugin, Warning, TEXT("TangoDepthRecordingReader::Open: %s was not closed properly, rebuilding its index"), *Filename);
+		RebuildIndex();
+	}
+	Index.Sort([](const FFrameLocation& A, const FFrameLocation& B) { return A.Timestamp < B.Timestamp; });
+	return true;
+}
+
+void TangoDepthRecordingReader::Close()
+{
+#if TANGO_DEPTH_RECORDING_MMAP
+	if (bMapped)
+	{
+		munmap(Data, Size);
+	}
+#endif
+	bMapped = false;
+	Data = nullptr;
+	Size = 0;
+	LoadedData.Empty();
+	Index.Empty();
+}
+
+bool TangoDepthRecordingReader::ReadIndex()
+{
+	const int64 FooterOffset = Size - TangoDepthRecordingFormat::FFooter::Size;
+	if (FooterOffset < TangoDepthRecordingFormat::FFileHeader::Size)
+	{
+		return false;
+	}
+	TangoDepthRecordingFormat::FFooter Footer;
+	FBufferReader FooterReader(Data + FooterOffset, TangoDepthRecordingFormat::FFooter::Size, false);
+	FooterReader << Footer;
+	if (Footer.Magic != TangoDepthRecordingFormat::IndexMagic || Footer.NumFrames < 0
+		|| Footer.IndexOffset + Footer.NumFrames * TangoDepthRecordingFormat::FIndexEntry::Size != FooterOffset)
+	{
+		return false;
+	}
+	FBufferReader Reader(Data + Footer.IndexOffset, FooterOffset - Footer.IndexOffset, false);
+	Index.SetNumUninitialized(Footer.NumFrames);
+	for (FFrameLocation& Location : Index)
+	{
+		TangoDepthRecordingFormat::FIndexEntry Entry;
+		Reader << Entry;
+		Location.Timestamp = Entry.Timestamp;
+		Location.Offset = Entry.Offset;
+	}
+	return true;
+}
+
+void TangoDepthRecordingReader::RebuildIndex()
+{
+	Index.Reset();
+	int64 Offset = TangoDepthRecordingFormat::FFileHeader::Size;
+	while (Offset + TangoDepthRecordingFormat::FFrameHeader::Size <= Size)
+	{
+		TangoDepthRecordingFormat::FFrameHeader Header;
+		FBufferReader Reader(Data + Offset, TangoDepthRecordingFormat::FFrameHeader::Size, false);
+		Reader << Header;
+		const int64 End = Offset + TangoDepthRecordingFormat::FFrameHeader::Size + Header.CompressedSize;
+		//A truncated last frame ends the recording
+		if (Header.Magic != TangoDepthRecordingFormat::FrameMagic || Header.CompressedSize < 0 || End > Size)
+		{
+			break;
+		}
+		FFrameLocation Location;
+		Location.Timestamp = Header.Timestamp;
+		Location.Offset = Offset;
+		Index.Add(Location);
+		Offset = End;
+	}
+}
+
+double TangoDepthRecordingReader::GetFrameTimestamp(int32 FrameIndex) const
+{
+	return Index.IsValidIndex(FrameIndex) ? Index[FrameIndex].Timestamp : 0.0;
+}
+
+int32 TangoDepthRecordingReader::FindFrame(double Timestamp) const
+{
+	if (Index.Num() == 0)
+	{
+		return INDEX_NONE;
+	}
+	//First frame at or after Timestamp
+	int32 Low = 0;
+	int32 High = Index.Num();
+	while (Low < High)
+	{
+		const int32 Middle = (Low + High) / 2;
+		if (Index[Middle].Timestamp < Timestamp)
+		{
+			Low = Middle + 1;
+		}
+		else
+		{
+			High = Middle;
+		}
+	}
+	if (Low == Index.Num())
+	{
+		return Low - 1;
+	}
+	if (Low > 0 && Timestamp - Index[Low - 1].Timestamp < Index[Low].Timestamp - Timestamp)
+	{
+		return Low - 1;
+	}
+	return Low;
+}
+
+bool TangoDepthRecordingReader::ReadFrame(int32 FrameIndex, FTangoDepthRecordingFrame& OutFrame) const
+{
+	if (!Index.IsValidIndex(FrameIndex))
+	{
+		return false;
+	}
+	const int64 Offset = Index[FrameIndex].Offset;
+	if (Offset < 0 || Offset + TangoDepthRecordingFormat::FFrameHeader::Size > Size)
+	{
+		return false;
+	}
+	TangoDepthRecordingFormat::FFrameHeader Header;
+	FBufferReader Reader(Data + Offset, TangoDepthRecordingFormat::FFrameHeader::Size, false);
+	Reader << Header;
+	const uint8* Compressed = Data + Offset + TangoDepthRecordingFormat::FFrameHeader::Size;
+	if (Header.Magic != TangoDepthRecordingFormat::FrameMagic || Header.CompressedSize < 0 || Header.UncompressedSize < 0
+		|| Compressed + Header.CompressedSize > Data + Size)
+	{
+		UE_LOG(TangoPlugin, Warning, TEXT("TangoDepthRecordingReader::ReadFrame: Frame %d is corrupt"), FrameIndex);
+		return false;
+	}
+
+	TArray<uint8> Payload;
+	Payload.SetNumUninitialized(Header.UncompressedSize);
+	if (Header.NumPoints == 0)
+	{
+		OutFrame.Points.Reset();
+	}
+	else if (!FCompression::UncompressMemory(COMPRESS_ZLIB, Payload.GetData(), Header.UncompressedSize, Compressed, Header.CompressedSize)
+		|| !TangoDepthRecordingFormat::DecodePoints(Payload.GetData(), Payload.Num(), Header.NumPoints, QuantizationStep, OutFrame.Points))
+	{
+		UE_LOG(TangoPlugin, Warning, TEXT("TangoDepthRecordingReader::ReadFrame: Could not decode frame %d"), FrameIndex);
+		return false;
+	}
+	OutFrame.Timestamp = Header.Timestamp;
+	OutFrame.bPoseValid = Header.bPoseValid != 0;
+	OutFrame.Translation = FVector((float)Header.Translation[0], (float)Header.Translation[1], (float)Header.Translation[2]);
+	OutFrame.Orientation = FQuat((float)Header.Orientation[0], (float)Header.Orientation[1], (float)Header.Orientation[2], (float)Header.Orientation[3]);
+	return true;
+}
@@ -810,4 +810,28 @@ void UTangoDevice::AddTangoMotionComponent(UTangoMotionComponent* Component, TAr
 		UE_LOG(TangoPlugin, Log, TEXT("UTangoDevice::AddTangoMotionComponent: Initiating Rebuild"));
 		GetTangoDeviceMotionPointer()->CheckForChangeInRequests();
 	}
-}
\ No newline at end of file
+}
+
+void UTangoDevice::RegisterTangoMotionComponent(UTangoMotionComponent* Component)
+{
+	if (!MotionComponents.Contains(Component))
+	{
+		TArray<FTangoCoordinateFramePair> NoRequests;
+		AddTangoMotionComponent(Component, NoRequests);
+	}
+}
+
+void UTangoDevice::UnregisterTangoMotionComponent(UTangoMotionComponent* Component)
+{
+	const int32 Index = MotionComponents.Find(Component);
+	if (Index == INDEX_NONE)
+	{
+		return;
+	}
+	MotionComponents.RemoveAt(Index);
+	RequestedPairs.RemoveAt(Index);
+	if (GetTangoDeviceMotionPointer() != nullptr)
+	{
+		GetTangoDeviceMotionPointer()->CheckForChangeInRequests();
+	}
+}
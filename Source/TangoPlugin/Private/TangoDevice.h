@@ -192,8 +192,18 @@ public:
 		TArray<UTangoMotionComponent*> MotionComponents;
 	UPROPERTY(transient)
 		TArray<UTangoPointCloudComponent*> PointCloudComponents;
+	//Number of consumers other than point cloud components per point stream, see TangoDevicePointCloud::AddStreamRequest
+	TArray<int32> PointStreamRequests;
+	//Number of consumers per converted camera image stream, see TangoImageConverter::AddStreamRequest
+	TArray<int32> CameraFrameStreamRequests;
+	//Called with pooled camera images on the camera thread, see UTangoImageComponent::AddCameraImageListener
+	TArray<FTangoCameraImageListener> CameraImageListeners;
+	FCriticalSection CameraImageListenersLock;
 	TArray<TArray<FTangoCoordinateFramePair>> RequestedPairs;
 	void AddTangoMotionComponent(UTangoMotionComponent* Component, TArray<FTangoCoordinateFramePair>& Requests);
+	//Adds a component without pose event requests so its transform follows its frame of reference, keeps the requests if it is known already
+	void RegisterTangoMotionComponent(UTangoMotionComponent* Component);
+	void UnregisterTangoMotionComponent(UTangoMotionComponent* Component);
 
 	// ARHelpers data
 
@@ -15,7 +15,12 @@ limitations under the License.*/
 #include "TangoPluginPrivatePCH.h"
 #include "TangoDeviceImage.h"
 #include "TangoDevice.h"
+#include "TangoFromToCObject.h"
 #include "Async/ParallelFor.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Camera Images Held"), STAT_TangoCameraImagesHeld, STATGROUP_Tango);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Camera Images Dropped"), STAT_TangoCameraImagesDropped, STATGROUP_Tango);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Camera Conversions Skipped"), STAT_TangoCameraConversionsSkipped, STATGROUP_Tango);
 #if PLATFORM_ANDROID
 #include "GLES/gl.h"
 #include <tango_client_api.h>
@@ -447,6 +452,8 @@ extern "C" void TangoUnity_renderArTexture(int /*i*/) {
 }
 
 FCriticalSection g_ArTextureLock;
+//Timestamp of the camera image last latched into the AR texture, by the game or the render thread. Guarded by g_ArTextureLock.
+double g_ArTextureTimestamp = 0.0;
 
 void(*g_glDrawBuffers)(int, GLenum*) = nullptr;
 
@@ -553,6 +560,8 @@ void UTangoDeviceImage::Init(
 	bNeedsAllocation = true;
 	LastTimestamp = 0;
 	RGBOpenGLPointer = 0;
+	ImageConverter = new TangoImageConverter();
+	ImagePool = new TangoCameraImagePool(UTangoDevice::Get().GetCurrentConfig().CameraImageBufferCount);
 #if PLATFORM_ANDROID
 	TangoBuffer.width = 0;
 	TangoBuffer.height = 0;
@@ -724,13 +733,72 @@ void UTangoDeviceImage::CheckConnectCallback()
 #if PLATFORM_ANDROID
 void UTangoDeviceImage::OnImageBuffer(const TangoImageBuffer* InBuffer)
 {
-	if (State != CONNECTED)
+	//Counted before State is read, so FinishDestroy waits for a callback that got past the check
+	CameraCallbacksInFlight.Increment();
+	if (State == CONNECTED && ImagePool != nullptr && ImageConverter != nullptr)
 	{
-		return;
+		CopyImageBuffer(InBuffer);
+	}
+	CameraCallbacksInFlight.Decrement();
+}
+
+void UTangoDeviceImage::CopyImageBuffer(const TangoImageBuffer* InBuffer)
+{
+	UTangoDevice& Device = UTangoDevice::Get();
+	//Listeners are called after the lock is released, so they may add or remove listeners
+	TArray<TPair<FOnTangoCameraImageAvailable, FTangoCameraImagePtr>, TInlineAllocator<4>> Calls;
+	{
+		FScopeLock Lock(&Device.CameraImageListenersLock);
+		//Copies of this image, shared by the listeners asking for the same region and decimation
+		struct FCopy
+		{
+			FIntRect Rect;
+			int32 Decimation;
+			FTangoCameraImagePtr Image;
+		};
+		TArray<FCopy, TInlineAllocator<4>> Copies;
+		if (ImageConverter->HasStreamRequests())
+		{
+			const FTangoCameraImagePtr Image = ImagePool->Write(InBuffer);
+			ImageConverter->AddImage(Image);
+			Copies.Add({ FIntRect(0, 0, InBuffer->width, InBuffer->height), 1, Image });
+		}
+		//Only what the listeners due for this image ask for is copied
+		const double Timestamp = InBuffer->timestamp;
+		for (FTangoCameraImageListener& Listener : Device.CameraImageListeners)
+		{
+			const double Period = Listener.Request.MaxRate > 0 ? 1.0 / Listener.Request.MaxRate : 0.0;
+			//An image a little early still counts, as the camera timestamps jitter. Timestamps restart when Tango reconnects.
+			const double Early = Listener.NextDueTimestamp - Timestamp;
+			if (!Listener.Delegate.IsBound() || (Early > 0.002 && Early <= Period))
+			{
+				continue;
+			}
+			FIntRect Rect;
+			int32 Decimation;
+			if (!TangoCameraImagePool::GetCopyRegion(InBuffer->width, InBuffer->height, Listener.Request, Rect, Decimation))
+			{
+				continue;
+			}
+			FCopy* Copy = Copies.FindByPredicate([&Rect, Decimation](const FCopy& Other) { return Other.Rect == Rect && Other.Decimation == Decimation; });
+			if (Copy == nullptr)
+			{
+				Copy = &Copies[Copies.Add({ Rect, Decimation, ImagePool->Write(InBuffer, Rect, Decimation) })];
+			}
+			//A dropped image is retried with the next one
+			if (!Copy->Image.IsValid())
+			{
+				continue;
+			}
+			//Keeps to the average rate, but does not catch up after a gap
+			const double Base = Early > Period ? Timestamp : Listener.NextDueTimestamp;
+			Listener.NextDueTimestamp = FMath::Max(Base + Period, Timestamp + Period * 0.5);
+			Calls.Emplace(Listener.Delegate, Copy->Image);
+		}
 	}
-	if (OnImageBufferAvailable.IsBound())
+	for (const TPair<FOnTangoCameraImageAvailable, FTangoCameraImagePtr>& Call : Calls)
 	{
-		OnImageBufferAvailable.Broadcast(InBuffer);
+		Call.Key.ExecuteIfBound(Call.Value);
 	}
 }
 
@@ -747,6 +815,16 @@ bool UTangoDeviceImage::IsNewDataAvail()
 
 void UTangoDeviceImage::TickByDevice()
 {
+	if (ImageConverter != nullptr)
+	{
+		ImageConverter->TickByDevice();
+		SET_DWORD_STAT(STAT_TangoCameraConversionsSkipped, ImageConverter->GetSkippedConversionCount());
+	}
+	if (ImagePool != nullptr)
+	{
+		SET_DWORD_STAT(STAT_TangoCameraImagesHeld, ImagePool->GetNumHeld());
+		SET_DWORD_STAT(STAT_TangoCameraImagesDropped, ImagePool->GetDroppedImageCount());
+	}
 #if PLATFORM_ANDROID
 	CheckConnectCallback();
 #endif
@@ -778,7 +856,7 @@ void UTangoDeviceImage::TickByCamera(TFunction<void(double)> fun)
 				{
 					TangoIntrinsics.distortion[i] = Intrin.Distortion[i];
 				}
-				TangoIntrinsics.calibration_type = (TangoCalibrationType)Intrin.CalibrationType	;
+				TangoIntrinsics.calibration_type = ToCObject(Intrin.CalibrationType);
 				TangoUnity_setRenderTextureDistortion(&TangoIntrinsics);
 				UE_LOG(TangoPlugin, Log, TEXT("Allocated RGB Texture"));
 			}
@@ -791,6 +869,7 @@ void UTangoDeviceImage::TickByCamera(TFunction<void(double)> fun)
 		}
 		else
 		{
+			g_ArTextureTimestamp = Stamp;
 			if (!bNeedsAllocation)
 			{
 				if (Stamp == LastTimestamp)
@@ -802,13 +881,15 @@ void UTangoDeviceImage::TickByCamera(TFunction<void(double)> fun)
 					DataSet(Stamp);
 					fun(Stamp);
 					ENQUEUE_UNIQUE_RENDER_COMMAND_FOURPARAMETER(UpdateRGBTex,
+						UTangoDeviceImage*, Image, this,
 						int32, Width, TangoBuffer.width,
 						int32, Height, TangoBuffer.height,
 						int32, Tex, RGBOpenGLPointer,
-						double, Timestamp, Stamp,
 						{
 							FScopeLock LambdaScopeLock(&g_ArTextureLock);
 							TangoUnity_updateEnvironmentMap(Tex, Width, Height);
+							//The render thread may have latched a newer image since the game thread did
+							Image->RenderThreadTimestamp = g_ArTextureTimestamp;
 							//UE_LOG(TangoPlugin, Log, TEXT("On Render thread: %f"), Timestamp);
 						});
 					//UE_LOG(TangoPlugin, Log, TEXT("On Game Thread: %f"), Stamp);
@@ -819,16 +900,56 @@ void UTangoDeviceImage::TickByCamera(TFunction<void(double)> fun)
 #endif
 }
 
+void UTangoDeviceImage::LatchNewestImage_RenderThread()
+{
+	check(IsInRenderingThread());
+#if PLATFORM_ANDROID
+	//The environment map is allocated and filled first by the game thread
+	if (RenderThreadTimestamp <= 0.0)
+	{
+		return;
+	}
+	FScopeLock ScopeLock(&g_ArTextureLock);
+	double Stamp = 0.0;
+	if (TangoService_updateTextureExternalOes(TANGO_CAMERA_COLOR, TangoUnity_getArTexture(), &Stamp) != TANGO_SUCCESS || Stamp == g_ArTextureTimestamp)
+	{
+		return;
+	}
+	g_ArTextureTimestamp = Stamp;
+	TangoUnity_updateEnvironmentMap(RGBOpenGLPointer, TangoBuffer.width, TangoBuffer.height);
+	RenderThreadTimestamp = Stamp;
+#endif
+}
+
+bool UTangoDeviceImage::IsReadyForFinishDestroy()
+{
+	return Super::IsReadyForFinishDestroy() && ReleaseFence.IsFenceComplete() && CameraCallbacksInFlight.GetValue() == 0;
+}
+
 void UTangoDeviceImage::BeginDestroy()
 {
 	Super::BeginDestroy();
+	ReleaseFence.BeginFence();
 	UE_LOG(TangoPlugin, Log, TEXT("UTangoDeviceImage::BeginDestroy: destructor called"));
 	DisconnectCallback();
+	//Also when the service did not let go of the callback, so no new callback touches the pool
+	State = DISCONNECTED;
+	FPlatformMisc::MemoryBarrier();
+}
+
+void UTangoDeviceImage::FinishDestroy()
+{
+	//IsReadyForFinishDestroy waited for the camera callbacks still copying into the pool
+	delete ImageConverter;
+	ImageConverter = nullptr;
+	delete ImagePool;
+	ImagePool = nullptr;
+	Super::FinishDestroy();
 }
 
-float UTangoDeviceImage::GetImageBufferTimestamp()
+double UTangoDeviceImage::GetImageBufferTimestamp()
 {
-	float ReturnValue = 0;
+	double ReturnValue = 0;
 #if PLATFORM_ANDROID
 	ReturnValue = LastTimestamp;
 #endif
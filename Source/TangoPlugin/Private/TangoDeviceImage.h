@@ -18,12 +18,21 @@ limitations under the License.*/
 #include "tango_client_api.h"
 #endif
 
+#include "TangoImageConverter.h"
+#include "TangoCameraImagePool.h"
+
 #include "TangoDeviceImage.generated.h"
 
+//One camera image listener, see UTangoImageComponent::AddCameraImageListener
+struct FTangoCameraImageListener
+{
+	FTangoCameraImageListener() : NextDueTimestamp(0) {}
 
-#if PLATFORM_ANDROID
-DECLARE_MULTICAST_DELEGATE_OneParam(FOnTangoImageBufferAvailable, const TangoImageBuffer*);
-#endif
+	FOnTangoCameraImageAvailable Delegate;
+	FTangoCameraImageRequest Request;
+	//Camera images older than this are skipped to keep to Request.MaxRate
+	double NextDueTimestamp;
+};
 
 UCLASS(NotBlueprintable, NotPlaceable, Transient)
 class UTangoDeviceImage : public UObject
@@ -31,6 +40,8 @@ class UTangoDeviceImage : public UObject
 	GENERATED_BODY()
 public:
 	virtual void BeginDestroy() override;
+	virtual bool IsReadyForFinishDestroy() override;
+	virtual void FinishDestroy() override;
 
 	void Init(
 #if PLATFORM_ANDROID
@@ -52,7 +63,7 @@ public:
 
 	//Tango Image functions
 	bool bIsImageBufferSet;
-	float GetImageBufferTimestamp();
+	double GetImageBufferTimestamp();
 
 	bool setRuntimeConfig(FTangoRuntimeConfig& RuntimeConfig);
 
@@ -81,10 +92,19 @@ public:
 	{
 		return LastTimestamp;
 	}
+	//Timestamp of the camera image the environment map holds on the render thread. Render thread only.
+	double GetRenderThreadTimestamp() const
+	{
+		check(IsInRenderingThread());
+		return RenderThreadTimestamp;
+	}
+	//Latches the newest camera image into the environment map, once the game thread has set it up. Render thread only.
+	void LatchNewestImage_RenderThread();
 	uint32 RGBOpenGLPointer; 
-#if PLATFORM_ANDROID
-	FOnTangoImageBufferAvailable OnImageBufferAvailable;
-#endif
+	//Holds the copies of the camera images shared with the camera image listeners and the converter
+	TangoCameraImagePool* GetImagePool() { return ImagePool; }
+	//Converts the camera images to packed pixels for the consumers that asked for it
+	TangoImageConverter* GetImageConverter() { return ImageConverter; }
 private:
 	
 	bool IsNewDataAvail();
@@ -92,10 +112,18 @@ private:
 	bool bNeedsAllocation;	
 	double LastTimestamp;
 	double GameThreadTimestamp;
+	double RenderThreadTimestamp = 0.0;
+	//Render commands and views in flight refer to this object, it is only freed once they are done
+	FRenderCommandFence ReleaseFence;
+	TangoImageConverter* ImageConverter = nullptr;
+	TangoCameraImagePool* ImagePool = nullptr;
+	//Camera callbacks inside OnImageBuffer, the pool and the converter are only deleted once there are none
+	FThreadSafeCounter CameraCallbacksInFlight;
 	
 #if PLATFORM_ANDROID
 	
 	TangoImageBuffer TangoBuffer;
 	void OnImageBuffer(const TangoImageBuffer* Buffer);
+	void CopyImageBuffer(const TangoImageBuffer* Buffer);
 #endif
 };
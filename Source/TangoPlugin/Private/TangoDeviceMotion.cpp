@@ -25,6 +25,15 @@ limitations under the License.*/
 #include "AndroidApplication.h"
 #endif
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pose Cache Hits"), STAT_TangoPoseCacheHits, STATGROUP_Tango);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pose Cache Misses"), STAT_TangoPoseCacheMisses, STATGROUP_Tango);
+DECLARE_CYCLE_STAT(TEXT("Batch Pose Query"), STAT_TangoBatchPoseQuery, STATGROUP_Tango);
+
+namespace
+{
+	static const int32 MaxCachedPoses = 16;
+}
+
 UTangoDeviceMotion::UTangoDeviceMotion() : UObject(), FTickableGameObject()
 {
 	UE_LOG(TangoPlugin, Log, TEXT("UTangoDeviceMotion::UTangoDeviceMotion: called"));
@@ -37,24 +46,36 @@ void UTangoDeviceMotion::ProperInitialize()
 #endif
 	CheckForChangeInRequests();
 	bIsProperlyInitialized = true;
-	LastTimestamp = 0;
-	Frame = 0;
-	LastFrame = 0;
+	PoseCache.Reset();
+	FMemory::Memzero(ConsumedSequences);
+	bHasConsumedAccumulatedPose = false;
 }
 
 void UTangoDeviceMotion::ConnectCallback()
 {
 	UE_LOG(TangoPlugin, Log, TEXT("UTangoDeviceMotion::ConnectCallback: called"));
 #if PLATFORM_ANDROID
-	TangoCoordinateFramePair Pairs[RequestedPairs.Num()];
-	int i = 0;
+	TArray<TangoCoordinateFramePair> Pairs;
 	for (auto& Elem : RequestedPairs)
 	{
-		Pairs[i].base = static_cast<TangoCoordinateFrameType>(static_cast<int32>(Elem.Key.BaseFrame));
-		Pairs[i].target = static_cast<TangoCoordinateFrameType>(static_cast<int32>(Elem.Key.TargetFrame));
-		i++;
+		Pairs.Add(ToCObject(Elem.Key));
+	}
+	//Always listen to the device poses, they answer the pose queries of the camera and the depth helpers
+	TArray<FTangoCoordinateFramePair> HistoryPairs;
+	HistoryPairs.Add(FTangoCoordinateFramePair(ETangoCoordinateFrameType::START_OF_SERVICE, ETangoCoordinateFrameType::DEVICE));
+	if (UTangoDevice::Get().IsUsingAdf())
+	{
+		HistoryPairs.Add(FTangoCoordinateFramePair(ETangoCoordinateFrameType::AREA_DESCRIPTION, ETangoCoordinateFrameType::DEVICE));
+		HistoryPairs.Add(FTangoCoordinateFramePair(ETangoCoordinateFrameType::AREA_DESCRIPTION, ETangoCoordinateFrameType::START_OF_SERVICE));
 	}
-	if (TangoService_connectOnPoseAvailable(RequestedPairs.Num(), Pairs, [](void*, const TangoPoseData* Pose) {if (UTangoDevice::Get().GetTangoDeviceMotionPointer() != nullptr)UTangoDevice::Get().GetTangoDeviceMotionPointer()->OnPoseAvailable(Pose); }) != TANGO_SUCCESS)
+	for (const FTangoCoordinateFramePair& Pair : HistoryPairs)
+	{
+		if (!RequestedPairs.Contains(Pair))
+		{
+			Pairs.Add(ToCObject(Pair));
+		}
+	}
+	if (TangoService_connectOnPoseAvailable(Pairs.Num(), Pairs.GetData(), [](void*, const TangoPoseData* Pose) {if (UTangoDevice::Get().GetTangoDeviceMotionPointer() != nullptr)UTangoDevice::Get().GetTangoDeviceMotionPointer()->OnPoseAvailable(Pose); }) != TANGO_SUCCESS)
 	{
 		UE_LOG(TangoPlugin, Error, TEXT("UTangoDeviceMotion::ConnectCallback: Was unsuccessfull"));
 	}
@@ -65,9 +86,15 @@ void UTangoDeviceMotion::ConnectCallback()
 void UTangoDeviceMotion::BeginDestroy()
 {
 	Super::BeginDestroy();
+	ReleaseFence.BeginFence();
 	UE_LOG(TangoPlugin, Log, TEXT("UTangoDeviceMotion::UTangoDeviceMotion: Destructor called"));
 }
 
+bool UTangoDeviceMotion::IsReadyForFinishDestroy()
+{
+	return Super::IsReadyForFinishDestroy() && ReleaseFence.IsFenceComplete();
+}
+
 
 /** Function called by the Tango Library with head pose data.
 */
@@ -75,33 +102,35 @@ void UTangoDeviceMotion::BeginDestroy()
 void UTangoDeviceMotion::OnPoseAvailable(const TangoPoseData* Pose)
 {
 	FTangoPoseData Data = FromCPointer(Pose);
+	//Invalid poses come back without a frame of reference
+	Data.FrameOfReference = FromCObject(Pose->frame);
+	if (Pose->frame.base != TANGO_COORDINATE_FRAME_PREVIOUS_DEVICE_POSE)
+	{
+		PoseHistory.AddPose(Data.FrameOfReference, Data, Pose->timestamp);
+		PosePredictor.AddPose(Data.FrameOfReference, Data, Pose->timestamp);
+	}
+	const int32 SlotIndex = TangoPoseTable::GetSlotIndex(Data.FrameOfReference);
 	if (Data.FrameOfReference.BaseFrame == ETangoCoordinateFrameType::PREVIOUS_DEVICE_POSE && Data.FrameOfReference.TargetFrame == ETangoCoordinateFrameType::DEVICE)
 	{
-		PoseMutex.Lock();
-		if (BroadcastTangoPoseData.Contains(Data.FrameOfReference))//We have to accumulate the previous device pose -> device pose frame!
+		//We have to accumulate the previous device pose -> device pose frame!
+		//The game thread takes the difference to what it consumed on its last tick.
+		if (const FTangoPoseData* OldData = PoseTable.GetPublished(SlotIndex))
 		{
-			FTangoPoseData OldData = BroadcastTangoPoseData[Data.FrameOfReference];
-			Data.Position = OldData.QuatRotation * Data.Position + OldData.Position;
-			Data.QuatRotation = OldData.QuatRotation * Data.QuatRotation;
+			Data.Position = OldData->QuatRotation * Data.Position + OldData->Position;
+			Data.QuatRotation = OldData->QuatRotation * Data.QuatRotation;
+			Data.QuatRotation.Normalize();
 			Data.Rotation = Data.QuatRotation.Rotator();
-			BroadcastTangoPoseData[Data.FrameOfReference] = Data;
-		}
-		else
-		{
-			BroadcastTangoPoseData.FindOrAdd(Data.FrameOfReference) = Data;
 		}
-		PoseMutex.Unlock();
 	}
 	else
 	{
-		PoseMutex.Lock();
-		BroadcastTangoPoseData.FindOrAdd(Data.FrameOfReference) = Data;
-		PoseMutex.Unlock();
+		PoseFilter.FilterPose(Data.FrameOfReference, Data, Pose->timestamp);
 	}
+	PoseTable.Publish(SlotIndex, Data);
 }
 #endif
 
-FWGS_84_PoseData UTangoDeviceMotion::GetWGS_84_PoseAtTime(const ETangoCoordinateFrameType TargetFrame, float Timestamp)
+FWGS_84_PoseData UTangoDeviceMotion::GetWGS_84_PoseAtTime(const ETangoCoordinateFrameType TargetFrame, double Timestamp)
 {
 	FWGS_84_PoseData Result;
 	//Prevent Tango calls before the system is ready, return null data instead
@@ -117,7 +146,7 @@ FWGS_84_PoseData UTangoDeviceMotion::GetWGS_84_PoseAtTime(const ETangoCoordinate
 	
 	////Remember to observe the Tango status in case the system isn't ready yet
 	TangoErrorType ResultOfServiceCall;
-	if (TangoService_getPoseAtTime(static_cast<double> (Timestamp), ToCObject(FrameOfReference), &ToConvert) != TANGO_SUCCESS)
+	if (TangoService_getPoseAtTime(Timestamp, ToCObject(FrameOfReference), &ToConvert) != TANGO_SUCCESS)
 	{
 		UE_LOG(TangoPlugin, Warning, TEXT("UTangoDeviceMotion::GetPoseAtTime: TangoService_getPoseAtTime not successful"));
 		//return a generic object
@@ -133,6 +162,7 @@ FWGS_84_PoseData UTangoDeviceMotion::GetWGS_84_PoseAtTime(const ETangoCoordinate
 	Result.Orientation[3] = ToConvert.orientation[3];
 	Result.FrameOfReference = FromCObject(ToConvert.frame);
 	Result.Timestamp = ToConvert.timestamp;
+	Result.PreciseTimestamp = ToConvert.timestamp;
 	Result.StatusCode = (ETangoPoseStatus)ToConvert.status_code;
 #endif
 	return Result;
@@ -140,68 +170,252 @@ FWGS_84_PoseData UTangoDeviceMotion::GetWGS_84_PoseAtTime(const ETangoCoordinate
 
 //START - Tango Motion functions
 
-FTangoPoseData UTangoDeviceMotion::GetPoseAtTime(FTangoCoordinateFramePair FrameOfReference, float Timestamp)
+FTangoPoseData UTangoDeviceMotion::GetPoseAtTime(FTangoCoordinateFramePair FrameOfReference, double Timestamp)
 {
-	if (Frame == LastFrame && LastTimestamp == Timestamp &&
-		LastFrameOfReference.BaseFrame == FrameOfReference.BaseFrame && 
-		LastFrameOfReference.TargetFrame == FrameOfReference.TargetFrame)
+	for (const FCachedPose& Cached : PoseCache)
 	{
-		return LastPose;
+		if (Cached.Timestamp == Timestamp &&
+			Cached.FrameOfReference.BaseFrame == FrameOfReference.BaseFrame &&
+			Cached.FrameOfReference.TargetFrame == FrameOfReference.TargetFrame)
+		{
+			INC_DWORD_STAT(STAT_TangoPoseCacheHits);
+			return Cached.Pose;
+		}
 	}
+	INC_DWORD_STAT(STAT_TangoPoseCacheMisses);
+	FTangoPoseData Pose;
     //Prevent Tango calls before the system is ready, return null data instead
-    if(!(UTangoDevice::Get().IsTangoServiceRunning()) || !TangoARHelpers::DataIsReady())
+    if((UTangoDevice::Get().IsTangoServiceRunning()) && TangoARHelpers::DataIsReady())
     {
-
-		LastFrame = Frame;
-		LastTimestamp = Timestamp;
-		LastFrameOfReference = FrameOfReference;
-        return LastPose = FTangoPoseData();
+		Pose = QueryPoseAtTime(FrameOfReference, Timestamp);
     }
-	
-    
+	//A handful of components query a handful of pairs, beyond that the oldest entry makes room
+	if (PoseCache.Num() >= MaxCachedPoses)
+	{
+		PoseCache.RemoveAt(0, 1, false);
+	}
+	FCachedPose Cached;
+	Cached.FrameOfReference = FrameOfReference;
+	Cached.Timestamp = Timestamp;
+	Cached.Pose = Pose;
+	PoseCache.Add(Cached);
+	return Pose;
+}
+
+FTangoPoseData UTangoDeviceMotion::QueryPoseAtTime(FTangoCoordinateFramePair FrameOfReference, double Timestamp)
+{
 	//@TODO: See if there's a way to remove the need for this data structure here
 	FTangoPoseData BlueprintFriendlyPoseData;
-	TangoSpaceConversions::TangoSpaceConversionPair SpaceConverter;
-	bool bIsValidQuery = TangoSpaceConversions::GetSpaceConversionPair(SpaceConverter, FrameOfReference);
+	const TangoSpaceConversions::TangoSpaceConversionPair* SpaceConverter = TangoSpaceConversions::FindSpaceConversionPair(FrameOfReference);
 
-	if (!bIsValidQuery)
+	if (SpaceConverter == nullptr)
 	{
-		UE_LOG(TangoPlugin, Warning, TEXT("UTangoDeviceMotion::GetPoseAtTime: Query not valid"));
+		UE_LOG(TangoPlugin, Warning, TEXT("UTangoDeviceMotion::QueryPoseAtTime: Query not valid"));
 		BlueprintFriendlyPoseData.StatusCode = ETangoPoseStatus::INVALID;
 		return BlueprintFriendlyPoseData;
 	}
 
-	if (SpaceConverter.bIsStatic)//Just querying extrinsics
+	if (SpaceConverter->bIsStatic)//Just querying extrinsics
 	{
-		TangoSpaceConversions::ModifyPose(BlueprintFriendlyPoseData, SpaceConverter);
+		TangoSpaceConversions::ModifyPose(BlueprintFriendlyPoseData, *SpaceConverter);
 		BlueprintFriendlyPoseData.Timestamp = Timestamp;
+		BlueprintFriendlyPoseData.PreciseTimestamp = Timestamp;
 		return BlueprintFriendlyPoseData;
 	}
-	else if (SpaceConverter.bNeedToBeQueriedFromDevice)
+	else if (SpaceConverter->bNeedToBeQueriedFromDevice)
 	{
 		FrameOfReference.TargetFrame = ETangoCoordinateFrameType::DEVICE;
 	}
 
+	if (PoseHistory.GetPoseAtTime(FrameOfReference, Timestamp, BlueprintFriendlyPoseData))
+	{
+		TangoSpaceConversions::ModifyPose(BlueprintFriendlyPoseData, *SpaceConverter);
+		return BlueprintFriendlyPoseData;
+	}
+
 #if PLATFORM_ANDROID
 	TangoPoseData Result;
 
 	////Remember to observe the Tango status in case the system isn't ready yet
-	TangoErrorType ResultOfServiceCall;
-	if (TangoService_getPoseAtTime(static_cast<double> (Timestamp), ToCObject(FrameOfReference), &Result) != TANGO_SUCCESS)
+	if (TangoService_getPoseAtTime(Timestamp, ToCObject(FrameOfReference), &Result) != TANGO_SUCCESS)
 	{
-		UE_LOG(TangoPlugin, Warning, TEXT("UTangoDeviceMotion::GetPoseAtTime: TangoService_getPoseAtTime not successful"));
+		UE_LOG(TangoPlugin, Warning, TEXT("UTangoDeviceMotion::QueryPoseAtTime: TangoService_getPoseAtTime not successful"));
 		//return a generic object
-		LastTimestamp = Timestamp;
-		LastFrameOfReference = FrameOfReference;
-		return LastPose = FTangoPoseData();
+		return FTangoPoseData();
 	}
 	BlueprintFriendlyPoseData = FromCPointer(&Result);
 #endif
-	LastFrame = Frame;
-	TangoSpaceConversions::ModifyPose(BlueprintFriendlyPoseData, SpaceConverter);
-	LastTimestamp = Timestamp;
-	LastFrameOfReference = FrameOfReference;
-	return LastPose = BlueprintFriendlyPoseData;
+	TangoSpaceConversions::ModifyPose(BlueprintFriendlyPoseData, *SpaceConverter);
+	return BlueprintFriendlyPoseData;
+}
+
+void UTangoDeviceMotion::GetPosesAtTimes(FTangoCoordinateFramePair FrameOfReference, const TArray<double>& Timestamps, TArray<FTangoPoseData>& OutPoses)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TangoBatchPoseQuery);
+	OutPoses.Reset(Timestamps.Num());
+	OutPoses.SetNum(Timestamps.Num());
+	//Prevent Tango calls before the system is ready, return null data instead
+	if (!(UTangoDevice::Get().IsTangoServiceRunning() && TangoARHelpers::DataIsReady()) || Timestamps.Num() == 0)
+	{
+		return;
+	}
+	const TangoSpaceConversions::TangoSpaceConversionPair* SpaceConverter = TangoSpaceConversions::FindSpaceConversionPair(FrameOfReference);
+	if (SpaceConverter == nullptr)
+	{
+		UE_LOG(TangoPlugin, Warning, TEXT("UTangoDeviceMotion::GetPosesAtTimes: Query not valid"));
+		for (FTangoPoseData& Pose : OutPoses)
+		{
+			Pose.StatusCode = ETangoPoseStatus::INVALID;
+		}
+		return;
+	}
+
+	if (SpaceConverter->bIsStatic)//Just querying extrinsics
+	{
+		FTangoPoseData StaticPose;
+		TangoSpaceConversions::ModifyPose(StaticPose, *SpaceConverter);
+		for (int32 i = 0; i < Timestamps.Num(); ++i)
+		{
+			OutPoses[i] = StaticPose;
+			OutPoses[i].Timestamp = Timestamps[i];
+			OutPoses[i].PreciseTimestamp = Timestamps[i];
+		}
+		return;
+	}
+	else if (SpaceConverter->bNeedToBeQueriedFromDevice)
+	{
+		FrameOfReference.TargetFrame = ETangoCoordinateFrameType::DEVICE;
+	}
+
+	PoseHistory.GetPosesAtTimes(FrameOfReference, Timestamps, OutPoses);
+	int32 NumFailed = 0;
+	for (int32 i = 0; i < Timestamps.Num(); ++i)
+	{
+		FTangoPoseData& Pose = OutPoses[i];
+		if (Pose.StatusCode != ETangoPoseStatus::VALID)
+		{
+			//Outside the buffered window, ask the service
+			Pose = FTangoPoseData();
+#if PLATFORM_ANDROID
+			TangoPoseData Result;
+			if (TangoService_getPoseAtTime(Timestamps[i], ToCObject(FrameOfReference), &Result) != TANGO_SUCCESS)
+			{
+				++NumFailed;
+				continue;
+			}
+			Pose = FromCPointer(&Result);
+#else
+			continue;
+#endif
+		}
+		TangoSpaceConversions::ModifyPose(Pose, *SpaceConverter);
+	}
+	if (NumFailed > 0)
+	{
+		UE_LOG(TangoPlugin, Warning, TEXT("UTangoDeviceMotion::GetPosesAtTimes: TangoService_getPoseAtTime not successful for %d of %d timestamps"), NumFailed, Timestamps.Num());
+	}
+}
+
+bool UTangoDeviceMotion::QueryBufferedPose(FTangoCoordinateFramePair FrameOfReference, double Timestamp, FTangoPoseData& OutPose, TFunctionRef<bool(const FTangoCoordinateFramePair&, FTangoPoseData&)> Query)
+{
+	const TangoSpaceConversions::TangoSpaceConversionPair* SpaceConverter = TangoSpaceConversions::FindSpaceConversionPair(FrameOfReference);
+	if (SpaceConverter == nullptr)
+	{
+		return false;
+	}
+	if (SpaceConverter->bIsStatic)
+	{
+		OutPose = FTangoPoseData();
+		OutPose.Timestamp = Timestamp;
+		OutPose.PreciseTimestamp = Timestamp;
+	}
+	else
+	{
+		if (SpaceConverter->bNeedToBeQueriedFromDevice)
+		{
+			FrameOfReference.TargetFrame = ETangoCoordinateFrameType::DEVICE;
+		}
+		if (!Query(FrameOfReference, OutPose))
+		{
+			return false;
+		}
+	}
+	TangoSpaceConversions::ModifyPose(OutPose, *SpaceConverter);
+	return true;
+}
+
+bool UTangoDeviceMotion::GetBufferedPoseAtTime(FTangoCoordinateFramePair FrameOfReference, double Timestamp, double MaxExtrapolation, FTangoPoseData& OutPose)
+{
+	return QueryBufferedPose(FrameOfReference, Timestamp, OutPose, [this, Timestamp, MaxExtrapolation](const FTangoCoordinateFramePair& Pair, FTangoPoseData& Pose)
+	{
+		return PoseHistory.GetPoseAtTime(Pair, Timestamp, Pose) || PosePredictor.PredictPoseAtTime(Pair, Timestamp, Pose, MaxExtrapolation);
+	});
+}
+
+bool UTangoDeviceMotion::PredictPoseAtTime(FTangoCoordinateFramePair FrameOfReference, double Timestamp, FTangoPoseData& OutPose)
+{
+	return QueryBufferedPose(FrameOfReference, Timestamp, OutPose, [this, Timestamp](const FTangoCoordinateFramePair& Pair, FTangoPoseData& Pose)
+	{
+		return PosePredictor.PredictPoseAtTime(Pair, Timestamp, Pose);
+	});
+}
+
+bool UTangoDeviceMotion::PredictPoseAhead(FTangoCoordinateFramePair FrameOfReference, double LookAhead, FTangoPoseData& OutPose)
+{
+	//Static pairs do not move, the timestamp only ends up in the result
+	return QueryBufferedPose(FrameOfReference, 0.0, OutPose, [this, LookAhead](const FTangoCoordinateFramePair& Pair, FTangoPoseData& Pose)
+	{
+		return PosePredictor.PredictPoseAhead(Pair, LookAhead, Pose);
+	});
+}
+
+bool UTangoDeviceMotion::SetPoseFilter(FTangoCoordinateFramePair FrameOfReference, const FTangoPoseFilterSettings& Settings)
+{
+	const TangoSpaceConversions::TangoSpaceConversionPair* SpaceConverter = TangoSpaceConversions::FindSpaceConversionPair(FrameOfReference);
+	if (SpaceConverter == nullptr || SpaceConverter->bIsStatic)
+	{
+		UE_LOG(TangoPlugin, Warning, TEXT("UTangoDeviceMotion::SetPoseFilter: Frame pair does not move, there is nothing to filter"));
+		return false;
+	}
+	if (FrameOfReference.BaseFrame == ETangoCoordinateFrameType::PREVIOUS_DEVICE_POSE)
+	{
+		UE_LOG(TangoPlugin, Warning, TEXT("UTangoDeviceMotion::SetPoseFilter: Motion relative to the previous device pose cannot be filtered"));
+		return false;
+	}
+	if (SpaceConverter->bNeedToBeQueriedFromDevice)
+	{
+		FrameOfReference.TargetFrame = ETangoCoordinateFrameType::DEVICE;
+	}
+	PoseFilter.SetSettings(FrameOfReference, Settings);
+	return true;
+}
+
+FTangoPoseFilterSettings UTangoDeviceMotion::GetPoseFilter(FTangoCoordinateFramePair FrameOfReference)
+{
+	const TangoSpaceConversions::TangoSpaceConversionPair* SpaceConverter = TangoSpaceConversions::FindSpaceConversionPair(FrameOfReference);
+	if (SpaceConverter == nullptr || SpaceConverter->bIsStatic)
+	{
+		return FTangoPoseFilterSettings();
+	}
+	if (SpaceConverter->bNeedToBeQueriedFromDevice)
+	{
+		FrameOfReference.TargetFrame = ETangoCoordinateFrameType::DEVICE;
+	}
+	return PoseFilter.GetSettings(FrameOfReference);
+}
+
+bool UTangoDeviceMotion::GetFilteredPose(FTangoCoordinateFramePair FrameOfReference, FTangoPoseData& OutPose)
+{
+	//The table accumulates the motion relative to the previous device pose, which means nothing outside of Tick
+	if (FrameOfReference.BaseFrame == ETangoCoordinateFrameType::PREVIOUS_DEVICE_POSE)
+	{
+		return false;
+	}
+	return QueryBufferedPose(FrameOfReference, 0.0, OutPose, [this](const FTangoCoordinateFramePair& Pair, FTangoPoseData& Pose)
+	{
+		int32 Sequence = 0;
+		return PoseTable.ReadIfNewer(TangoPoseTable::GetSlotIndex(Pair), Pose, Sequence);
+	});
 }
 
 bool UTangoDeviceMotion::IsTickable() const
@@ -215,21 +429,69 @@ TStatId UTangoDeviceMotion::GetStatId() const
 }
 
 
+bool UTangoDeviceMotion::HaveDrivenFramesChanged() const
+{
+	const TArray<UTangoMotionComponent*>& MotionComponents = UTangoDevice::Get().MotionComponents;
+	if (MotionComponents.Num() != DrivenFrames.Num())
+	{
+		return true;
+	}
+	for (int32 i = 0; i < MotionComponents.Num(); ++i)
+	{
+		if (MotionComponents[i] != nullptr && !(MotionComponents[i]->MotionComponentFrameOfReference == DrivenFrames[i]))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
 void UTangoDeviceMotion::Tick(float DeltaTime)
 {
-	Frame++;
-	PoseMutex.Lock();
-	TMap<FTangoCoordinateFramePair, FTangoPoseData> BroadcastTangoPoseDataCopy = BroadcastTangoPoseData;
-	BroadcastTangoPoseData.Empty(RequestedPairs.Num());
-	PoseMutex.Unlock();
-	
-	for (auto& Elem : BroadcastTangoPoseDataCopy)
+	PoseCache.Reset();
+	//The frame of reference of a component may be changed at any time
+	if ((bRequestsNeedConversions && UTangoDevice::Get().MotionComponents.Num() > 0) || HaveDrivenFramesChanged())
 	{
-		auto& BroadCastPairs = RequestedPairs[Elem.Key];
-		for (auto& BroadCastPair : BroadCastPairs)
+		CheckForChangeInRequests();
+	}
+	for (auto& Elem : RequestedPairs)
+	{
+		const int32 SlotIndex = TangoPoseTable::GetSlotIndex(Elem.Key);
+		FTangoPoseData LatestPose;
+		if (!PoseTable.ReadIfNewer(SlotIndex, LatestPose, ConsumedSequences[SlotIndex]))
 		{
-			FTangoPoseData Pose = Elem.Value;
+			continue;
+		}
+		if (Elem.Key.BaseFrame == ETangoCoordinateFrameType::PREVIOUS_DEVICE_POSE && Elem.Key.TargetFrame == ETangoCoordinateFrameType::DEVICE)
+		{
+			//Components get the motion since the last tick, the table holds the motion since the first callback
+			const FTangoPoseData Accumulated = LatestPose;
+			if (bHasConsumedAccumulatedPose)
+			{
+				const FQuat InverseRotation = ConsumedAccumulatedPose.QuatRotation.Inverse();
+				LatestPose.Position = InverseRotation * (Accumulated.Position - ConsumedAccumulatedPose.Position);
+				LatestPose.QuatRotation = InverseRotation * Accumulated.QuatRotation;
+				LatestPose.Rotation = LatestPose.QuatRotation.Rotator();
+			}
+			ConsumedAccumulatedPose = Accumulated;
+			bHasConsumedAccumulatedPose = true;
+		}
+		//Each requested pair is converted once, however many components use it
+		for (auto& BroadCastPair : Elem.Value)
+		{
+			FTangoPoseData Pose = LatestPose;
 			TangoSpaceConversions::ModifyPose(Pose, BroadCastPair.Value.RequestedSpace);
+			//Move the components first, so event handlers already see them at the new pose
+			if (Pose.StatusCode == ETangoPoseStatus::VALID)
+			{
+				for (int32 ComponentID : BroadCastPair.Value.DrivenComponentIDs)
+				{
+					if (UTangoDevice::Get().MotionComponents[ComponentID] != nullptr)
+					{
+						UTangoDevice::Get().MotionComponents[ComponentID]->SetRelativeLocationAndRotation(Pose.Position, Pose.QuatRotation);
+					}
+				}
+			}
 			for (int32 ComponentID : BroadCastPair.Value.ComponentIDs)
 			{
 				if (UTangoDevice::Get().MotionComponents[ComponentID] != nullptr)
@@ -247,6 +509,9 @@ void UTangoDeviceMotion::ResetMotionTracking()
 #if PLATFORM_ANDROID
 	TangoService_resetMotionTracking();
 #endif
+	PoseHistory.Clear();
+	PosePredictor.Clear();
+	PoseFilter.Clear();
 }
 
 bool UTangoDeviceMotion::IsLocalized(bool bAdf)
@@ -293,35 +558,54 @@ void UTangoDeviceMotion::CheckForChangeInRequests()
 {
 	UE_LOG(TangoPlugin, Log, TEXT("UTangoDeviceMotion::CheckForChangeInRequests: Called"));
 	TMap<FTangoCoordinateFramePair, TMap<FTangoCoordinateFramePair,MotionEventRequestedFramePair>> NewRequestedPairs;
+	auto AddRequest = [&NewRequestedPairs](const FTangoCoordinateFramePair& Requested, int32 ComponentID, bool bDrivesComponent)
+	{
+		const TangoSpaceConversions::TangoSpaceConversionPair* RequestPairSpace = TangoSpaceConversions::FindSpaceConversionPair(Requested); //We cannot request any pair so we have to look stuff up
+		if (RequestPairSpace == nullptr || RequestPairSpace->bIsStatic)//Ignore static ones
+		{
+			return;
+		}
+		FTangoCoordinateFramePair TrueRequestPair = Requested;
+		if (RequestPairSpace->bNeedToBeQueriedFromDevice)
+		{
+			TrueRequestPair = FTangoCoordinateFramePair(Requested.BaseFrame, ETangoCoordinateFrameType::DEVICE);
+		}
+		//Now add this to NewRequestedPairs in order to rebuild it.
+		auto& RequestMap = NewRequestedPairs.FindOrAdd(TrueRequestPair);
+		auto& Entry = RequestMap.FindOrAdd(RequestPairSpace->Pair);
+		Entry.RequestedSpace = *RequestPairSpace;
+		if (bDrivesComponent)
+		{
+			Entry.DrivenComponentIDs.AddUnique(ComponentID);
+		}
+		else
+		{
+			Entry.ComponentIDs.AddUnique(ComponentID);
+		}
+	};
+	const TArray<UTangoMotionComponent*>& MotionComponents = UTangoDevice::Get().MotionComponents;
+	DrivenFrames.SetNum(MotionComponents.Num());
 	for (int32 mc = 0; mc < UTangoDevice::Get().RequestedPairs.Num(); mc++)
 	{
 		for (int32 i = 0; i < UTangoDevice::Get().RequestedPairs[mc].Num(); ++i)
 		{
-			TangoSpaceConversions::TangoSpaceConversionPair RequestPairSpace; //We cannot request any pair so we have to look stuff up
-			if (TangoSpaceConversions::GetSpaceConversionPair(RequestPairSpace, UTangoDevice::Get().RequestedPairs[mc][i]))
-			{
-				FTangoCoordinateFramePair TrueRequestPair;
-				if (RequestPairSpace.bNeedToBeQueriedFromDevice)
-				{
-					TrueRequestPair = FTangoCoordinateFramePair(UTangoDevice::Get().RequestedPairs[mc][i].BaseFrame,ETangoCoordinateFrameType::DEVICE);
-				}
-				else if(RequestPairSpace.bIsStatic)//Ignore static ones
-				{
-					continue;
-				}
-				else
-				{
-					TrueRequestPair = UTangoDevice::Get().RequestedPairs[mc][i];
-				}
-				//Now add this to NewRequestedPairs in order to rebuild it.
-				auto& RequestMap = NewRequestedPairs.FindOrAdd(TrueRequestPair);
-				auto& Entry = RequestMap.FindOrAdd(RequestPairSpace.Pair);
-				Entry.RequestedSpace = RequestPairSpace;
-				Entry.ComponentIDs.AddUnique(mc);
-			}
+			AddRequest(UTangoDevice::Get().RequestedPairs[mc][i], mc, false);
 		}
+		//Every component follows its own frame of reference, components sharing one are moved from a single pose
+		if (mc < MotionComponents.Num() && MotionComponents[mc] != nullptr)
+		{
+			DrivenFrames[mc] = MotionComponents[mc]->MotionComponentFrameOfReference;
+			AddRequest(DrivenFrames[mc], mc, true);
+		}
+	}
+	bRequestsNeedConversions = !TangoSpaceConversions::AreConversionsPrepared();
+	if (!bCallbackIsConnected)
+	{
+		//The pose history pairs are listened to even without any requests
+		RequestedPairs = NewRequestedPairs;
+		ConnectCallback();
 	}
-	if (NewRequestedPairs.Num() == RequestedPairs.Num())
+	else if (NewRequestedPairs.Num() == RequestedPairs.Num())
 	{
 		for (auto& Elem : NewRequestedPairs)
 		{
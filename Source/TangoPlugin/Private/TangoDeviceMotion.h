@@ -16,6 +16,10 @@ limitations under the License.*/
 
 #include "TangoMotionComponent.h"
 #include "TangoCoordinateConversions.h"
+#include "TangoPoseHistory.h"
+#include "TangoPoseFilter.h"
+#include "TangoPosePredictor.h"
+#include "TangoPoseTable.h"
 
 #if PLATFORM_ANDROID
 #include "tango_client_api.h"
@@ -35,6 +39,7 @@ public:
 	void ProperInitialize();
 	void ConnectCallback();
 	virtual void BeginDestroy() override;
+	virtual bool IsReadyForFinishDestroy() override;
 
 	//FTickableGameObject interface
 	virtual bool IsTickable() const override;
@@ -42,8 +47,27 @@ public:
 	virtual TStatId GetStatId() const override;
 
 	//Tango Motion functions
-	FTangoPoseData GetPoseAtTime(FTangoCoordinateFramePair FrameOfReference, float Timestamp);
-	FWGS_84_PoseData GetWGS_84_PoseAtTime(const ETangoCoordinateFrameType TargetFrame, float Timestamp);
+	FTangoPoseData GetPoseAtTime(FTangoCoordinateFramePair FrameOfReference, double Timestamp);
+	//Bypasses the per-frame cache, so it may be called from worker threads once the space conversions are prepared.
+	FTangoPoseData QueryPoseAtTime(FTangoCoordinateFramePair FrameOfReference, double Timestamp);
+	//GetPoseAtTime for many timestamps, with one conversion lookup and a single pass over the buffered poses.
+	//OutPoses matches Timestamps. Bypasses the per-frame cache.
+	void GetPosesAtTimes(FTangoCoordinateFramePair FrameOfReference, const TArray<double>& Timestamps, TArray<FTangoPoseData>& OutPoses);
+	//Only answers from the poses buffered from the callback and never calls the service, so it is cheap enough for the render thread.
+	//Predicts up to MaxExtrapolation seconds past the newest callback.
+	bool GetBufferedPoseAtTime(FTangoCoordinateFramePair FrameOfReference, double Timestamp, double MaxExtrapolation, FTangoPoseData& OutPose);
+	//Predicts the pose at a timestamp past the newest callback, or LookAhead seconds past it. Any thread.
+	bool PredictPoseAtTime(FTangoCoordinateFramePair FrameOfReference, double Timestamp, FTangoPoseData& OutPose);
+	bool PredictPoseAhead(FTangoCoordinateFramePair FrameOfReference, double LookAhead, FTangoPoseData& OutPose);
+	void SetPredictionSettings(const FTangoPosePredictionSettings& Settings) { PosePredictor.SetSettings(Settings); }
+	FTangoPosePredictionSettings GetPredictionSettings() const { return PosePredictor.GetSettings(); }
+	//Smooths the poses FrameOfReference is derived from before they reach components, pose events and GetFilteredPose.
+	//Pairs derived from the same device pose share its filter. Game thread only.
+	bool SetPoseFilter(FTangoCoordinateFramePair FrameOfReference, const FTangoPoseFilterSettings& Settings);
+	FTangoPoseFilterSettings GetPoseFilter(FTangoCoordinateFramePair FrameOfReference);
+	//The newest pose delivered by the callback, after the filter of its pair. Any thread.
+	bool GetFilteredPose(FTangoCoordinateFramePair FrameOfReference, FTangoPoseData& OutPose);
+	FWGS_84_PoseData GetWGS_84_PoseAtTime(const ETangoCoordinateFrameType TargetFrame, double Timestamp);
 	
 	void ResetMotionTracking();
 
@@ -53,17 +77,36 @@ public:
 
 private:
 	bool bIsProperlyInitialized = false;
-	FTangoCoordinateFramePair LastFrameOfReference;
-	FTangoPoseData LastPose;
-	float LastTimestamp;
-	int64 Frame;
-	int64 LastFrame;
+	//The AR camera late update reads the buffered poses on the render thread, this is only freed once it is done
+	FRenderCommandFence ReleaseFence;
+	//Poses queried on the game thread during the current frame, cleared on tick
+	struct FCachedPose
+	{
+		FTangoCoordinateFramePair FrameOfReference;
+		double Timestamp;
+		FTangoPoseData Pose;
+	};
+	TArray<FCachedPose> PoseCache;
 
 #if PLATFORM_ANDROID
 	void OnPoseAvailable(const TangoPoseData * Pose);
 #endif
 
-	FCriticalSection PoseMutex;
+	//Latest pose per frame pair, written by the pose callback without locking
+	TangoPoseTable PoseTable;
+	//Sequence of the last pose handed to the components, per slot of PoseTable. Game thread only.
+	int32 ConsumedSequences[TangoPoseTable::NumSlots];
+	FTangoPoseData ConsumedAccumulatedPose;
+	bool bHasConsumedAccumulatedPose = false;
+	//Filled from the pose callback, answers most queries without a service round trip
+	TangoPoseHistory PoseHistory;
+	//Velocity estimates from the pose callback, answers queries past the newest pose
+	TangoPosePredictor PosePredictor;
+	//Smooths the poses published to PoseTable, the history and the predictor keep the raw poses
+	TangoPoseFilter PoseFilter;
+
+	//Runs Query on the pair buffered from the callback that FrameOfReference is derived from and converts its answer
+	bool QueryBufferedPose(FTangoCoordinateFramePair FrameOfReference, double Timestamp, FTangoPoseData& OutPose, TFunctionRef<bool(const FTangoCoordinateFramePair&, FTangoPoseData&)> Query);
 
 
 	bool bCallbackIsConnected = false;
@@ -71,10 +114,16 @@ private:
 	struct MotionEventRequestedFramePair
 	{
 		TangoSpaceConversions::TangoSpaceConversionPair RequestedSpace;
+		//Components that get the pose event of this pair
 		TArray<int32> ComponentIDs;
+		//Components whose transform follows this pair
+		TArray<int32> DrivenComponentIDs;
 	};
 
 	TMap<FTangoCoordinateFramePair, TMap<FTangoCoordinateFramePair,MotionEventRequestedFramePair>> RequestedPairs;
-	//Stuff used in the Tangothread:
-	TMap<FTangoCoordinateFramePair, FTangoPoseData> BroadcastTangoPoseData;
+	//MotionComponentFrameOfReference of every motion component when RequestedPairs was built, to notice changes
+	TArray<FTangoCoordinateFramePair> DrivenFrames;
+	//Requests can only be resolved once the conversions are prepared, until then they are rebuilt every tick
+	bool bRequestsNeedConversions = false;
+	bool HaveDrivenFramesChanged() const;
 };
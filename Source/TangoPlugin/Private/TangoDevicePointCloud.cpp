@@ -17,6 +17,8 @@ limitations under the License.*/
 #include "TangoPointCloudComponent.h"
 
 #include "TangoDevice.h"
+#include "TangoDeviceMotion.h"
+#include "TangoPointCloudKernels.h"
 
 #include <UnrealTemplate.h>
 
@@ -25,6 +27,24 @@ limitations under the License.*/
 #include "AndroidApplication.h"
 #endif
 
+DECLARE_CYCLE_STAT(TEXT("Point Cloud Conversion"), STAT_TangoPointCloudConversion, STATGROUP_Tango);
+DECLARE_CYCLE_STAT(TEXT("Point Cloud Filter"), STAT_TangoPointCloudFilter, STATGROUP_Tango);
+DECLARE_CYCLE_STAT(TEXT("Point Cloud Index"), STAT_TangoPointCloudIndex, STATGROUP_Tango);
+DECLARE_CYCLE_STAT(TEXT("Fit Planes"), STAT_TangoFitPlanes, STATGROUP_Tango);
+
+class PointCloudProcessor : public FRunnable
+{
+	TangoDevicePointCloud* Target;
+public:
+	PointCloudProcessor(TangoDevicePointCloud* InTarget) : Target(InTarget) {}
+
+	uint32 Run() override
+	{
+		Target->RunProcessor();
+		return 0;
+	}
+};
+
 int32 TangoDevicePointCloud::GetMaxVertexCapacity()
 {
 	return VertCapacity;
@@ -33,22 +53,56 @@ int32 TangoDevicePointCloud::GetMaxVertexCapacity()
 
 void TangoDevicePointCloud::TickByDevice()
 {
-#if PLATFORM_ANDROID
-
-	for (int i = 0; i < UTangoDevice::Get().PointCloudComponents.Num(); ++i)
+	TArray<UTangoPointCloudComponent*>& Components = UTangoDevice::Get().PointCloudComponents;
+	int32 Streams = 0;
+	for (int i = 0; i < Components.Num(); ++i)
 	{
-		if (UTangoDevice::Get().PointCloudComponents[i] != nullptr)
+		if (Components[i] != nullptr)
 		{
-
+			Streams |= 1 << GetStreamIndex(Components[i]->PointSpace.GetValue(), Components[i]->bUseFilteredPoints);
 		}
 		else
 		{
-			UTangoDevice::Get().PointCloudComponents.RemoveAt(i);
+			Components.RemoveAt(i);
 			i--;
 		}
 	}
+	const TArray<int32>& StreamRequests = UTangoDevice::Get().PointStreamRequests;
+	for (int32 Stream = 0; Stream < StreamRequests.Num(); ++Stream)
+	{
+		if (StreamRequests[Stream] > 0)
+		{
+			Streams |= 1 << Stream;
+		}
+	}
+	FPlatformAtomics::InterlockedExchange(&RequestedStreams, Streams);
 
-#endif
+	//Components may be removed by the event handlers, so work on a copy
+	TArray<UTangoPointCloudComponent*> ComponentsCopy = Components;
+	for (int32 Stream = 0; Stream < NumPointStreams; ++Stream)
+	{
+		if ((Streams & (1 << Stream)) == 0)
+		{
+			continue;
+		}
+		FTangoPointCloudFramePtr Frame;
+		{
+			FScopeLock Lock(&LatestFramesLock);
+			Frame = LatestFrames[Stream];
+		}
+		if (!Frame.IsValid() || Frame->Generation == TickedGenerations[Stream])
+		{
+			continue;
+		}
+		TickedGenerations[Stream] = Frame->Generation;
+		for (UTangoPointCloudComponent* Component : ComponentsCopy)
+		{
+			if (Component != nullptr && GetStreamIndex(Component->PointSpace.GetValue(), Component->bUseFilteredPoints) == Stream)
+			{
+				Component->SetLatestFrame(Frame);
+			}
+		}
+	}
 }
 
 TangoDevicePointCloud::TangoDevicePointCloud(
@@ -59,14 +113,20 @@ TangoDevicePointCloud::TangoDevicePointCloud(
 {
 	UE_LOG(TangoPlugin, Log, TEXT("TangoDevicePointCloud::TangoDevicePointCloud: Creating TangoDevicePointCloud!"));
 	//Setting up Point Cloud Buffers
-	
+	PointCloudRing = nullptr;
+	DepthRecorder = nullptr;
+	ActiveRecorder = nullptr;
+	VertCapacity = 0;
+	ProcessorThread = nullptr;
+	NewFrameEvent = nullptr;
+	RequestedStreams = 0;
+	bBuildIndex = false;
+	FMemory::Memzero(TickedGenerations);
 #if PLATFORM_ANDROID
 
 	
 	int MaxPointCloudElements = 0;
 	bool bSuccess = TangoConfig_getInt32(Config_, "max_point_cloud_elements", &MaxPointCloudElements) == TANGO_SUCCESS;
-	uint32_t MaxPointCloudVertexCount = static_cast<uint32_t>(MaxPointCloudElements);
-	point_cloud_manager_ = nullptr;
 	if (bSuccess)
 	{
 		// Initialize TangoSupport context.
@@ -76,18 +136,16 @@ TangoDevicePointCloud::TangoDevicePointCloud(
 			isTangoSupportInit = true;
 			TangoSupport_initializeLibrary();
 		}
-		{
-			int32 ret = TangoSupport_createPointCloudManager(MaxPointCloudElements,
-				&point_cloud_manager_);
-			if (ret != TANGO_SUCCESS)
-			{
-				UE_LOG(TangoPlugin, Error, TEXT("createPointCloudManager failed with error code: %d"), ret);
-			}
-			else
-			{
-				UE_LOG(TangoPlugin, Log, TEXT("createPointCloudManager %p"), point_cloud_manager_);
-			}
-		}
+		VertCapacity = static_cast<uint32_t>(MaxPointCloudElements);
+		const int32 BufferCount = UTangoDevice::Get().GetCurrentConfig().PointCloudBufferCount;
+		PointCloudRing = new TangoPointCloudRing(BufferCount, MaxPointCloudElements);
+		UE_LOG(TangoPlugin, Log, TEXT("TangoDevicePointCloud::TangoDevicePointCloud: Allocated %d point cloud buffers of %d points, using the %s point kernel"), PointCloudRing->GetNumSlots(), MaxPointCloudElements, TangoPointCloudKernels::GetPathName());
+		const FTangoConfig& PluginConfig = UTangoDevice::Get().GetCurrentConfig();
+		bBuildIndex = PluginConfig.bBuildPointCloudIndex;
+		PointCloudFilter.SetSettings(PluginConfig.PointCloudMinConfidence, PluginConfig.PointCloudVoxelSize / PluginConfig.MetersToWorldScale);
+		NewFrameEvent = FPlatformProcess::GetSynchEventFromPool();
+		bProcessing = true;
+		ProcessorThread = FRunnableThread::Create(new PointCloudProcessor(this), TEXT("TangoPointCloudProcessor"));
 	}
 	else
 	{
@@ -113,55 +171,308 @@ void TangoDevicePointCloud::ConnectCallback()
 }
 
 TangoDevicePointCloud::~TangoDevicePointCloud()
+{
+	StopDepthRecording();
+	delete DepthRecorder;
+	DepthRecorder = nullptr;
+	bProcessing = false;
+	if (ProcessorThread != nullptr)
+	{
+		NewFrameEvent->Trigger();
+		ProcessorThread->WaitForCompletion();
+		delete ProcessorThread;
+		ProcessorThread = nullptr;
+	}
+	if (NewFrameEvent != nullptr)
+	{
+		FPlatformProcess::ReturnSynchEventToPool(NewFrameEvent);
+		NewFrameEvent = nullptr;
+	}
+	delete PointCloudRing;
+	PointCloudRing = nullptr;
+}
+
+bool TangoDevicePointCloud::StartDepthRecording(const FString& Filename, ETangoCoordinateFrameType BaseFrame)
 {
 #if PLATFORM_ANDROID
-	FScopeLock ScopeLock(GetPointCloudLock());
-	if (point_cloud_manager_ != nullptr)
+	if (DepthRecorder == nullptr)
 	{
-		TangoSupport_freePointCloudManager(point_cloud_manager_);
+		DepthRecorder = new TangoDepthRecorder();
 	}
+	if (!DepthRecorder->Start(Filename, BaseFrame, VertCapacity))
+	{
+		return false;
+	}
+	FPlatformAtomics::InterlockedExchangePtr((void**)&ActiveRecorder, DepthRecorder);
+	return true;
+#else
+	UE_LOG(TangoPlugin, Warning, TEXT("TangoDevicePointCloud::StartDepthRecording: Depth recording is only available on Tango devices"));
+	return false;
 #endif
 }
 
+void TangoDevicePointCloud::StopDepthRecording()
+{
+	if (DepthRecorder == nullptr || !DepthRecorder->IsRecording())
+	{
+		return;
+	}
+	FPlatformAtomics::InterlockedExchangePtr((void**)&ActiveRecorder, nullptr);
+	//A callback that read the pointer before it was cleared may still be adding a frame
+	while (RecorderCallbacksInFlight.GetValue() != 0)
+	{
+		FPlatformProcess::Sleep(0.0f);
+	}
+	DepthRecorder->Finish();
+}
 
-#if PLATFORM_ANDROID
+bool TangoDevicePointCloud::IsDepthRecording()
+{
+	return DepthRecorder != nullptr && DepthRecorder->IsRecording();
+}
+
+TangoPointCloudRing::FPin TangoDevicePointCloud::PinLatestPointCloud()
+{
+	return PointCloudRing != nullptr ? PointCloudRing->PinLatest() : TangoPointCloudRing::FPin();
+}
+
+TangoPointCloudRing::FPin TangoDevicePointCloud::PinPointCloudNearest(double Timestamp)
+{
+	return PointCloudRing != nullptr ? PointCloudRing->PinNearest(Timestamp) : TangoPointCloudRing::FPin();
+}
+
+int32 TangoDevicePointCloud::GetDroppedFrameCount()
+{
+	return PointCloudRing != nullptr ? PointCloudRing->GetDroppedFrameCount() : 0;
+}
+
+void TangoDevicePointCloud::AddStreamRequest(ETangoPointSpace::Type Space, bool bFiltered)
+{
+	TArray<int32>& StreamRequests = UTangoDevice::Get().PointStreamRequests;
+	StreamRequests.SetNumZeroed(NumPointStreams);
+	StreamRequests[GetStreamIndex(Space, bFiltered)]++;
+}
+
+void TangoDevicePointCloud::RemoveStreamRequest(ETangoPointSpace::Type Space, bool bFiltered)
+{
+	TArray<int32>& StreamRequests = UTangoDevice::Get().PointStreamRequests;
+	StreamRequests.SetNumZeroed(NumPointStreams);
+	int32& Count = StreamRequests[GetStreamIndex(Space, bFiltered)];
+	Count = FMath::Max(Count - 1, 0);
+}
+
+FTangoPointCloudFramePtr TangoDevicePointCloud::GetLatestFrame(ETangoPointSpace::Type Space, bool bFiltered)
+{
+	FScopeLock Lock(&LatestFramesLock);
+	return LatestFrames[GetStreamIndex(Space, bFiltered)];
+}
 
-const TangoPointCloud* TangoDevicePointCloud::GetLatestPointCloud()
+void TangoDevicePointCloud::RunProcessor()
 {
-	TangoPointCloud* point_cloud = nullptr;
-	if (point_cloud_manager_ != nullptr)
+	int64 ProcessedGeneration = 0;
+	while (bProcessing)
 	{
-		if (TangoSupport_getLatestPointCloud(point_cloud_manager_, &point_cloud) != TANGO_SUCCESS)
+		NewFrameEvent->Wait(100);
+		if (!bProcessing)
 		{
-			return nullptr;
+			break;
+		}
+		//Only the newest frame is worth converting, frames that arrived while we were busy are skipped
+		TangoPointCloudRing::FPin Pin = PointCloudRing->PinLatest();
+		if (Pin.IsValid() && Pin.GetGeneration() != ProcessedGeneration)
+		{
+			ProcessedGeneration = Pin.GetGeneration();
+			ProcessFrame(Pin);
+		}
+	}
+}
+
+TSharedPtr<FTangoPointCloudFrame, ESPMode::ThreadSafe> TangoDevicePointCloud::AcquireFrame()
+{
+	for (const TSharedPtr<FTangoPointCloudFrame, ESPMode::ThreadSafe>& Frame : FramePool)
+	{
+		//Only the pool references it, so no consumer can be reading it
+		if (Frame.IsUnique())
+		{
+			return Frame;
 		}
-		UE_LOG(TangoPlugin, Log, TEXT("Got Latest Point Cloud %p: %d"), point_cloud, (point_cloud ? point_cloud->num_points : 0));
 	}
-	return point_cloud;
+	FramePool.Add(MakeShareable(new FTangoPointCloudFrame()));
+	return FramePool.Last();
 }
 
+TSharedPtr<TangoPointCloudIndex, ESPMode::ThreadSafe> TangoDevicePointCloud::AcquireIndex()
+{
+	for (const TSharedPtr<TangoPointCloudIndex, ESPMode::ThreadSafe>& Index : IndexPool)
+	{
+		if (Index.IsUnique())
+		{
+			return Index;
+		}
+	}
+	IndexPool.Add(MakeShareable(new TangoPointCloudIndex()));
+	return IndexPool.Last();
+}
+
+void TangoDevicePointCloud::ProcessFrame(const TangoPointCloudRing::FPin& Pin)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TangoPointCloudConversion);
+	const int32 Streams = RequestedStreams;
+	const float Scale = UTangoDevice::Get().GetMetersToWorldScale();
+
+	bool bWantsAny[2] = { false, false };
+	for (int32 Space = 0; Space < NumPointStreams / 2; ++Space)
+	{
+		bWantsAny[0] |= (Streams & (1 << GetStreamIndex(Space, false))) != 0;
+		bWantsAny[1] |= (Streams & (1 << GetStreamIndex(Space, true))) != 0;
+	}
+
+	//The filter runs once in depth space and its result is shared by all filtered streams
+	FTangoPointCloudFilterStats FilterStats;
+	if (bWantsAny[1])
+	{
+		SCOPE_CYCLE_COUNTER(STAT_TangoPointCloudFilter);
+		const double FilterStart = FPlatformTime::Seconds();
+		FilterStats.InputPoints = Pin.Num();
+		FilterStats.OutputPoints = PointCloudFilter.Filter(Pin.GetPoints(), Pin.Num(), FilteredPoints);
+		FilterStats.FilterTime = (float)((FPlatformTime::Seconds() - FilterStart) * 1000.0);
+	}
+	const FVector4* Sources[2] = { Pin.GetPoints(), FilteredPoints.GetData() };
+	const int32 SourceCounts[2] = { Pin.Num(), FilteredPoints.Num() };
+
+	//Likewise the index is built once in depth space, frames in other spaces transform their queries into it
+	TSharedPtr<TangoPointCloudIndex, ESPMode::ThreadSafe> Indices[2];
+	if (bBuildIndex)
+	{
+		//Idle frames must not keep their index alive, or it could never be reused
+		for (const TSharedPtr<FTangoPointCloudFrame, ESPMode::ThreadSafe>& Frame : FramePool)
+		{
+			if (Frame.IsUnique())
+			{
+				Frame->Index.Reset();
+			}
+		}
+		SCOPE_CYCLE_COUNTER(STAT_TangoPointCloudIndex);
+		const TangoPointCloudKernels::FPointTransform DepthToLocal = TangoPointCloudKernels::MakeDepthToSpace(FTransform::Identity, Scale);
+		for (int32 Filtered = 0; Filtered < 2; ++Filtered)
+		{
+			if (bWantsAny[Filtered])
+			{
+				Indices[Filtered] = AcquireIndex();
+				Indices[Filtered]->Build(Sources[Filtered], SourceCounts[Filtered], DepthToLocal);
+			}
+		}
+	}
+
+	for (int32 Space = 0; Space < NumPointStreams / 2; ++Space)
+	{
+		const bool bWants[2] = {
+			(Streams & (1 << GetStreamIndex(Space, false))) != 0,
+			(Streams & (1 << GetStreamIndex(Space, true))) != 0 };
+		if (!bWants[0] && !bWants[1])
+		{
+			continue;
+		}
+		FTransform DepthToSpace = FTransform::Identity;
+		if (Space != ETangoPointSpace::LOCAL)
+		{
+			UTangoDeviceMotion* Motion = UTangoDevice::Get().GetTangoDeviceMotionPointer();
+			if (Motion == nullptr || !TangoSpaceConversions::AreConversionsPrepared())
+			{
+				continue;
+			}
+			const ETangoCoordinateFrameType BaseFrame = Space == ETangoPointSpace::ADF_DEPTH ? ETangoCoordinateFrameType::AREA_DESCRIPTION : ETangoCoordinateFrameType::START_OF_SERVICE;
+			FTangoPoseData Pose = Motion->QueryPoseAtTime(FTangoCoordinateFramePair(BaseFrame, ETangoCoordinateFrameType::CAMERA_DEPTH), Pin.GetTimestamp());
+			if (Pose.StatusCode != ETangoPoseStatus::VALID)
+			{
+				//Keep the previous frame for this space rather than publishing one at the wrong place
+				continue;
+			}
+			DepthToSpace = FTransform(Pose.QuatRotation, Pose.Position);
+		}
+		const TangoPointCloudKernels::FPointTransform Transform = TangoPointCloudKernels::MakeDepthToSpace(DepthToSpace, Scale);
+
+		for (int32 Filtered = 0; Filtered < 2; ++Filtered)
+		{
+			if (!bWants[Filtered])
+			{
+				continue;
+			}
+			TSharedPtr<FTangoPointCloudFrame, ESPMode::ThreadSafe> Frame = AcquireFrame();
+			Frame->Timestamp = Pin.GetTimestamp();
+			Frame->Generation = Pin.GetGeneration();
+			Frame->Space = static_cast<ETangoPointSpace::Type>(Space);
+			Frame->DepthToSpace = DepthToSpace;
+			Frame->bFiltered = Filtered != 0;
+			Frame->FilterStats = Filtered ? FilterStats : FTangoPointCloudFilterStats();
+			Frame->Index = Indices[Filtered];
+			Frame->Points.SetNumUninitialized(SourceCounts[Filtered], false);
+			TangoPointCloudKernels::TransformPoints(Sources[Filtered], Frame->Points.GetData(), SourceCounts[Filtered], Transform);
+
+			FScopeLock Lock(&LatestFramesLock);
+			LatestFrames[GetStreamIndex(Space, Filtered != 0)] = Frame;
+		}
+	}
+}
+
+#if PLATFORM_ANDROID
+
 void TangoDevicePointCloud::HandleOnPointCloudAvailable(const TangoPointCloud* PointCloud)
 {
-	FScopeLock ScopeLock(GetPointCloudLock());
-	if (point_cloud_manager_ != nullptr)
+	if (PointCloudRing != nullptr && PointCloud != nullptr)
+	{
+		if (!PointCloudRing->Write(PointCloud->points, PointCloud->num_points, PointCloud->timestamp))
+		{
+			//Runs on the depth callback, so only the first drop is logged. GetDroppedFrameCount keeps counting them.
+			static bool bWarned = false;
+			if (!bWarned)
+			{
+				bWarned = true;
+				UE_LOG(TangoPlugin, Warning, TEXT("TangoDevicePointCloud::HandleOnPointCloudAvailable: All point cloud buffers are pinned, dropping frames. Raise PointCloudBufferCount in the Tango config if this keeps happening."));
+			}
+		}
+		else if (NewFrameEvent != nullptr)
+		{
+			NewFrameEvent->Trigger();
+		}
+	}
+	RecorderCallbacksInFlight.Increment();
+	TangoDepthRecorder* Recorder = ActiveRecorder;
+	if (Recorder != nullptr && PointCloud != nullptr)
 	{
-		//UE_LOG(TangoPlugin, Log, TEXT("Updating Point Cloud %p"), PointCloud);
-		TangoSupport_updatePointCloud(point_cloud_manager_, PointCloud);
-		//UE_LOG(TangoPlugin, Log, TEXT("Updating Point Cloud latest => %p"), GetLatestPointCloud());
+		Recorder->AddFrame(PointCloud->points, PointCloud->num_points, PointCloud->timestamp);
 	}
-	OnPointCloudAvailable.Broadcast(PointCloud);
+	RecorderCallbacksInFlight.Decrement();
 }
 
 
 bool TangoDevicePointCloud::FitPlane(float X, float Y, FTransform& Result)
 {
-	// Get the latest point cloud
-	FScopeLock ScopeLock(GetPointCloudLock());
-	const TangoPointCloud* point_cloud = GetLatestPointCloud();
+	const FVector2D UV(X, Y);
+	bool bSuccess = false;
+	Result = FTransform::Identity;
+	FitPlanes(&UV, 1, &Result, &bSuccess);
+	return bSuccess;
+}
+
+int32 TangoDevicePointCloud::FitPlanes(const TArray<FVector2D>& UVs, TArray<FTransform>& Results, TArray<bool>& Successes)
+{
+	Results.Init(FTransform::Identity, UVs.Num());
+	Successes.Init(false, UVs.Num());
+	return FitPlanes(UVs.GetData(), UVs.Num(), Results.GetData(), Successes.GetData());
+}
+
+int32 TangoDevicePointCloud::FitPlanes(const FVector2D* UVs, int32 NumUVs, FTransform* Results, bool* Successes)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TangoFitPlanes);
+
+	// Get the latest point cloud, once for all points
+	TangoPointCloudRing::FPin PointCloudPin = PinLatestPointCloud();
+	const TangoPointCloud* point_cloud = PointCloudPin.GetTangoPointCloud();
 	if (point_cloud == nullptr)
 	{
-		UE_LOG(TangoPlugin, Log, TEXT("%s: No point cloud available yet"));
-		return false;
+		UE_LOG(TangoPlugin, Log, TEXT("TangoDevicePointCloud::FitPlanes: No point cloud available yet"));
+		return 0;
 	}
 	/// Calculate the conversion from the latest depth camera position to the
 	/// position of the most recent color camera image. This corrects for screen
@@ -174,58 +485,64 @@ bool TangoDevicePointCloud::FitPlane(float X, float Y, FTransform& Result)
 		&pose_color_camera_t0_T_depth_camera_t1);
 	if (ret != TANGO_SUCCESS)
 	{
-		UE_LOG(TangoPlugin, Error, TEXT("could not calculate relative pose"));
-		return false;
-	}
-	UE_LOG(TangoPlugin, Log, TEXT("timestamps: camera: %f, point cloud: %f"), camera_time_stamp, point_cloud->timestamp);
-	float uv[2] = { X, Y };
-	double double_depth_position[3];
-	double double_depth_plane_equation[4];
-	if (TangoSupport_fitPlaneModelNearPoint(
-		point_cloud, &pose_color_camera_t0_T_depth_camera_t1,
-		uv, double_depth_position,
-		double_depth_plane_equation) != TANGO_SUCCESS)
-	{
-		return false;
+		UE_LOG(TangoPlugin, Error, TEXT("TangoDevicePointCloud::FitPlanes: could not calculate relative pose"));
+		return 0;
 	}
 
-	// Convert to UE conventions
-	float Forward = (float)double_depth_position[2];
-	float Right = (float)double_depth_position[0];
-	float Up = -(float)double_depth_position[1];
+	FTangoPoseData Data = UTangoDevice::Get().GetTangoDeviceMotionPointer()->
+		GetPoseAtTime(FTangoCoordinateFramePair(ETangoCoordinateFrameType::AREA_DESCRIPTION,
+			ETangoCoordinateFrameType::CAMERA_DEPTH), point_cloud->timestamp);
+	const FMatrix Matrix = FTransform(Data.Rotation, Data.Position).ToMatrixNoScale();
+	const float Scale = UTangoDevice::Get().GetMetersToWorldScale();
+
+	//One after the other, the support library does not document whether it can be called concurrently
+	int32 NumFitted = 0;
+	for (int32 i = 0; i < NumUVs; ++i)
+	{
+		float uv[2] = { UVs[i].X, UVs[i].Y };
+		double double_depth_position[3];
+		double double_depth_plane_equation[4];
+		if (TangoSupport_fitPlaneModelNearPoint(
+			point_cloud, &pose_color_camera_t0_T_depth_camera_t1,
+			uv, double_depth_position,
+			double_depth_plane_equation) != TANGO_SUCCESS)
+		{
+			continue;
+		}
 
-	FVector DepthPosition(Forward, Right, Up);
-	DepthPosition *= 100; // m to cm
+		// Convert to UE conventions
+		float Forward = (float)double_depth_position[2];
+		float Right = (float)double_depth_position[0];
+		float Up = -(float)double_depth_position[1];
 
-	Forward = (float)double_depth_plane_equation[2];
-	Right = (float)double_depth_plane_equation[0];
-	Up = -(float)double_depth_plane_equation[1];
+		FVector DepthPosition(Forward, Right, Up);
+		DepthPosition *= Scale;
 
-	FPlane DepthPlane(
-		Forward, Right, Up,
-		-(float)double_depth_plane_equation[3]
-	);
+		Forward = (float)double_depth_plane_equation[2];
+		Right = (float)double_depth_plane_equation[0];
+		Up = -(float)double_depth_plane_equation[1];
 
-	FTangoPoseData Data = UTangoDevice::Get().GetTangoDeviceMotionPointer()->
-		GetPoseAtTime(FTangoCoordinateFramePair(ETangoCoordinateFrameType::AREA_DESCRIPTION,
-			ETangoCoordinateFrameType::CAMERA_DEPTH), point_cloud->timestamp);
+		FPlane DepthPlane(
+			Forward, Right, Up,
+			-(float)double_depth_plane_equation[3]
+		);
 
-	const FTransform Transform(Data.Rotation, Data.Position);
-	const FMatrix Matrix = Transform.ToMatrixNoScale();
-	FVector WorldForward = DepthPlane.TransformBy(Matrix);
-	FVector WorldPoint = Matrix.TransformPosition(DepthPosition);
-	//UE_LOG(TangoPlugin, Log, TEXT("Fit plane World Point: %s"), *WorldPoint.ToString());
-	FVector WorldUp(0, 0, 1);
-	if ((WorldForward|WorldUp) > 0.5f)
-	{
-		WorldUp = FVector(1, 0, 0);
-	}
-	FVector WorldRight = WorldForward^WorldUp;
-	WorldRight.Normalize();
-	WorldUp = WorldForward^WorldRight;
-	WorldUp.Normalize();
-	Result = FTransform(WorldForward, WorldRight, WorldUp, WorldPoint);
-	return true;
+		FVector WorldForward = DepthPlane.TransformBy(Matrix);
+		FVector WorldPoint = Matrix.TransformPosition(DepthPosition);
+		FVector WorldUp(0, 0, 1);
+		if ((WorldForward|WorldUp) > 0.5f)
+		{
+			WorldUp = FVector(1, 0, 0);
+		}
+		FVector WorldRight = WorldForward^WorldUp;
+		WorldRight.Normalize();
+		WorldUp = WorldForward^WorldRight;
+		WorldUp.Normalize();
+		Results[i] = FTransform(WorldForward, WorldRight, WorldUp, WorldPoint);
+		Successes[i] = true;
+		++NumFitted;
+	}
+	return NumFitted;
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -15,10 +15,14 @@ limitations under the License.*/
 #pragma once
 
 #include "Object.h"
+#include "TangoPointCloudRing.h"
+#include "TangoPointCloudComponent.h"
+#include "TangoPointCloudFilter.h"
+#include "TangoPointCloudIndex.h"
+#include "TangoDepthRecorder.h"
 #if PLATFORM_ANDROID
 #include "tango_client_api.h"
 #include "tango_support_api.h"
-DECLARE_MULTICAST_DELEGATE_OneParam(FOnPointCloudAvailable, const TangoPointCloud*);
 #endif
 
 class TangoDevicePointCloud
@@ -27,9 +31,6 @@ class TangoDevicePointCloud
 public:
 	int32 GetMaxVertexCapacity();
 	void TickByDevice();
-#if PLATFORM_ANDROID
-	FOnPointCloudAvailable OnPointCloudAvailable;
-#endif
 	TangoDevicePointCloud(
 #if PLATFORM_ANDROID
 		TangoConfig Config_
@@ -39,22 +40,70 @@ public:
 	~TangoDevicePointCloud();
 	
 
-#if PLATFORM_ANDROID	
-	FCriticalSection* GetPointCloudLock()
-	{
-		return &PointCloudMutex;
-	}
-	const TangoPointCloud* GetLatestPointCloud();
+	//Pinned frames stay valid until the pin is released, no lock is needed to read them.
+	TangoPointCloudRing::FPin PinLatestPointCloud();
+	TangoPointCloudRing::FPin PinPointCloudNearest(double Timestamp);
+	int32 GetDroppedFrameCount();
+
+	/** Keeps a point stream converted for a consumer that is not a point cloud component. Game thread only. */
+	static void AddStreamRequest(ETangoPointSpace::Type Space, bool bFiltered);
+	static void RemoveStreamRequest(ETangoPointSpace::Type Space, bool bFiltered);
+
+	/** Latest frame converted into Space by the point cloud worker, or null if there is none yet. Thread safe. */
+	FTangoPointCloudFramePtr GetLatestFrame(ETangoPointSpace::Type Space, bool bFiltered = false);
+
+	/** Records every raw depth frame and its depth camera pose relative to BaseFrame to Filename. Game thread. */
+	bool StartDepthRecording(const FString& Filename, ETangoCoordinateFrameType BaseFrame);
+	void StopDepthRecording();
+	bool IsDepthRecording();
+
+	//Body of the point cloud worker thread
+	void RunProcessor();
+
+#if PLATFORM_ANDROID
 	bool FitPlane(float X, float Y, FTransform& Result);
-	
+	//Fits all points against the same depth frame and poses. Returns how many planes were found.
+	int32 FitPlanes(const TArray<FVector2D>& UVs, TArray<FTransform>& Results, TArray<bool>& Successes);
+	//Results and Successes hold NumUVs entries set by the caller, only the fitted ones are written
+	int32 FitPlanes(const FVector2D* UVs, int32 NumUVs, FTransform* Results, bool* Successes);
 #endif
 	
 private:
 
 #if PLATFORM_ANDROID
-	FCriticalSection PointCloudMutex;
-	TangoSupportPointCloudManager* point_cloud_manager_;
 	void HandleOnPointCloudAvailable(const TangoPointCloud* PointCloud);
 #endif
+	void ProcessFrame(const TangoPointCloudRing::FPin& Pin);
+	TSharedPtr<FTangoPointCloudFrame, ESPMode::ThreadSafe> AcquireFrame();
+	TSharedPtr<TangoPointCloudIndex, ESPMode::ThreadSafe> AcquireIndex();
+
+	TangoPointCloudRing* PointCloudRing;
+	TangoDepthRecorder* DepthRecorder;
+	//DepthRecorder while it records, read by the depth callback without a lock. The recorder lives until the destructor.
+	TangoDepthRecorder* volatile ActiveRecorder;
+	//Callbacks between reading ActiveRecorder and returning from AddFrame, StopDepthRecording waits for them after clearing it
+	FThreadSafeCounter RecorderCallbacksInFlight;
 	uint32_t VertCapacity;
+
+	//Point cloud worker, converts each depth frame once for all components
+	FRunnableThread* ProcessorThread;
+	FEvent* NewFrameEvent;
+	FThreadSafeBool bProcessing;
+	//Every point space exists as an unfiltered and a filtered stream
+	enum { NumPointStreams = 6 };
+	static int32 GetStreamIndex(int32 Space, bool bFiltered) { return Space * 2 + (bFiltered ? 1 : 0); }
+
+	//Bit per stream that at least one component asked for, written on the game thread
+	volatile int32 RequestedStreams;
+	//Only touched by the worker
+	TangoPointCloudFilter PointCloudFilter;
+	TArray<FVector4> FilteredPoints;
+	bool bBuildIndex;
+	TArray<TSharedPtr<TangoPointCloudIndex, ESPMode::ThreadSafe>> IndexPool;
+	//Frames handed out to consumers. Only touched by the worker, a frame is reused once nobody else holds it.
+	TArray<TSharedPtr<FTangoPointCloudFrame, ESPMode::ThreadSafe>> FramePool;
+	FCriticalSection LatestFramesLock;
+	FTangoPointCloudFramePtr LatestFrames[NumPointStreams];
+	//Last frame generation handed to the components on the game thread, per stream
+	int64 TickedGenerations[NumPointStreams];
 };
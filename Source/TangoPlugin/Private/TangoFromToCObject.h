@@ -47,16 +47,53 @@ static FTangoPoseData FromCPointer(const TangoPoseData* ToConvert)
 	Result.Rotation = FRotator(Result.QuatRotation);
 	Result.FrameOfReference = FromCObject(ToConvert->frame);
 	Result.Timestamp = ToConvert->timestamp;
+	Result.PreciseTimestamp = ToConvert->timestamp;
 	Result.StatusCode = (ETangoPoseStatus)ToConvert->status_code;
 	return Result;
 }
 
+//The C enum starts with UNKNOWN while ETangoCalibrationType ends with it, so the values are mapped rather than cast
+static ETangoCalibrationType FromCObject(TangoCalibrationType ToConvert)
+{
+	switch (ToConvert)
+	{
+	case TANGO_CALIBRATION_EQUIDISTANT:
+		return ETangoCalibrationType::EQUIDISTANT;
+	case TANGO_CALIBRATION_POLYNOMIAL_2_PARAMETERS:
+		return ETangoCalibrationType::POLYNOMIAL_2_PARAMETERS;
+	case TANGO_CALIBRATION_POLYNOMIAL_3_PARAMETERS:
+		return ETangoCalibrationType::POLYNOMIAL_3_PARAMETERS;
+	case TANGO_CALIBRATION_POLYNOMIAL_5_PARAMETERS:
+		return ETangoCalibrationType::POLYNOMIAL_5_PARAMETERS;
+	default:
+		return ETangoCalibrationType::UNKNOWN;
+	}
+}
+
+static TangoCalibrationType ToCObject(ETangoCalibrationType ToConvert)
+{
+	switch (ToConvert)
+	{
+	case ETangoCalibrationType::EQUIDISTANT:
+		return TANGO_CALIBRATION_EQUIDISTANT;
+	case ETangoCalibrationType::POLYNOMIAL_2_PARAMETERS:
+		return TANGO_CALIBRATION_POLYNOMIAL_2_PARAMETERS;
+	case ETangoCalibrationType::POLYNOMIAL_3_PARAMETERS:
+		return TANGO_CALIBRATION_POLYNOMIAL_3_PARAMETERS;
+	case ETangoCalibrationType::POLYNOMIAL_5_PARAMETERS:
+		return TANGO_CALIBRATION_POLYNOMIAL_5_PARAMETERS;
+	default:
+		return TANGO_CALIBRATION_UNKNOWN;
+	}
+}
+
 static FTangoCameraIntrinsics FromCObject(TangoCameraIntrinsics ToConvert)
 {
 
 	FTangoCameraIntrinsics Result;
 
 	Result.CameraID = static_cast<ETangoCameraType>((int)ToConvert.camera_id);
+	Result.CalibrationType = FromCObject(ToConvert.calibration_type);
 
 	Result.Width = static_cast<int32>(ToConvert.width);
 	Result.Height = static_cast<int32> (ToConvert.height);
@@ -43,6 +43,59 @@ FTangoCameraIntrinsics UTangoFunctionLibrary::GetCameraIntrinsics(ETangoCameraTy
 	return UTangoDevice::Get().GetCameraIntrinsics(CameraID);
 }
 
+bool UTangoFunctionLibrary::StartDepthRecording(const FString& Filename, ETangoCoordinateFrameType BaseFrame)
+{
+	if (UTangoDevice::Get().GetTangoDevicePointCloudPointer() == nullptr)
+	{
+		UE_LOG(TangoPlugin, Warning, TEXT("UTangoFunctionLibrary::StartDepthRecording: Depth capabilities are not enabled"));
+		return false;
+	}
+	return UTangoDevice::Get().GetTangoDevicePointCloudPointer()->StartDepthRecording(Filename, BaseFrame);
+}
+
+void UTangoFunctionLibrary::StopDepthRecording()
+{
+	if (UTangoDevice::Get().GetTangoDevicePointCloudPointer() != nullptr)
+	{
+		UTangoDevice::Get().GetTangoDevicePointCloudPointer()->StopDepthRecording();
+	}
+}
+
+bool UTangoFunctionLibrary::IsDepthRecording()
+{
+	return UTangoDevice::Get().GetTangoDevicePointCloudPointer() != nullptr && UTangoDevice::Get().GetTangoDevicePointCloudPointer()->IsDepthRecording();
+}
+
+void UTangoFunctionLibrary::SetPosePredictionSettings(const FTangoPosePredictionSettings& Settings)
+{
+	if (UTangoDevice::Get().GetTangoDeviceMotionPointer() == nullptr)
+	{
+		UE_LOG(TangoPlugin, Warning, TEXT("UTangoFunctionLibrary::SetPosePredictionSettings: Motion tracking is not enabled"));
+		return;
+	}
+	UTangoDevice::Get().GetTangoDeviceMotionPointer()->SetPredictionSettings(Settings);
+}
+
+FTangoPosePredictionSettings UTangoFunctionLibrary::GetPosePredictionSettings()
+{
+	return UTangoDevice::Get().GetTangoDeviceMotionPointer() != nullptr ? UTangoDevice::Get().GetTangoDeviceMotionPointer()->GetPredictionSettings() : FTangoPosePredictionSettings();
+}
+
+bool UTangoFunctionLibrary::SetPoseFilter(FTangoCoordinateFramePair FrameOfReference, const FTangoPoseFilterSettings& Settings)
+{
+	if (UTangoDevice::Get().GetTangoDeviceMotionPointer() == nullptr)
+	{
+		UE_LOG(TangoPlugin, Warning, TEXT("UTangoFunctionLibrary::SetPoseFilter: Motion tracking is not enabled"));
+		return false;
+	}
+	return UTangoDevice::Get().GetTangoDeviceMotionPointer()->SetPoseFilter(FrameOfReference, Settings);
+}
+
+FTangoPoseFilterSettings UTangoFunctionLibrary::GetPoseFilter(FTangoCoordinateFramePair FrameOfReference)
+{
+	return UTangoDevice::Get().GetTangoDeviceMotionPointer() != nullptr ? UTangoDevice::Get().GetTangoDeviceMotionPointer()->GetPoseFilter(FrameOfReference) : FTangoPoseFilterSettings();
+}
+
 TArray<FTangoAreaDescription> UTangoFunctionLibrary::GetAllAreaDescriptionData()
 {
 	return UTangoDevice::Get().GetAreaDescriptions();
@@ -89,27 +142,17 @@ void UTangoFunctionLibrary::GetBinaryAreaDescription(const FTangoAreaDescription
 
 void UTangoFunctionLibrary::ConvertTransformFromTango(const FTransform& Transform, ETangoCoordinateFrameType BaseFrame, FTransform& Result)
 {
-  TangoSpaceConversions::TangoSpaceConversionPair Converter;
-  FTangoCoordinateFramePair RefPair;
-  RefPair.BaseFrame = BaseFrame;
-  RefPair.TargetFrame = BaseFrame;
-  TangoSpaceConversions::GetSpaceConversionPair(Converter, RefPair);
   FMatrix Target = Transform.ToMatrixWithScale();
-  Result.SetFromMatrix(Converter.TargetFrameToUE * Target);
+  Result.SetFromMatrix(TangoSpaceConversions::GetFrameToUE(BaseFrame) * Target);
   Result.SetTranslation(Result.GetTranslation() * 100);
 }
 
 void UTangoFunctionLibrary::ConvertTransformToTango(const FTransform& Transform, ETangoCoordinateFrameType TargetFrame, FTransform& Result)
 {
-  TangoSpaceConversions::TangoSpaceConversionPair Converter;
-  FTangoCoordinateFramePair RefPair;
-  RefPair.BaseFrame = TargetFrame;
-  RefPair.TargetFrame = TargetFrame;
-  TangoSpaceConversions::GetSpaceConversionPair(Converter, RefPair);
   FTransform Scaled = Transform;
   Scaled.SetTranslation(Transform.GetTranslation() * .01f);
   FMatrix Source = Scaled.ToMatrixWithScale();
-  Result.SetFromMatrix(Converter.UEtoBaseFrame * Source);
+  Result.SetFromMatrix(TangoSpaceConversions::GetFrameToUE(TargetFrame).Inverse() * Source);
 }
 
 
@@ -23,6 +23,28 @@ UTangoImageComponent::UTangoImageComponent() : Super()
 	PrimaryComponentTick.bCanEverTick = true;
 }
 
+void UTangoImageComponent::BeginPlay()
+{
+	Super::BeginPlay();
+	if (bConvertCameraFrames)
+	{
+		RequestedFormat = CameraFrameFormat;
+		RequestedScale = CameraFrameScale;
+		TangoImageConverter::AddStreamRequest(RequestedFormat, RequestedScale);
+		bRequestedCameraFrames = true;
+	}
+}
+
+void UTangoImageComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (bRequestedCameraFrames)
+	{
+		TangoImageConverter::RemoveStreamRequest(RequestedFormat, RequestedScale);
+		bRequestedCameraFrames = false;
+	}
+	Super::EndPlay(EndPlayReason);
+}
+
 void UTangoImageComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction)
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
@@ -30,7 +52,7 @@ void UTangoImageComponent::TickComponent(float DeltaTime, enum ELevelTick TickTy
 	{
 		if (UTangoDevice::Get().GetTangoDeviceImagePointer()->VideoTexture)
 		{
-			float TimeStamp = UTangoDevice::Get().GetTangoDeviceImagePointer()->GetImageBufferTimestamp();
+			double TimeStamp = UTangoDevice::Get().GetTangoDeviceImagePointer()->GetImageBufferTimestamp();
 			if (TimeStamp != LastBroadCastedTimestamp)
 			{
 				LastBroadCastedTimestamp = TimeStamp;
@@ -57,14 +79,65 @@ UTexture* UTangoImageComponent::GetCameraTexture(float& Timestamp, bool& bIsVali
 }
 
 float UTangoImageComponent::GetLatestImageTimeStamp()
+{
+	return GetLatestImagePreciseTimestamp();
+}
+
+double UTangoImageComponent::GetLatestImagePreciseTimestamp()
 {
 	if (UTangoDevice::Get().GetTangoDeviceImagePointer() == nullptr)
 	{
-		UE_LOG(TangoPlugin, Warning, TEXT("UTangoImageComponent::GetLatestImageTimeStamp: Color Camera is not enabled"));
-		return 0.0f;
+		UE_LOG(TangoPlugin, Warning, TEXT("UTangoImageComponent::GetLatestImagePreciseTimestamp: Color Camera is not enabled"));
+		return 0.0;
 	}
 	else
 	{
 		return UTangoDevice::Get().GetTangoDeviceImagePointer()->GetImageBufferTimestamp();
 	}
 }
+
+FTangoCameraFramePtr UTangoImageComponent::GetLatestCameraFrame() const
+{
+	UTangoDeviceImage* Image = UTangoDevice::Get().GetTangoDeviceImagePointer();
+	if (!bRequestedCameraFrames || Image == nullptr || Image->GetImageConverter() == nullptr)
+	{
+		return FTangoCameraFramePtr();
+	}
+	return Image->GetImageConverter()->GetLatestFrame(RequestedFormat, RequestedScale);
+}
+
+FDelegateHandle UTangoImageComponent::AddCameraImageListener(const FOnTangoCameraImageAvailable& Listener, const FTangoCameraImageRequest& Request)
+{
+	UTangoDevice& Device = UTangoDevice::Get();
+	FScopeLock Lock(&Device.CameraImageListenersLock);
+	FTangoCameraImageListener& Added = Device.CameraImageListeners[Device.CameraImageListeners.AddDefaulted()];
+	Added.Delegate = Listener;
+	Added.Request = Request;
+	return Added.Delegate.GetHandle();
+}
+
+void UTangoImageComponent::RemoveCameraImageListener(FDelegateHandle Handle)
+{
+	UTangoDevice& Device = UTangoDevice::Get();
+	FScopeLock Lock(&Device.CameraImageListenersLock);
+	Device.CameraImageListeners.RemoveAll([&Handle](const FTangoCameraImageListener& Listener) { return Listener.Delegate.GetHandle() == Handle; });
+}
+
+FTangoCameraImagePoolStats UTangoImageComponent::GetCameraImagePoolStats()
+{
+	FTangoCameraImagePoolStats Stats;
+	UTangoDeviceImage* Image = UTangoDevice::Get().GetTangoDeviceImagePointer();
+	if (Image != nullptr && Image->GetImagePool() != nullptr)
+	{
+		TangoCameraImagePool* Pool = Image->GetImagePool();
+		Stats.PoolSize = Pool->GetNumImages();
+		Stats.ImagesHeld = Pool->GetNumHeld();
+		Stats.CopiedImages = Pool->GetCopiedImageCount();
+		Stats.DroppedImages = Pool->GetDroppedImageCount();
+	}
+	if (Image != nullptr && Image->GetImageConverter() != nullptr)
+	{
+		Stats.SkippedConversions = Image->GetImageConverter()->GetSkippedConversionCount();
+	}
+	return Stats;
+}
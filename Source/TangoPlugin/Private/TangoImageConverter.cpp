@@ -0,0 +1,195 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+
+#include "TangoPluginPrivatePCH.h"
+#include "TangoImageConverter.h"
+#include "TangoDevice.h"
+
+DECLARE_CYCLE_STAT(TEXT("Camera Image Conversion"), STAT_TangoCameraImageConversion, STATGROUP_Tango);
+
+class ImageConverterRunnable : public FRunnable
+{
+	TangoImageConverter* Target;
+public:
+	ImageConverterRunnable(TangoImageConverter* InTarget) : Target(InTarget) {}
+
+	uint32 Run() override
+	{
+		Target->RunConverter();
+		return 0;
+	}
+};
+
+TangoImageConverter::TangoImageConverter()
+	: RequestedStreams(0)
+{
+	UE_LOG(TangoPlugin, Log, TEXT("TangoImageConverter::TangoImageConverter: Using the %s camera image kernel"), TangoImageKernels::GetPathName());
+	NewImageEvent = FPlatformProcess::GetSynchEventFromPool();
+	bConverting = true;
+	Thread = FRunnableThread::Create(new ImageConverterRunnable(this), TEXT("TangoImageConverter"));
+}
+
+TangoImageConverter::~TangoImageConverter()
+{
+	bConverting = false;
+	if (Thread != nullptr)
+	{
+		NewImageEvent->Trigger();
+		Thread->WaitForCompletion();
+		delete Thread;
+		Thread = nullptr;
+	}
+	FPlatformProcess::ReturnSynchEventToPool(NewImageEvent);
+	NewImageEvent = nullptr;
+}
+
+void TangoImageConverter::AddStreamRequest(ETangoCameraFrameFormat Format, ETangoCameraFrameScale Scale)
+{
+	TArray<int32>& StreamRequests = UTangoDevice::Get().CameraFrameStreamRequests;
+	StreamRequests.SetNumZeroed(NumStreams);
+	StreamRequests[GetStreamIndex(Format, Scale)]++;
+}
+
+void TangoImageConverter::RemoveStreamRequest(ETangoCameraFrameFormat Format, ETangoCameraFrameScale Scale)
+{
+	TArray<int32>& StreamRequests = UTangoDevice::Get().CameraFrameStreamRequests;
+	StreamRequests.SetNumZeroed(NumStreams);
+	int32& Count = StreamRequests[GetStreamIndex(Format, Scale)];
+	Count = FMath::Max(Count - 1, 0);
+}
+
+void TangoImageConverter::TickByDevice()
+{
+	const TArray<int32>& StreamRequests = UTangoDevice::Get().CameraFrameStreamRequests;
+	int32 Streams = 0;
+	for (int32 Stream = 0; Stream < StreamRequests.Num(); ++Stream)
+	{
+		if (StreamRequests[Stream] > 0)
+		{
+			Streams |= 1 << Stream;
+		}
+	}
+	FPlatformAtomics::InterlockedExchange(&RequestedStreams, Streams);
+}
+
+void TangoImageConverter::AddImage(const FTangoCameraImagePtr& Image)
+{
+	if (RequestedStreams == 0 || !Image.IsValid())
+	{
+		return;
+	}
+	{
+		FScopeLock Lock(&PendingLock);
+		PendingImage = Image;
+	}
+	NewImageEvent->Trigger();
+}
+
+FTangoCameraFramePtr TangoImageConverter::GetLatestFrame(ETangoCameraFrameFormat Format, ETangoCameraFrameScale Scale)
+{
+	FScopeLock Lock(&LatestFramesLock);
+	return LatestFrames[GetStreamIndex(Format, Scale)];
+}
+
+void TangoImageConverter::RunConverter()
+{
+	while (bConverting)
+	{
+		NewImageEvent->Wait(100);
+		if (!bConverting)
+		{
+			break;
+		}
+		FTangoCameraImagePtr Raw;
+		{
+			FScopeLock Lock(&PendingLock);
+			Raw = PendingImage;
+			PendingImage.Reset();
+		}
+		const int32 Streams = RequestedStreams;
+		if (Raw.IsValid() && Streams != 0)
+		{
+			ConvertImage(*Raw, Streams);
+		}
+	}
+}
+
+TSharedPtr<FTangoCameraFrame, ESPMode::ThreadSafe> TangoImageConverter::AcquireFrame(int32 Stream)
+{
+	TArray<TSharedPtr<FTangoCameraFrame, ESPMode::ThreadSafe>>& FramePool = FramePools[Stream];
+	for (const TSharedPtr<FTangoCameraFrame, ESPMode::ThreadSafe>& Frame : FramePool)
+	{
+		//Only the pool references it, so no consumer can be reading it
+		if (Frame.IsUnique())
+		{
+			return Frame;
+		}
+	}
+	//Consumers holding on to frames must not make the pool grow without bound
+	if (FramePool.Num() >= MaxFramesPerStream)
+	{
+		return nullptr;
+	}
+	FramePool.Add(MakeShareable(new FTangoCameraFrame()));
+	return FramePool.Last();
+}
+
+void TangoImageConverter::ConvertImage(const FTangoCameraImage& Raw, int32 Streams)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TangoCameraImageConversion);
+	TangoImageKernels::FYUVImage Image;
+	Image.Y = Raw.GetY();
+	Image.V = Raw.GetV();
+	Image.U = Raw.GetU();
+	Image.Width = Raw.Width;
+	Image.Height = Raw.Height;
+	Image.YStride = Raw.Stride;
+	Image.ChromaStride = Raw.ChromaStride;
+	Image.Format = Raw.Format;
+	for (int32 Stream = 0; Stream < NumStreams; ++Stream)
+	{
+		if ((Streams & (1 << Stream)) == 0)
+		{
+			continue;
+		}
+		const ETangoCameraFrameFormat Format = static_cast<ETangoCameraFrameFormat>(Stream / NumScales);
+		const ETangoCameraFrameScale Scale = static_cast<ETangoCameraFrameScale>(Stream % NumScales);
+		const int32 Downsample = (int32)Scale;
+
+		TSharedPtr<FTangoCameraFrame, ESPMode::ThreadSafe> Frame = AcquireFrame(Stream);
+		//The stream keeps its previous frame until one is released
+		if (!Frame.IsValid())
+		{
+			SkippedConversions.Increment();
+			continue;
+		}
+		Frame->Width = TangoImageKernels::GetOutputSize(Image.Width, Downsample);
+		Frame->Height = TangoImageKernels::GetOutputSize(Image.Height, Downsample);
+		Frame->Timestamp = Raw.Timestamp;
+		Frame->FrameNumber = Raw.FrameNumber;
+		Frame->Format = Format;
+		Frame->Scale = Scale;
+		Frame->Pixels.SetNumUninitialized(Frame->Width * Frame->Height * 4, false);
+		TangoImageKernels::ConvertToRGBA(Image, Frame->Pixels.GetData(), Format == ETangoCameraFrameFormat::BGRA, Downsample);
+
+		const FTangoCameraFramePtr Published = Frame;
+		{
+			FScopeLock Lock(&LatestFramesLock);
+			LatestFrames[Stream] = Published;
+		}
+		FScopeLock Lock(&ListenersLock);
+		OnFrameConverted.Broadcast(Published);
+	}
+}
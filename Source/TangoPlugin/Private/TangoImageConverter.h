@@ -0,0 +1,85 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+
+#pragma once
+
+#include "TangoImageComponent.h"
+#include "TangoImageKernels.h"
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnTangoCameraFrameConverted, const FTangoCameraFramePtr&);
+
+/**
+ * Converts the colour camera images delivered by the Tango frame callback on a worker thread, once per image for all consumers.
+ * The callback hands over the pooled copy of each image and returns. If the worker is busy, a newer image replaces the waiting one.
+ * Only the streams, a byte order at a resolution, that someone asked for are converted.
+ */
+class TangoImageConverter
+{
+public:
+	enum { NumFormats = 2, NumScales = 3, NumStreams = NumFormats * NumScales };
+	//Frames allocated per stream at most, the latest one plus two held by consumers
+	enum { MaxFramesPerStream = 3 };
+	static int32 GetStreamIndex(ETangoCameraFrameFormat Format, ETangoCameraFrameScale Scale) { return (int32)Format * NumScales + (int32)Scale; }
+
+	TangoImageConverter();
+	~TangoImageConverter();
+
+	/** Keeps a stream converted for a consumer. Game thread only. */
+	static void AddStreamRequest(ETangoCameraFrameFormat Format, ETangoCameraFrameScale Scale);
+	static void RemoveStreamRequest(ETangoCameraFrameFormat Format, ETangoCameraFrameScale Scale);
+
+	/** Hands the requested streams to the callback and the worker. Game thread. */
+	void TickByDevice();
+
+	/** Whether any stream is requested, so camera images need to be copied for the worker. Thread safe. */
+	bool HasStreamRequests() const { return RequestedStreams != 0; }
+	/** Queues Image for the worker if any stream is requested. Camera callback thread only. */
+	void AddImage(const FTangoCameraImagePtr& Image);
+
+	/** Newest frame of a stream, or null if there is none yet. Thread safe. */
+	FTangoCameraFramePtr GetLatestFrame(ETangoCameraFrameFormat Format, ETangoCameraFrameScale Scale);
+
+	/** Broadcast on the worker thread for every converted frame. Hold GetListenersLock while adding or removing listeners. */
+	FOnTangoCameraFrameConverted OnFrameConverted;
+
+	/** Number of stream conversions skipped because consumers held every pooled frame. Thread safe. */
+	int32 GetSkippedConversionCount() const { return SkippedConversions.GetValue(); }
+	FCriticalSection& GetListenersLock() { return ListenersLock; }
+
+	//Body of the worker thread
+	void RunConverter();
+
+private:
+	void ConvertImage(const FTangoCameraImage& Raw, int32 Streams);
+	TSharedPtr<FTangoCameraFrame, ESPMode::ThreadSafe> AcquireFrame(int32 Stream);
+
+	FRunnableThread* Thread;
+	FEvent* NewImageEvent;
+	FThreadSafeBool bConverting;
+	//Bit per stream someone asked for, written on the game thread
+	volatile int32 RequestedStreams;
+
+	//Holding the image keeps the camera image pool from recycling it until it is converted
+	FCriticalSection PendingLock;
+	FTangoCameraImagePtr PendingImage;
+
+	//Frames handed out to consumers. Only touched by the worker, a frame is reused once nobody else holds it.
+	//Each stream has its own frames, so a consumer holding on to one stream does not starve the others.
+	TArray<TSharedPtr<FTangoCameraFrame, ESPMode::ThreadSafe>> FramePools[NumStreams];
+	FThreadSafeCounter SkippedConversions;
+	FCriticalSection LatestFramesLock;
+	FTangoCameraFramePtr LatestFrames[NumStreams];
+	FCriticalSection ListenersLock;
+};
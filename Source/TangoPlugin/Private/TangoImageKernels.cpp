@@ -0,0 +1,771 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+
+#include "TangoPluginPrivatePCH.h"
+#include "TangoImageKernels.h"
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define TANGO_IMAGE_KERNEL_NEON 1
+#include <arm_neon.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TANGO_IMAGE_KERNEL_SSE 1
+#include <emmintrin.h>
+#endif
+
+typedef TangoImageKernels::FYUVImage FYUVImage;
+typedef TangoImageKernels::FRemapEntry FRemapEntry;
+
+namespace
+{
+	//Full range BT.601 scaled by 64. Every intermediate of a pixel fits in 16 bits, which the vector paths rely on.
+	enum { FixedShift = 6, CoeffRV = 90, CoeffGU = 22, CoeffGV = 46, CoeffBU = 113 };
+
+	FORCEINLINE bool IsInterleaved(const FYUVImage& In)
+	{
+		return In.Format == ETangoImageFormat::TANGO_HAL_PIXEL_FORMAT_YCrCb_420_SP;
+	}
+
+	FORCEINLINE uint8 ToByte(int32 Value)
+	{
+		return (uint8)FMath::Clamp((Value + (1 << (FixedShift - 1))) >> FixedShift, 0, 255);
+	}
+
+	//Y64 is luma scaled by 64, U and V are centred on 0
+	FORCEINLINE void StorePixel(uint8* Out, int32 Y64, int32 U, int32 V, bool bBGRA)
+	{
+		const uint8 R = ToByte(Y64 + CoeffRV * V);
+		const uint8 G = ToByte(Y64 - CoeffGU * U - CoeffGV * V);
+		const uint8 B = ToByte(Y64 + CoeffBU * U);
+		Out[0] = bBGRA ? B : R;
+		Out[1] = G;
+		Out[2] = bBGRA ? R : B;
+		Out[3] = 255;
+	}
+
+	//X and Y are in chroma samples, half the luma resolution
+	FORCEINLINE void ReadChroma(const FYUVImage& In, int32 X, int32 Y, int32& OutU, int32& OutV)
+	{
+		if (IsInterleaved(In))
+		{
+			const uint8* Pair = In.V + Y * In.ChromaStride + X * 2;
+			OutV = Pair[0] - 128;
+			OutU = Pair[1] - 128;
+		}
+		else
+		{
+			OutV = In.V[Y * In.ChromaStride + X] - 128;
+			OutU = In.U[Y * In.ChromaStride + X] - 128;
+		}
+	}
+
+	//Converts output pixels [FirstX, EndX) of output row OutY
+	void ConvertPixelsScalar(const FYUVImage& In, uint8* OutRow, int32 OutY, int32 FirstX, int32 EndX, bool bBGRA, int32 Downsample)
+	{
+		for (int32 X = FirstX; X < EndX; ++X)
+		{
+			int32 Y64, U, V;
+			if (Downsample == 0)
+			{
+				Y64 = In.Y[OutY * In.YStride + X] << FixedShift;
+				ReadChroma(In, X >> 1, OutY >> 1, U, V);
+			}
+			else if (Downsample == 1)
+			{
+				//A 2x2 luma block shares exactly one chroma sample
+				const uint8* Row0 = In.Y + 2 * OutY * In.YStride + 2 * X;
+				const uint8* Row1 = Row0 + In.YStride;
+				Y64 = (Row0[0] + Row0[1] + Row1[0] + Row1[1]) << (FixedShift - 2);
+				ReadChroma(In, X, OutY, U, V);
+			}
+			else
+			{
+				int32 Sum = 0;
+				for (int32 j = 0; j < 4; ++j)
+				{
+					const uint8* Row = In.Y + (4 * OutY + j) * In.YStride + 4 * X;
+					Sum += Row[0] + Row[1] + Row[2] + Row[3];
+				}
+				Y64 = Sum << (FixedShift - 4);
+				int32 SumU = 0;
+				int32 SumV = 0;
+				for (int32 j = 0; j < 2; ++j)
+				{
+					for (int32 i = 0; i < 2; ++i)
+					{
+						int32 SampleU, SampleV;
+						ReadChroma(In, 2 * X + i, 2 * OutY + j, SampleU, SampleV);
+						SumU += SampleU;
+						SumV += SampleV;
+					}
+				}
+				U = (SumU + 2) >> 2;
+				V = (SumV + 2) >> 2;
+			}
+			StorePixel(OutRow + X * 4, Y64, U, V, bBGRA);
+		}
+	}
+
+	enum { FracBits = TangoImageKernels::RemapFracBits, FracOne = TangoImageKernels::RemapFracOne, InvalidFrac = TangoImageKernels::InvalidRemapFrac };
+
+	//Interpolates one channel of a 2x2 block, rounding to nearest
+	FORCEINLINE uint8 Bilinear(int32 TopLeft, int32 TopRight, int32 BottomLeft, int32 BottomRight, int32 FracX, int32 FracY)
+	{
+		const int32 Top = TopLeft * (FracOne - FracX) + TopRight * FracX;
+		const int32 Bottom = BottomLeft * (FracOne - FracX) + BottomRight * FracX;
+		return (uint8)((Top * (FracOne - FracY) + Bottom * FracY + (1 << (2 * FracBits - 1))) >> (2 * FracBits));
+	}
+
+	//Remaps output pixels [FirstX, EndX) of one row, Row being the table entries of that row
+	void RemapPixelsScalar(const FRemapEntry* Row, const uint8* In, int32 Stride, uint8* OutRow, int32 FirstX, int32 EndX, int32 NumChannels)
+	{
+		for (int32 X = FirstX; X < EndX; ++X)
+		{
+			const FRemapEntry& Entry = Row[X];
+			uint8* Out = OutRow + X * NumChannels;
+			if (Entry.FracX == InvalidFrac)
+			{
+				FMemory::Memzero(Out, NumChannels);
+				continue;
+			}
+			const uint8* Block = In + Entry.Y * Stride + Entry.X * NumChannels;
+			for (int32 Channel = 0; Channel < NumChannels; ++Channel)
+			{
+				Out[Channel] = Bilinear(Block[Channel], Block[NumChannels + Channel], Block[Stride + Channel], Block[Stride + NumChannels + Channel], Entry.FracX, Entry.FracY);
+			}
+		}
+	}
+
+	//Downsamples output pixels [FirstX, EndX) of one luma row from the two input rows above it
+	void DownsampleLumaPixelsScalar(const uint8* Row0, const uint8* Row1, uint8* OutRow, int32 FirstX, int32 EndX)
+	{
+		for (int32 X = FirstX; X < EndX; ++X)
+		{
+			OutRow[X] = (uint8)((Row0[2 * X] + Row0[2 * X + 1] + Row1[2 * X] + Row1[2 * X + 1] + 2) >> 2);
+		}
+	}
+}
+
+bool TangoImageKernels::IsSupportedFormat(ETangoImageFormat Format)
+{
+	return Format == ETangoImageFormat::TANGO_HAL_PIXEL_FORMAT_YCrCb_420_SP || Format == ETangoImageFormat::TANGO_HAL_PIXEL_FORMAT_YV12;
+}
+
+void TangoImageKernels::DownsampleLumaScalar(const uint8* In, int32 Width, int32 Height, int32 Stride, uint8* Out, int32 OutStride)
+{
+	for (int32 OutY = 0; OutY < Height / 2; ++OutY)
+	{
+		const uint8* Row0 = In + 2 * OutY * Stride;
+		DownsampleLumaPixelsScalar(Row0, Row0 + Stride, Out + OutY * OutStride, 0, Width / 2);
+	}
+}
+
+void TangoImageKernels::RemapLumaScalar(const FRemapEntry* Table, int32 Width, int32 Height, const uint8* In, int32 Stride, uint8* Out, int32 OutStride)
+{
+	for (int32 Y = 0; Y < Height; ++Y)
+	{
+		RemapPixelsScalar(Table + Y * Width, In, Stride, Out + Y * OutStride, 0, Width, 1);
+	}
+}
+
+void TangoImageKernels::RemapRGBAScalar(const FRemapEntry* Table, int32 Width, int32 Height, const uint8* In, int32 Stride, uint8* Out, int32 OutStride)
+{
+	for (int32 Y = 0; Y < Height; ++Y)
+	{
+		RemapPixelsScalar(Table + Y * Width, In, Stride, Out + Y * OutStride, 0, Width, 4);
+	}
+}
+
+void TangoImageKernels::ConvertToRGBAScalar(const FYUVImage& In, uint8* Out, bool bBGRA, int32 Downsample)
+{
+	const int32 OutWidth = GetOutputSize(In.Width, Downsample);
+	const int32 OutHeight = GetOutputSize(In.Height, Downsample);
+	for (int32 OutY = 0; OutY < OutHeight; ++OutY)
+	{
+		ConvertPixelsScalar(In, Out + OutY * OutWidth * 4, OutY, 0, OutWidth, bBGRA, Downsample);
+	}
+}
+
+#if TANGO_IMAGE_KERNEL_NEON
+
+//Eight chroma samples from X on, centred on 0
+static FORCEINLINE void LoadChromaNEON(const FYUVImage& In, int32 X, int32 Y, int16x8_t& OutU, int16x8_t& OutV)
+{
+	const int16x8_t Bias = vdupq_n_s16(128);
+	if (IsInterleaved(In))
+	{
+		const uint8x8x2_t VU = vld2_u8(In.V + Y * In.ChromaStride + X * 2);
+		OutV = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(VU.val[0])), Bias);
+		OutU = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(VU.val[1])), Bias);
+	}
+	else
+	{
+		OutV = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(In.V + Y * In.ChromaStride + X))), Bias);
+		OutU = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(In.U + Y * In.ChromaStride + X))), Bias);
+	}
+}
+
+//Writes eight pixels with per pixel luma and chroma
+static FORCEINLINE void StorePixelsNEON(uint8* Out, int16x8_t Y64, int16x8_t U, int16x8_t V, bool bBGRA)
+{
+	const uint8x8_t R = vqrshrun_n_s16(vmlaq_n_s16(Y64, V, CoeffRV), FixedShift);
+	const uint8x8_t G = vqrshrun_n_s16(vmlsq_n_s16(vmlsq_n_s16(Y64, U, CoeffGU), V, CoeffGV), FixedShift);
+	const uint8x8_t B = vqrshrun_n_s16(vmlaq_n_s16(Y64, U, CoeffBU), FixedShift);
+	uint8x8x4_t Pixels;
+	Pixels.val[0] = bBGRA ? B : R;
+	Pixels.val[1] = G;
+	Pixels.val[2] = bBGRA ? R : B;
+	Pixels.val[3] = vdup_n_u8(255);
+	vst4_u8(Out, Pixels);
+}
+
+//Returns the number of pixels of the row it converted, the scalar path does the rest
+static int32 ConvertRowNEON(const FYUVImage& In, uint8* OutRow, int32 OutY, int32 OutWidth, bool bBGRA, int32 Downsample)
+{
+	int32 X = 0;
+	if (Downsample == 0)
+	{
+		const uint8* YRow = In.Y + OutY * In.YStride;
+		for (; X + 16 <= OutWidth; X += 16)
+		{
+			const uint8x16_t Y = vld1q_u8(YRow + X);
+			int16x8_t U, V;
+			LoadChromaNEON(In, X >> 1, OutY >> 1, U, V);
+			//Every chroma sample covers two neighbouring pixels
+			const int16x8x2_t PixelU = vzipq_s16(U, U);
+			const int16x8x2_t PixelV = vzipq_s16(V, V);
+			StorePixelsNEON(OutRow + X * 4, vreinterpretq_s16_u16(vshll_n_u8(vget_low_u8(Y), FixedShift)), PixelU.val[0], PixelV.val[0], bBGRA);
+			StorePixelsNEON(OutRow + X * 4 + 32, vreinterpretq_s16_u16(vshll_n_u8(vget_high_u8(Y), FixedShift)), PixelU.val[1], PixelV.val[1], bBGRA);
+		}
+	}
+	else if (Downsample == 1)
+	{
+		const uint8* YRow0 = In.Y + 2 * OutY * In.YStride;
+		const uint8* YRow1 = YRow0 + In.YStride;
+		for (; X + 8 <= OutWidth; X += 8)
+		{
+			const uint16x8_t Sum = vaddq_u16(vpaddlq_u8(vld1q_u8(YRow0 + 2 * X)), vpaddlq_u8(vld1q_u8(YRow1 + 2 * X)));
+			int16x8_t U, V;
+			LoadChromaNEON(In, X, OutY, U, V);
+			StorePixelsNEON(OutRow + X * 4, vreinterpretq_s16_u16(vshlq_n_u16(Sum, FixedShift - 2)), U, V, bBGRA);
+		}
+	}
+	return X;
+}
+
+//Returns the number of pixels of the row it downsampled, the scalar path does the rest
+static int32 DownsampleLumaRowNEON(const uint8* Row0, const uint8* Row1, uint8* OutRow, int32 OutWidth)
+{
+	int32 X = 0;
+	for (; X + 8 <= OutWidth; X += 8)
+	{
+		const uint16x8_t Sum = vaddq_u16(vpaddlq_u8(vld1q_u8(Row0 + 2 * X)), vpaddlq_u8(vld1q_u8(Row1 + 2 * X)));
+		//Rounding narrow, (Sum + 2) >> 2
+		vst1_u8(OutRow + X, vrshrn_n_u16(Sum, 2));
+	}
+	return X;
+}
+
+//Returns the number of pixels of the row it remapped, the scalar path does the rest
+static int32 RemapLumaRowNEON(const FRemapEntry* Row, const uint8* In, int32 Stride, uint8* OutRow, int32 Width)
+{
+	int32 X = 0;
+	for (; X + 8 <= Width; X += 8)
+	{
+		//The blocks are gathered pixel by pixel, the interpolation is done for all eight at once
+		uint8 TopLeft[8], TopRight[8], BottomLeft[8], BottomRight[8], FracX[8], FracY[8];
+		for (int32 i = 0; i < 8; ++i)
+		{
+			const FRemapEntry& Entry = Row[X + i];
+			if (Entry.FracX == InvalidFrac)
+			{
+				TopLeft[i] = TopRight[i] = BottomLeft[i] = BottomRight[i] = FracX[i] = FracY[i] = 0;
+				continue;
+			}
+			const uint8* Block = In + Entry.Y * Stride + Entry.X;
+			TopLeft[i] = Block[0];
+			TopRight[i] = Block[1];
+			BottomLeft[i] = Block[Stride];
+			BottomRight[i] = Block[Stride + 1];
+			FracX[i] = Entry.FracX;
+			FracY[i] = Entry.FracY;
+		}
+		const uint8x8_t WeightX = vld1_u8(FracX);
+		const uint8x8_t InvWeightX = vsub_u8(vdup_n_u8(FracOne), WeightX);
+		const uint16x8_t Top = vmlal_u8(vmull_u8(vld1_u8(TopLeft), InvWeightX), vld1_u8(TopRight), WeightX);
+		const uint16x8_t Bottom = vmlal_u8(vmull_u8(vld1_u8(BottomLeft), InvWeightX), vld1_u8(BottomRight), WeightX);
+		const uint16x8_t WeightY = vmovl_u8(vld1_u8(FracY));
+		const uint16x8_t InvWeightY = vsubq_u16(vdupq_n_u16(FracOne), WeightY);
+		const uint32x4_t Low = vmlal_u16(vmull_u16(vget_low_u16(Top), vget_low_u16(InvWeightY)), vget_low_u16(Bottom), vget_low_u16(WeightY));
+		const uint32x4_t High = vmlal_u16(vmull_u16(vget_high_u16(Top), vget_high_u16(InvWeightY)), vget_high_u16(Bottom), vget_high_u16(WeightY));
+		vst1_u8(OutRow + X, vmovn_u16(vcombine_u16(vrshrn_n_u32(Low, 2 * FracBits), vrshrn_n_u32(High, 2 * FracBits))));
+	}
+	return X;
+}
+
+//Interpolates the four channels of a pixel at once
+static void RemapRGBARowNEON(const FRemapEntry* Row, const uint8* In, int32 Stride, uint8* OutRow, int32 Width)
+{
+	for (int32 X = 0; X < Width; ++X)
+	{
+		const FRemapEntry& Entry = Row[X];
+		uint32_t* Out = reinterpret_cast<uint32_t*>(OutRow + X * 4);
+		if (Entry.FracX == InvalidFrac)
+		{
+			*Out = 0;
+			continue;
+		}
+		const uint8* Block = In + Entry.Y * Stride + Entry.X * 4;
+		//The left pixel of the block is weighted by the first four lanes, the right one by the last four
+		const uint8x8_t WeightX = vreinterpret_u8_u32(vset_lane_u32(Entry.FracX * 0x01010101u, vreinterpret_u32_u8(vdup_n_u8(FracOne - Entry.FracX)), 1));
+		const uint16x8_t TopPair = vmull_u8(vld1_u8(Block), WeightX);
+		const uint16x8_t BottomPair = vmull_u8(vld1_u8(Block + Stride), WeightX);
+		const uint16x4_t Top = vadd_u16(vget_low_u16(TopPair), vget_high_u16(TopPair));
+		const uint16x4_t Bottom = vadd_u16(vget_low_u16(BottomPair), vget_high_u16(BottomPair));
+		const uint32x4_t Mixed = vmlal_u16(vmull_u16(Top, vdup_n_u16(FracOne - Entry.FracY)), Bottom, vdup_n_u16(Entry.FracY));
+		const uint16x4_t Narrow = vrshrn_n_u32(Mixed, 2 * FracBits);
+		vst1_lane_u32(Out, vreinterpret_u32_u8(vmovn_u16(vcombine_u16(Narrow, Narrow))), 0);
+	}
+}
+
+#elif TANGO_IMAGE_KERNEL_SSE
+
+//Eight chroma samples from X on, centred on 0
+static FORCEINLINE void LoadChromaSSE(const FYUVImage& In, int32 X, int32 Y, __m128i& OutU, __m128i& OutV)
+{
+	const __m128i Bias = _mm_set1_epi16(128);
+	if (IsInterleaved(In))
+	{
+		const __m128i VU = _mm_loadu_si128(reinterpret_cast<const __m128i*>(In.V + Y * In.ChromaStride + X * 2));
+		OutV = _mm_sub_epi16(_mm_and_si128(VU, _mm_set1_epi16(0xFF)), Bias);
+		OutU = _mm_sub_epi16(_mm_srli_epi16(VU, 8), Bias);
+	}
+	else
+	{
+		const __m128i Zero = _mm_setzero_si128();
+		OutV = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(In.V + Y * In.ChromaStride + X)), Zero), Bias);
+		OutU = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(In.U + Y * In.ChromaStride + X)), Zero), Bias);
+	}
+}
+
+static FORCEINLINE __m128i PackChannelSSE(__m128i Low, __m128i High)
+{
+	const __m128i Round = _mm_set1_epi16(1 << (FixedShift - 1));
+	return _mm_packus_epi16(_mm_srai_epi16(_mm_add_epi16(Low, Round), FixedShift), _mm_srai_epi16(_mm_add_epi16(High, Round), FixedShift));
+}
+
+//Writes sixteen pixels with per pixel luma and chroma, given as two halves of eight
+static FORCEINLINE void StorePixelsSSE(uint8* Out, const __m128i Y64[2], const __m128i U[2], const __m128i V[2], bool bBGRA)
+{
+	const __m128i RV = _mm_set1_epi16(CoeffRV);
+	const __m128i GU = _mm_set1_epi16(CoeffGU);
+	const __m128i GV = _mm_set1_epi16(CoeffGV);
+	const __m128i BU = _mm_set1_epi16(CoeffBU);
+	__m128i R[2], G[2], B[2];
+	for (int32 i = 0; i < 2; ++i)
+	{
+		R[i] = _mm_add_epi16(Y64[i], _mm_mullo_epi16(V[i], RV));
+		G[i] = _mm_sub_epi16(_mm_sub_epi16(Y64[i], _mm_mullo_epi16(U[i], GU)), _mm_mullo_epi16(V[i], GV));
+		B[i] = _mm_add_epi16(Y64[i], _mm_mullo_epi16(U[i], BU));
+	}
+	const __m128i Red = PackChannelSSE(R[0], R[1]);
+	const __m128i Blue = PackChannelSSE(B[0], B[1]);
+	const __m128i First = bBGRA ? Blue : Red;
+	const __m128i Third = bBGRA ? Red : Blue;
+	const __m128i Green = PackChannelSSE(G[0], G[1]);
+	const __m128i Alpha = _mm_set1_epi8(-1);
+
+	const __m128i FirstGreenLow = _mm_unpacklo_epi8(First, Green);
+	const __m128i FirstGreenHigh = _mm_unpackhi_epi8(First, Green);
+	const __m128i ThirdAlphaLow = _mm_unpacklo_epi8(Third, Alpha);
+	const __m128i ThirdAlphaHigh = _mm_unpackhi_epi8(Third, Alpha);
+	__m128i* Dest = reinterpret_cast<__m128i*>(Out);
+	_mm_storeu_si128(Dest, _mm_unpacklo_epi16(FirstGreenLow, ThirdAlphaLow));
+	_mm_storeu_si128(Dest + 1, _mm_unpackhi_epi16(FirstGreenLow, ThirdAlphaLow));
+	_mm_storeu_si128(Dest + 2, _mm_unpacklo_epi16(FirstGreenHigh, ThirdAlphaHigh));
+	_mm_storeu_si128(Dest + 3, _mm_unpackhi_epi16(FirstGreenHigh, ThirdAlphaHigh));
+}
+
+//Sums of neighbouring byte pairs as eight 16 bit values
+static FORCEINLINE __m128i SumPairsSSE(__m128i Bytes)
+{
+	return _mm_add_epi16(_mm_and_si128(Bytes, _mm_set1_epi16(0xFF)), _mm_srli_epi16(Bytes, 8));
+}
+
+//Returns the number of pixels of the row it converted, the scalar path does the rest
+static int32 ConvertRowSSE(const FYUVImage& In, uint8* OutRow, int32 OutY, int32 OutWidth, bool bBGRA, int32 Downsample)
+{
+	const __m128i Zero = _mm_setzero_si128();
+	int32 X = 0;
+	if (Downsample == 0)
+	{
+		const uint8* YRow = In.Y + OutY * In.YStride;
+		for (; X + 16 <= OutWidth; X += 16)
+		{
+			const __m128i Y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(YRow + X));
+			const __m128i Y64[2] = { _mm_slli_epi16(_mm_unpacklo_epi8(Y, Zero), FixedShift), _mm_slli_epi16(_mm_unpackhi_epi8(Y, Zero), FixedShift) };
+			__m128i U, V;
+			LoadChromaSSE(In, X >> 1, OutY >> 1, U, V);
+			//Every chroma sample covers two neighbouring pixels
+			const __m128i PixelU[2] = { _mm_unpacklo_epi16(U, U), _mm_unpackhi_epi16(U, U) };
+			const __m128i PixelV[2] = { _mm_unpacklo_epi16(V, V), _mm_unpackhi_epi16(V, V) };
+			StorePixelsSSE(OutRow + X * 4, Y64, PixelU, PixelV, bBGRA);
+		}
+	}
+	else if (Downsample == 1)
+	{
+		const uint8* YRow0 = In.Y + 2 * OutY * In.YStride;
+		const uint8* YRow1 = YRow0 + In.YStride;
+		for (; X + 16 <= OutWidth; X += 16)
+		{
+			__m128i Y64[2], U[2], V[2];
+			for (int32 i = 0; i < 2; ++i)
+			{
+				const int32 Offset = 2 * X + i * 16;
+				const __m128i Sum = _mm_add_epi16(
+					SumPairsSSE(_mm_loadu_si128(reinterpret_cast<const __m128i*>(YRow0 + Offset))),
+					SumPairsSSE(_mm_loadu_si128(reinterpret_cast<const __m128i*>(YRow1 + Offset))));
+				Y64[i] = _mm_slli_epi16(Sum, FixedShift - 2);
+				LoadChromaSSE(In, X + i * 8, OutY, U[i], V[i]);
+			}
+			StorePixelsSSE(OutRow + X * 4, Y64, U, V, bBGRA);
+		}
+	}
+	return X;
+}
+
+//Returns the number of pixels of the row it downsampled, the scalar path does the rest
+static int32 DownsampleLumaRowSSE(const uint8* Row0, const uint8* Row1, uint8* OutRow, int32 OutWidth)
+{
+	const __m128i Two = _mm_set1_epi16(2);
+	int32 X = 0;
+	for (; X + 16 <= OutWidth; X += 16)
+	{
+		__m128i Half[2];
+		for (int32 i = 0; i < 2; ++i)
+		{
+			const int32 Offset = 2 * X + i * 16;
+			const __m128i Sum = _mm_add_epi16(
+				SumPairsSSE(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Row0 + Offset))),
+				SumPairsSSE(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Row1 + Offset))));
+			Half[i] = _mm_srli_epi16(_mm_add_epi16(Sum, Two), 2);
+		}
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(OutRow + X), _mm_packus_epi16(Half[0], Half[1]));
+	}
+	return X;
+}
+
+//Returns the number of pixels of the row it remapped, the scalar path does the rest
+static int32 RemapLumaRowSSE(const FRemapEntry* Row, const uint8* In, int32 Stride, uint8* OutRow, int32 Width)
+{
+	const __m128i One = _mm_set1_epi16(FracOne);
+	const __m128i Round = _mm_set1_epi32(1 << (2 * FracBits - 1));
+	int32 X = 0;
+	for (; X + 8 <= Width; X += 8)
+	{
+		//The blocks are gathered pixel by pixel, the interpolation is done for all eight at once
+		uint16 TopLeft[8], TopRight[8], BottomLeft[8], BottomRight[8], FracX[8], FracY[8];
+		for (int32 i = 0; i < 8; ++i)
+		{
+			const FRemapEntry& Entry = Row[X + i];
+			if (Entry.FracX == InvalidFrac)
+			{
+				TopLeft[i] = TopRight[i] = BottomLeft[i] = BottomRight[i] = FracX[i] = FracY[i] = 0;
+				continue;
+			}
+			const uint8* Block = In + Entry.Y * Stride + Entry.X;
+			TopLeft[i] = Block[0];
+			TopRight[i] = Block[1];
+			BottomLeft[i] = Block[Stride];
+			BottomRight[i] = Block[Stride + 1];
+			FracX[i] = Entry.FracX;
+			FracY[i] = Entry.FracY;
+		}
+		const __m128i WeightX = _mm_loadu_si128(reinterpret_cast<const __m128i*>(FracX));
+		const __m128i InvWeightX = _mm_sub_epi16(One, WeightX);
+		//At most 255 * 128, so the sums fit the signed 16 bit lanes _mm_madd_epi16 takes
+		const __m128i Top = _mm_add_epi16(
+			_mm_mullo_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(TopLeft)), InvWeightX),
+			_mm_mullo_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(TopRight)), WeightX));
+		const __m128i Bottom = _mm_add_epi16(
+			_mm_mullo_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(BottomLeft)), InvWeightX),
+			_mm_mullo_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(BottomRight)), WeightX));
+		const __m128i WeightY = _mm_loadu_si128(reinterpret_cast<const __m128i*>(FracY));
+		const __m128i InvWeightY = _mm_sub_epi16(One, WeightY);
+		const __m128i Low = _mm_madd_epi16(_mm_unpacklo_epi16(Top, Bottom), _mm_unpacklo_epi16(InvWeightY, WeightY));
+		const __m128i High = _mm_madd_epi16(_mm_unpackhi_epi16(Top, Bottom), _mm_unpackhi_epi16(InvWeightY, WeightY));
+		const __m128i Result = _mm_packs_epi32(_mm_srai_epi32(_mm_add_epi32(Low, Round), 2 * FracBits), _mm_srai_epi32(_mm_add_epi32(High, Round), 2 * FracBits));
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(OutRow + X), _mm_packus_epi16(Result, Result));
+	}
+	return X;
+}
+
+//Interpolates the four channels of a pixel at once
+static void RemapRGBARowSSE(const FRemapEntry* Row, const uint8* In, int32 Stride, uint8* OutRow, int32 Width)
+{
+	const __m128i Zero = _mm_setzero_si128();
+	const __m128i Round = _mm_set1_epi32(1 << (2 * FracBits - 1));
+	for (int32 X = 0; X < Width; ++X)
+	{
+		const FRemapEntry& Entry = Row[X];
+		int32* Out = reinterpret_cast<int32*>(OutRow + X * 4);
+		if (Entry.FracX == InvalidFrac)
+		{
+			*Out = 0;
+			continue;
+		}
+		const uint8* Block = In + Entry.Y * Stride + Entry.X * 4;
+		//The left pixel of the block is weighted by the first four lanes, the right one by the last four
+		const int16 FracX = Entry.FracX;
+		const int16 InvFracX = FracOne - Entry.FracX;
+		const __m128i WeightX = _mm_set_epi16(FracX, FracX, FracX, FracX, InvFracX, InvFracX, InvFracX, InvFracX);
+		const __m128i TopPair = _mm_mullo_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(Block)), Zero), WeightX);
+		const __m128i BottomPair = _mm_mullo_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(Block + Stride)), Zero), WeightX);
+		const __m128i Top = _mm_add_epi16(TopPair, _mm_srli_si128(TopPair, 8));
+		const __m128i Bottom = _mm_add_epi16(BottomPair, _mm_srli_si128(BottomPair, 8));
+		const __m128i WeightY = _mm_set1_epi32((Entry.FracY << 16) | (FracOne - Entry.FracY));
+		const __m128i Mixed = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(Top, Bottom), WeightY), Round), 2 * FracBits);
+		const __m128i Packed = _mm_packs_epi32(Mixed, Mixed);
+		*Out = _mm_cvtsi128_si32(_mm_packus_epi16(Packed, Packed));
+	}
+}
+
+#endif
+
+void TangoImageKernels::ConvertToRGBA(const FYUVImage& In, uint8* Out, bool bBGRA, int32 Downsample)
+{
+	const int32 OutWidth = GetOutputSize(In.Width, Downsample);
+	const int32 OutHeight = GetOutputSize(In.Height, Downsample);
+	for (int32 OutY = 0; OutY < OutHeight; ++OutY)
+	{
+		uint8* OutRow = Out + OutY * OutWidth * 4;
+		//Quarter resolution is a sixteenth of the work, it stays on the scalar path
+#if TANGO_IMAGE_KERNEL_NEON
+		const int32 Done = ConvertRowNEON(In, OutRow, OutY, OutWidth, bBGRA, Downsample);
+#elif TANGO_IMAGE_KERNEL_SSE
+		const int32 Done = ConvertRowSSE(In, OutRow, OutY, OutWidth, bBGRA, Downsample);
+#else
+		const int32 Done = 0;
+#endif
+		ConvertPixelsScalar(In, OutRow, OutY, Done, OutWidth, bBGRA, Downsample);
+	}
+}
+
+void TangoImageKernels::DownsampleLuma(const uint8* In, int32 Width, int32 Height, int32 Stride, uint8* Out, int32 OutStride)
+{
+	const int32 OutWidth = Width / 2;
+	for (int32 OutY = 0; OutY < Height / 2; ++OutY)
+	{
+		const uint8* Row0 = In + 2 * OutY * Stride;
+		const uint8* Row1 = Row0 + Stride;
+		uint8* OutRow = Out + OutY * OutStride;
+#if TANGO_IMAGE_KERNEL_NEON
+		const int32 Done = DownsampleLumaRowNEON(Row0, Row1, OutRow, OutWidth);
+#elif TANGO_IMAGE_KERNEL_SSE
+		const int32 Done = DownsampleLumaRowSSE(Row0, Row1, OutRow, OutWidth);
+#else
+		const int32 Done = 0;
+#endif
+		DownsampleLumaPixelsScalar(Row0, Row1, OutRow, Done, OutWidth);
+	}
+}
+
+void TangoImageKernels::RemapLuma(const FRemapEntry* Table, int32 Width, int32 Height, const uint8* In, int32 Stride, uint8* Out, int32 OutStride)
+{
+	for (int32 Y = 0; Y < Height; ++Y)
+	{
+		const FRemapEntry* Row = Table + Y * Width;
+		uint8* OutRow = Out + Y * OutStride;
+#if TANGO_IMAGE_KERNEL_NEON
+		const int32 Done = RemapLumaRowNEON(Row, In, Stride, OutRow, Width);
+#elif TANGO_IMAGE_KERNEL_SSE
+		const int32 Done = RemapLumaRowSSE(Row, In, Stride, OutRow, Width);
+#else
+		const int32 Done = 0;
+#endif
+		RemapPixelsScalar(Row, In, Stride, OutRow, Done, Width, 1);
+	}
+}
+
+void TangoImageKernels::RemapRGBA(const FRemapEntry* Table, int32 Width, int32 Height, const uint8* In, int32 Stride, uint8* Out, int32 OutStride)
+{
+	for (int32 Y = 0; Y < Height; ++Y)
+	{
+		const FRemapEntry* Row = Table + Y * Width;
+		uint8* OutRow = Out + Y * OutStride;
+#if TANGO_IMAGE_KERNEL_NEON
+		RemapRGBARowNEON(Row, In, Stride, OutRow, Width);
+#elif TANGO_IMAGE_KERNEL_SSE
+		RemapRGBARowSSE(Row, In, Stride, OutRow, Width);
+#else
+		RemapPixelsScalar(Row, In, Stride, OutRow, 0, Width, 4);
+#endif
+	}
+}
+
+const TCHAR* TangoImageKernels::GetPathName()
+{
+#if TANGO_IMAGE_KERNEL_NEON
+	return TEXT("NEON");
+#elif TANGO_IMAGE_KERNEL_SSE
+	return TEXT("SSE");
+#else
+	return TEXT("Scalar");
+#endif
+}
+
+#if !UE_BUILD_SHIPPING
+
+//Checks the vector path against the scalar reference on synthetic NV21 and YV12 images and times both
+static void BenchmarkImageKernels(const TArray<FString>& Args)
+{
+	const int32 Width = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]) & ~3, 4) : 1920;
+	const int32 Height = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]) & ~3, 4) : 1080;
+	const int32 Iterations = 20;
+
+	FRandomStream Random(1234);
+	TArray<uint8> Planes;
+	Planes.SetNumUninitialized(Width * Height * 3 / 2);
+	for (uint8& Value : Planes)
+	{
+		Value = (uint8)Random.RandRange(0, 255);
+	}
+	TArray<uint8> Reference;
+	TArray<uint8> Result;
+	Reference.SetNumUninitialized(Width * Height * 4);
+	Result.SetNumUninitialized(Width * Height * 4);
+
+	for (int32 Layout = 0; Layout < 2; ++Layout)
+	{
+		FYUVImage In;
+		In.Y = Planes.GetData();
+		In.V = In.Y + Width * Height;
+		In.Width = Width;
+		In.Height = Height;
+		In.YStride = Width;
+		if (Layout == 0)
+		{
+			In.Format = ETangoImageFormat::TANGO_HAL_PIXEL_FORMAT_YCrCb_420_SP;
+			In.U = nullptr;
+			In.ChromaStride = Width;
+		}
+		else
+		{
+			In.Format = ETangoImageFormat::TANGO_HAL_PIXEL_FORMAT_YV12;
+			In.U = In.V + Width * Height / 4;
+			In.ChromaStride = Width / 2;
+		}
+		for (int32 Downsample = 0; Downsample < 3; ++Downsample)
+		{
+			const int32 NumBytes = TangoImageKernels::GetOutputSize(Width, Downsample) * TangoImageKernels::GetOutputSize(Height, Downsample) * 4;
+			double Start = FPlatformTime::Seconds();
+			for (int32 i = 0; i < Iterations; ++i)
+			{
+				TangoImageKernels::ConvertToRGBAScalar(In, Reference.GetData(), (i & 1) != 0, Downsample);
+			}
+			const double ScalarMs = (FPlatformTime::Seconds() - Start) * 1000.0 / Iterations;
+
+			Start = FPlatformTime::Seconds();
+			for (int32 i = 0; i < Iterations; ++i)
+			{
+				TangoImageKernels::ConvertToRGBA(In, Result.GetData(), (i & 1) != 0, Downsample);
+			}
+			const double VectorMs = (FPlatformTime::Seconds() - Start) * 1000.0 / Iterations;
+
+			const bool bMatches = FMemory::Memcmp(Reference.GetData(), Result.GetData(), NumBytes) == 0;
+			UE_LOG(TangoPlugin, Log, TEXT("TangoImageKernels: %s %dx%d downsampled %d times, scalar %.3f ms, %s %.3f ms"),
+				Layout == 0 ? TEXT("NV21") : TEXT("YV12"), Width, Height, Downsample, ScalarMs, TangoImageKernels::GetPathName(), VectorMs);
+			if (!bMatches)
+			{
+				UE_LOG(TangoPlugin, Error, TEXT("TangoImageKernels: %s path does not match the scalar reference"), TangoImageKernels::GetPathName());
+			}
+		}
+	}
+
+	//Halving the luma plane, as done for every level of the camera image pyramid
+	const int32 NumBytes = (Width / 2) * (Height / 2);
+	double Start = FPlatformTime::Seconds();
+	for (int32 i = 0; i < Iterations; ++i)
+	{
+		TangoImageKernels::DownsampleLumaScalar(Planes.GetData(), Width, Height, Width, Reference.GetData(), Width / 2);
+	}
+	const double ScalarMs = (FPlatformTime::Seconds() - Start) * 1000.0 / Iterations;
+	Start = FPlatformTime::Seconds();
+	for (int32 i = 0; i < Iterations; ++i)
+	{
+		TangoImageKernels::DownsampleLuma(Planes.GetData(), Width, Height, Width, Result.GetData(), Width / 2);
+	}
+	const double VectorMs = (FPlatformTime::Seconds() - Start) * 1000.0 / Iterations;
+	UE_LOG(TangoPlugin, Log, TEXT("TangoImageKernels: luma %dx%d halved, scalar %.3f ms, %s %.3f ms"), Width, Height, ScalarMs, TangoImageKernels::GetPathName(), VectorMs);
+	if (FMemory::Memcmp(Reference.GetData(), Result.GetData(), NumBytes) != 0)
+	{
+		UE_LOG(TangoPlugin, Error, TEXT("TangoImageKernels: %s luma downsampling does not match the scalar reference"), TangoImageKernels::GetPathName());
+	}
+
+	//Remapping through a table of random positions, with some pixels outside the input, as an undistortion table has at the corners
+	const int32 RemapWidth = Width / 2;
+	const int32 RemapHeight = Height / 2;
+	TArray<FRemapEntry> Table;
+	Table.SetNumUninitialized(RemapWidth * RemapHeight);
+	for (FRemapEntry& Entry : Table)
+	{
+		Entry.X = (int16)Random.RandRange(0, RemapWidth - 2);
+		Entry.Y = (int16)Random.RandRange(0, RemapHeight - 2);
+		Entry.FracX = Random.RandRange(0, 20) == 0 ? (uint8)TangoImageKernels::InvalidRemapFrac : (uint8)Random.RandRange(0, TangoImageKernels::RemapFracOne - 1);
+		Entry.FracY = (uint8)Random.RandRange(0, TangoImageKernels::RemapFracOne - 1);
+	}
+	for (int32 NumChannels = 1; NumChannels <= 4; NumChannels += 3)
+	{
+		const int32 Stride = RemapWidth * NumChannels;
+		Start = FPlatformTime::Seconds();
+		for (int32 i = 0; i < Iterations; ++i)
+		{
+			if (NumChannels == 1)
+			{
+				TangoImageKernels::RemapLumaScalar(Table.GetData(), RemapWidth, RemapHeight, Planes.GetData(), Stride, Reference.GetData(), Stride);
+			}
+			else
+			{
+				TangoImageKernels::RemapRGBAScalar(Table.GetData(), RemapWidth, RemapHeight, Planes.GetData(), Stride, Reference.GetData(), Stride);
+			}
+		}
+		const double RemapScalarMs = (FPlatformTime::Seconds() - Start) * 1000.0 / Iterations;
+		Start = FPlatformTime::Seconds();
+		for (int32 i = 0; i < Iterations; ++i)
+		{
+			if (NumChannels == 1)
+			{
+				TangoImageKernels::RemapLuma(Table.GetData(), RemapWidth, RemapHeight, Planes.GetData(), Stride, Result.GetData(), Stride);
+			}
+			else
+			{
+				TangoImageKernels::RemapRGBA(Table.GetData(), RemapWidth, RemapHeight, Planes.GetData(), Stride, Result.GetData(), Stride);
+			}
+		}
+		const double RemapVectorMs = (FPlatformTime::Seconds() - Start) * 1000.0 / Iterations;
+		UE_LOG(TangoPlugin, Log, TEXT("TangoImageKernels: %s %dx%d remapped, scalar %.3f ms, %s %.3f ms"),
+			NumChannels == 1 ? TEXT("luma") : TEXT("RGBA"), RemapWidth, RemapHeight, RemapScalarMs, TangoImageKernels::GetPathName(), RemapVectorMs);
+		if (FMemory::Memcmp(Reference.GetData(), Result.GetData(), Stride * RemapHeight) != 0)
+		{
+			UE_LOG(TangoPlugin, Error, TEXT("TangoImageKernels: %s remap does not match the scalar reference"), TangoImageKernels::GetPathName());
+		}
+	}
+}
+
+static FAutoConsoleCommand TangoImageBenchmarkCommand(
+	TEXT("Tango.Camera.Benchmark"),
+	TEXT("Checks the camera image conversion, luma downsampling and remap kernels against the scalar reference and times both. Optional arguments: width and height."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkImageKernels));
+
+#endif
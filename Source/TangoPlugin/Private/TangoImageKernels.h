@@ -0,0 +1,89 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+
+#pragma once
+
+#include "TangoDataTypes.h"
+
+/**
+ * Colour conversion of whole camera images from the 4:2:0 YUV layouts the Tango camera delivers to 8 bit RGBA or BGRA.
+ * Uses the full range BT.601 matrix of the Android camera in 6 bit fixed point, so every path gives the same bytes.
+ * Also halves luma planes for the camera image pyramid, and remaps images through a table for undistortion.
+ */
+class TangoImageKernels
+{
+public:
+	/** One YUV image as laid out by the camera, the planes are only read. */
+	struct FYUVImage
+	{
+		const uint8* Y;
+		//NV21 (YCrCb_420_SP): the interleaved VU plane. YV12: the V plane.
+		const uint8* V;
+		//YV12 only: the U plane
+		const uint8* U;
+		int32 Width;
+		int32 Height;
+		int32 YStride;
+		int32 ChromaStride;
+		ETangoImageFormat Format;
+	};
+
+	enum { RemapFracBits = 7, RemapFracOne = 1 << RemapFracBits, InvalidRemapFrac = 255 };
+
+	/** Where one output pixel of a remap samples the input: the top left pixel of a 2x2 block and the weights of its right and lower neighbours. */
+	struct FRemapEntry
+	{
+		int16 X;
+		int16 Y;
+		//In 1 / RemapFracOne pixels. InvalidRemapFrac marks pixels sampling outside the input, which are written as zero.
+		uint8 FracX;
+		uint8 FracY;
+	};
+
+	/** Whether Format is a layout the kernels can read. */
+	static bool IsSupportedFormat(ETangoImageFormat Format);
+
+	/** Output size for 1 << Downsample times fewer pixels along each side, Downsample being 0, 1 or 2. */
+	static int32 GetOutputSize(int32 Size, int32 Downsample) { return Size >> Downsample; }
+
+	/**
+	 * Converts In into packed 4 byte pixels using the fastest path available on this platform.
+	 * Downsample 1 and 2 average 2x2 and 4x4 blocks, Out must hold GetOutputSize(Width) * GetOutputSize(Height) pixels.
+	 */
+	static void ConvertToRGBA(const FYUVImage& In, uint8* Out, bool bBGRA, int32 Downsample);
+	/** Reference implementation the vector paths are checked against. */
+	static void ConvertToRGBAScalar(const FYUVImage& In, uint8* Out, bool bBGRA, int32 Downsample);
+
+	/**
+	 * Halves a luma plane along each side by averaging 2x2 blocks, rounding to nearest. An odd last row or column is dropped.
+	 * Out must hold Height / 2 rows of OutStride bytes.
+	 */
+	static void DownsampleLuma(const uint8* In, int32 Width, int32 Height, int32 Stride, uint8* Out, int32 OutStride);
+	/** Reference implementation the vector paths are checked against. */
+	static void DownsampleLumaScalar(const uint8* In, int32 Width, int32 Height, int32 Stride, uint8* Out, int32 OutStride);
+
+	/**
+	 * Bilinearly samples a luma plane at the positions of Table, one entry per output pixel of Width x Height in row order.
+	 * The 2x2 block of every valid entry must lie inside In.
+	 */
+	static void RemapLuma(const FRemapEntry* Table, int32 Width, int32 Height, const uint8* In, int32 Stride, uint8* Out, int32 OutStride);
+	static void RemapLumaScalar(const FRemapEntry* Table, int32 Width, int32 Height, const uint8* In, int32 Stride, uint8* Out, int32 OutStride);
+	/** Same as RemapLuma for packed 4 byte pixels, all four channels interpolated. Strides are in bytes. */
+	static void RemapRGBA(const FRemapEntry* Table, int32 Width, int32 Height, const uint8* In, int32 Stride, uint8* Out, int32 OutStride);
+	static void RemapRGBAScalar(const FRemapEntry* Table, int32 Width, int32 Height, const uint8* In, int32 Stride, uint8* Out, int32 OutStride);
+
+	/** Name of the path ConvertToRGBA, DownsampleLuma and the remaps use, for logging. */
+	static const TCHAR* GetPathName();
+};
@@ -52,7 +52,6 @@ UTangoMeshReconstructionComponent::UTangoMeshReconstructionComponent() :
 	t3dr_context_ = nullptr;
 	Thread1 = nullptr;
 	Thread2 = nullptr;
-	ImageBufferManager = nullptr;
 #endif
 	// ...
 }
@@ -139,7 +138,7 @@ void UTangoMeshReconstructionComponent::BeginPlay2()
 	Thread2 = FRunnableThread::Create(new MeshGenerator(this), TEXT("MeshGenerator"));
 	if (!ImageListener.IsValid())
 	{
-		ImageListener = UTangoDevice::Get().GetTangoDeviceImagePointer()->OnImageBufferAvailable.AddUObject(this, &UTangoMeshReconstructionComponent::OnImageBufferAvailable);
+		ImageListener = UTangoImageComponent::AddCameraImageListener(FOnTangoCameraImageAvailable::CreateUObject(this, &UTangoMeshReconstructionComponent::OnCameraImageAvailable));
 	}
 #endif
 }
@@ -162,10 +161,7 @@ void UTangoMeshReconstructionComponent::ReleaseResources()
 
 	if (ImageListener.IsValid())
 	{
-		if (UTangoDevice::Get().GetTangoDeviceImagePointer() != nullptr)
-		{
-			UTangoDevice::Get().GetTangoDeviceImagePointer()->OnImageBufferAvailable.Remove(ImageListener);
-		}
+		UTangoImageComponent::RemoveCameraImageListener(ImageListener);
 		ImageListener.Reset();
 	}
 	if (t3dr_config_ != nullptr)
@@ -173,11 +169,9 @@ void UTangoMeshReconstructionComponent::ReleaseResources()
 		Tango3DR_Config_destroy(t3dr_config_);
 		t3dr_config_ = nullptr;
 	}
-	if (ImageBufferManager != nullptr)
 	{
-		TangoSupportImageBufferManager* Tmp = ImageBufferManager;
-		ImageBufferManager = nullptr;
-		TangoSupport_freeImageBufferManager(Tmp);
+		FScopeLock ScopeLock(&LatestImageMutex);
+		LatestImage.Reset();
 	}
 	SectionAddressMap.Reset();
 	Sections.Reset();
@@ -406,7 +400,7 @@ static void extract3DRPose(const TangoPoseData* data, Tango3DR_Pose* pose)
 	pose->orientation[3] = data->orientation[3];
 }
 
-void UTangoMeshReconstructionComponent::OnImageBufferAvailable(const TangoImageBuffer* buffer)
+void UTangoMeshReconstructionComponent::OnCameraImageAvailable(const FTangoCameraImagePtr& Image)
 {
 	
 	if (!bPlaying) return;
@@ -418,46 +412,25 @@ void UTangoMeshReconstructionComponent::OnImageBufferAvailable(const TangoImageB
 	{
 		return;
 	}
-	if (ImageBufferManager == nullptr)
-	{
-		if (TangoSupport_createImageBufferManager(buffer->format, buffer->width, buffer->height, &ImageBufferManager) != TANGO_SUCCESS)
-		{
-			UE_LOG(TangoPlugin, Error, TEXT("Couldn't create image buffer manager"));
-			return;
-		}
-	}
-	if (TangoSupport_updateImageBuffer(ImageBufferManager, buffer) != TANGO_SUCCESS)
-	{
-		UE_LOG(TangoPlugin, Error, TEXT("updateImageBuffer failed"));
-	}
+	//Only the pointer is kept, the image stays in the camera image pool until RunGen is done with it
+	FScopeLock ScopeLock(&LatestImageMutex);
+	LatestImage = Image;
 }
 
 void UTangoMeshReconstructionComponent::RunGen()
 {
 	while (bPlaying)
 	{
-		if (ImageBufferManager == nullptr)
-		{
-			FGenericPlatformProcess::Sleep(0.25);
-			continue;
-		}
-		bool NewImage = false;
-		TangoImageBuffer* image_buffer;
-		if (TangoSupport_getLatestImageBufferAndNewDataFlag(
-			ImageBufferManager,
-			&image_buffer,
-			&NewImage
-		) != TANGO_SUCCESS)
+		FTangoCameraImagePtr Image;
 		{
-			UE_LOG(TangoPlugin, Error, TEXT("getLatestImageBuffer failed"));
+			FScopeLock ScopeLock(&LatestImageMutex);
+			Image = LatestImage;
+			LatestImage.Reset();
 		}
-		else
+		if (Image.IsValid())
 		{
-			if (NewImage)
-			{
-				ProcessImageBuffer(image_buffer);
-				continue;
-			}
+			ProcessImageBuffer(&Image->Buffer);
+			continue;
 		}
 		FGenericPlatformProcess::Sleep(1.0/60);
 	}
@@ -492,8 +465,9 @@ void UTangoMeshReconstructionComponent::ProcessImageBuffer(const TangoImageBuffe
 	{
 		return;
 	}
-	FScopeLock PointCloudScopeLock(DevicePointCloud->GetPointCloudLock());
-	const TangoPointCloud* _front_cloud = DevicePointCloud->GetLatestPointCloud();
+	//Pinning keeps the depth frame alive without blocking the depth callback while we integrate it
+	TangoPointCloudRing::FPin PointCloudPin = DevicePointCloud->PinPointCloudNearest(buffer->timestamp);
+	const TangoPointCloud* _front_cloud = PointCloudPin.GetTangoPointCloud();
 	if (_front_cloud == nullptr)
 	{
 		return;
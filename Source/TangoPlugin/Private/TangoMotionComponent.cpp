@@ -34,6 +34,18 @@ void UTangoMotionComponent::InitializeComponent()
 	Super::InitializeComponent();
 }
 
+void UTangoMotionComponent::BeginPlay()
+{
+	Super::BeginPlay();
+	UTangoDevice::Get().RegisterTangoMotionComponent(this);
+}
+
+void UTangoMotionComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UTangoDevice::Get().UnregisterTangoMotionComponent(this);
+	Super::EndPlay(EndPlayReason);
+}
+
 void UTangoMotionComponent::BeginDestroy()
 {
 	Super::BeginDestroy();
@@ -50,13 +62,83 @@ FWGS_84_PoseData UTangoMotionComponent::GetWGS_84_PoseAtTime(ETangoCoordinateFra
 }
 
 FTangoPoseData UTangoMotionComponent::GetTangoPoseAtTime(FTangoCoordinateFramePair FrameOfReference, float Timestamp)
+{
+	return GetTangoPoseAtPreciseTime(FrameOfReference, Timestamp);
+}
+
+FTangoPoseData UTangoMotionComponent::GetTangoPoseAtPreciseTime(FTangoCoordinateFramePair FrameOfReference, double Timestamp)
 {
 	return UTangoDevice::Get().GetTangoDeviceMotionPointer() != nullptr ? UTangoDevice::Get().GetTangoDeviceMotionPointer()->GetPoseAtTime(FrameOfReference, Timestamp) : FTangoPoseData();
 }
 
+void UTangoMotionComponent::GetTangoPosesAtTimes(FTangoCoordinateFramePair FrameOfReference, const TArray<float>& Timestamps, TArray<FTangoPoseData>& Poses)
+{
+	TArray<double> PreciseTimestamps;
+	PreciseTimestamps.SetNumUninitialized(Timestamps.Num());
+	for (int32 i = 0; i < Timestamps.Num(); ++i)
+	{
+		PreciseTimestamps[i] = Timestamps[i];
+	}
+	GetPosesAtTimes(FrameOfReference, PreciseTimestamps, Poses);
+}
+
+void UTangoMotionComponent::GetPosesAtTimes(FTangoCoordinateFramePair FrameOfReference, const TArray<double>& Timestamps, TArray<FTangoPoseData>& Poses)
+{
+	if (UTangoDevice::Get().GetTangoDeviceMotionPointer() != nullptr)
+	{
+		UTangoDevice::Get().GetTangoDeviceMotionPointer()->GetPosesAtTimes(FrameOfReference, Timestamps, Poses);
+	}
+	else
+	{
+		Poses.Reset(Timestamps.Num());
+		Poses.SetNum(Timestamps.Num());
+	}
+}
+
+FTangoPoseData UTangoMotionComponent::GetPredictedTangoPose(FTangoCoordinateFramePair FrameOfReference, float LookAhead)
+{
+	FTangoPoseData Pose;
+	Pose.StatusCode = ETangoPoseStatus::INVALID;
+	if (UTangoDevice::Get().GetTangoDeviceMotionPointer() != nullptr && !UTangoDevice::Get().GetTangoDeviceMotionPointer()->PredictPoseAhead(FrameOfReference, LookAhead, Pose))
+	{
+		Pose = FTangoPoseData();
+		Pose.StatusCode = ETangoPoseStatus::INVALID;
+	}
+	return Pose;
+}
+
+FTangoPoseData UTangoMotionComponent::GetTangoPoseAtPredictedTime(FTangoCoordinateFramePair FrameOfReference, double Timestamp)
+{
+	FTangoPoseData Pose;
+	Pose.StatusCode = ETangoPoseStatus::INVALID;
+	if (UTangoDevice::Get().GetTangoDeviceMotionPointer() != nullptr && !UTangoDevice::Get().GetTangoDeviceMotionPointer()->PredictPoseAtTime(FrameOfReference, Timestamp, Pose))
+	{
+		Pose = FTangoPoseData();
+		Pose.StatusCode = ETangoPoseStatus::INVALID;
+	}
+	return Pose;
+}
+
+FTangoPoseData UTangoMotionComponent::GetFilteredTangoPose(FTangoCoordinateFramePair FrameOfReference)
+{
+	FTangoPoseData Pose;
+	Pose.StatusCode = ETangoPoseStatus::INVALID;
+	if (UTangoDevice::Get().GetTangoDeviceMotionPointer() != nullptr && !UTangoDevice::Get().GetTangoDeviceMotionPointer()->GetFilteredPose(FrameOfReference, Pose))
+	{
+		Pose = FTangoPoseData();
+		Pose.StatusCode = ETangoPoseStatus::INVALID;
+	}
+	return Pose;
+}
+
 FTransform UTangoMotionComponent::GetComponentTransformAtTime(float Timestamp)
 {
-	auto Pose = GetTangoPoseAtTime(MotionComponentFrameOfReference, Timestamp);
+	return GetComponentTransformAtPreciseTime(Timestamp);
+}
+
+FTransform UTangoMotionComponent::GetComponentTransformAtPreciseTime(double Timestamp)
+{
+	auto Pose = GetTangoPoseAtPreciseTime(MotionComponentFrameOfReference, Timestamp);
 	return CalcNewComponentToWorld(FTransform(Pose.QuatRotation, Pose.Position, RelativeScale3D));
 }
 
@@ -0,0 +1,122 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+#include "TangoPluginPrivatePCH.h"
+#include "TangoPlaneComponent.h"
+#include "TangoPlaneDetector.h"
+#include "TangoDevice.h"
+
+UTangoPlaneComponent::UTangoPlaneComponent() : Super(),
+	PlaneSpace(ETangoPointSpace::ADF_DEPTH),
+	bUseFilteredPoints(false),
+	DistanceThreshold(2.0f),
+	MinPoints(150),
+	MaxPlanesPerFrame(4),
+	MergeAngle(10.0f),
+	MergeDistance(5.0f),
+	RemoveAfterMissedFrames(10),
+	Detector(nullptr),
+	LastPushedGeneration(0)
+{
+	bWantsInitializeComponent = false;
+	PrimaryComponentTick.bCanEverTick = true;
+}
+
+void UTangoPlaneComponent::BeginPlay()
+{
+	Super::BeginPlay();
+	if (PlaneSpace == ETangoPointSpace::LOCAL)
+	{
+		UE_LOG(TangoPlugin, Warning, TEXT("UTangoPlaneComponent::BeginPlay: Planes cannot be tracked in depth space, using ADF space instead"));
+		PlaneSpace = ETangoPointSpace::ADF_DEPTH;
+	}
+	TangoPlaneDetector::FSettings Settings;
+	Settings.DistanceThreshold = DistanceThreshold;
+	Settings.MinPoints = FMath::Max(MinPoints, 3);
+	Settings.MaxPlanesPerFrame = FMath::Max(MaxPlanesPerFrame, 1);
+	Settings.MergeAngle = MergeAngle;
+	Settings.MergeDistance = MergeDistance;
+	Settings.RemoveAfterMissedFrames = FMath::Max(RemoveAfterMissedFrames, 1);
+	Settings.MetersToWorldScale = UTangoDevice::Get().GetMetersToWorldScale();
+	Detector = new TangoPlaneDetector(Settings);
+	TangoDevicePointCloud::AddStreamRequest(PlaneSpace, bUseFilteredPoints);
+}
+
+void UTangoPlaneComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (Detector != nullptr)
+	{
+		TangoDevicePointCloud::RemoveStreamRequest(PlaneSpace, bUseFilteredPoints);
+		delete Detector;
+		Detector = nullptr;
+	}
+	Planes.Reset();
+	Super::EndPlay(EndPlayReason);
+}
+
+void UTangoPlaneComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	if (Detector == nullptr)
+	{
+		return;
+	}
+	if (UTangoDevice::Get().GetTangoDevicePointCloudPointer() != nullptr)
+	{
+		FTangoPointCloudFramePtr Frame = UTangoDevice::Get().GetTangoDevicePointCloudPointer()->GetLatestFrame(PlaneSpace, bUseFilteredPoints);
+		if (Frame.IsValid() && Frame->Generation != LastPushedGeneration)
+		{
+			LastPushedGeneration = Frame->Generation;
+			Detector->PushFrame(Frame);
+		}
+	}
+
+	TArray<TangoPlaneDetector::FPlaneEvent> Events;
+	Detector->PopEvents(Events);
+	for (const TangoPlaneDetector::FPlaneEvent& Event : Events)
+	{
+		switch (Event.Type)
+		{
+		case TangoPlaneDetector::EPlaneEventType::Added:
+			Planes.Add(Event.Plane.ID, Event.Plane);
+			OnPlaneAdded.Broadcast(Event.Plane);
+			break;
+		case TangoPlaneDetector::EPlaneEventType::Updated:
+			Planes.Add(Event.Plane.ID, Event.Plane);
+			OnPlaneUpdated.Broadcast(Event.Plane);
+			break;
+		case TangoPlaneDetector::EPlaneEventType::Removed:
+			Planes.Remove(Event.Plane.ID);
+			OnPlaneRemoved.Broadcast(Event.Plane);
+			break;
+		}
+	}
+}
+
+TArray<FTangoPlane> UTangoPlaneComponent::GetPlanes()
+{
+	TArray<FTangoPlane> Result;
+	Planes.GenerateValueArray(Result);
+	return Result;
+}
+
+bool UTangoPlaneComponent::GetPlane(int32 ID, FTangoPlane& Plane)
+{
+	if (const FTangoPlane* Found = Planes.Find(ID))
+	{
+		Plane = *Found;
+		return true;
+	}
+	return false;
+}
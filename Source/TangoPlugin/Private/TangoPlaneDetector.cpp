@@ -0,0 +1,313 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+#include "TangoPluginPrivatePCH.h"
+#include "TangoPlaneDetector.h"
+
+DECLARE_CYCLE_STAT(TEXT("Plane Detection"), STAT_TangoPlaneDetection, STATGROUP_Tango);
+
+namespace
+{
+	//Points sampled from each frame for RANSAC, and hypotheses tested per plane
+	static const int32 MaxSamplePoints = 2048;
+	static const int32 RansacIterations = 200;
+
+	//Least squares plane through the points, returns false if they are degenerate
+	static bool FitPlaneToPoints(const TArray<FVector>& Points, const TArray<int32>& Indices, FVector& OutCentroid, FVector& OutNormal)
+	{
+		if (Indices.Num() < 3)
+		{
+			return false;
+		}
+		FVector Centroid(0, 0, 0);
+		for (int32 i : Indices)
+		{
+			Centroid += Points[i];
+		}
+		Centroid /= (float)Indices.Num();
+
+		float XX = 0, XY = 0, XZ = 0, YY = 0, YZ = 0, ZZ = 0;
+		for (int32 i : Indices)
+		{
+			const FVector D = Points[i] - Centroid;
+			XX += D.X * D.X;
+			XY += D.X * D.Y;
+			XZ += D.X * D.Z;
+			YY += D.Y * D.Y;
+			YZ += D.Y * D.Z;
+			ZZ += D.Z * D.Z;
+		}
+		//Solve for the normal along the axis with the best conditioned system
+		const float DetX = YY * ZZ - YZ * YZ;
+		const float DetY = XX * ZZ - XZ * XZ;
+		const float DetZ = XX * YY - XY * XY;
+		const float DetMax = FMath::Max3(DetX, DetY, DetZ);
+		if (DetMax <= 0)
+		{
+			return false;
+		}
+		FVector Normal;
+		if (DetMax == DetX)
+		{
+			Normal = FVector(DetX, XZ * YZ - XY * ZZ, XY * YZ - XZ * YY);
+		}
+		else if (DetMax == DetY)
+		{
+			Normal = FVector(XZ * YZ - XY * ZZ, DetY, XY * XZ - YZ * XX);
+		}
+		else
+		{
+			Normal = FVector(XY * YZ - XZ * YY, XY * XZ - YZ * XX, DetZ);
+		}
+		OutNormal = Normal.GetSafeNormal();
+		OutCentroid = Centroid;
+		return !OutNormal.IsNearlyZero();
+	}
+}
+
+TangoPlaneDetector::TangoPlaneDetector(const FSettings& InSettings)
+	: Settings(InSettings)
+	, Random(0x7A160)
+	, NextID(1)
+{
+	StartThread(TEXT("TangoPlaneDetector"));
+}
+
+TangoPlaneDetector::~TangoPlaneDetector()
+{
+	StopThread();
+}
+
+void TangoPlaneDetector::PopEvents(TArray<FPlaneEvent>& OutEvents)
+{
+	FScopeLock Lock(&PendingLock);
+	OutEvents.Append(PendingEvents);
+	PendingEvents.Reset();
+}
+
+void TangoPlaneDetector::ProcessFrame(const FTangoPointCloudFrame& Frame)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TangoPlaneDetection);
+	TArray<FDetectedPlane> Detected;
+	DetectPlanes(Frame, Detected);
+	for (const FDetectedPlane& Plane : Detected)
+	{
+		MergePlane(Frame, Plane);
+	}
+
+	//Only count a miss if the plane should have been seen
+	for (int32 i = TrackedPlanes.Num() - 1; i >= 0; --i)
+	{
+		FTrackedPlane& Plane = TrackedPlanes[i];
+		if (Plane.LastSeenGeneration == Frame.Generation || !IsInView(Frame, Plane))
+		{
+			continue;
+		}
+		if (++Plane.MissedFrames >= Settings.RemoveAfterMissedFrames)
+		{
+			QueueEvent(EPlaneEventType::Removed, Plane);
+			TrackedPlanes.RemoveAtSwap(i);
+		}
+	}
+}
+
+void TangoPlaneDetector::DetectPlanes(const FTangoPointCloudFrame& Frame, TArray<FDetectedPlane>& OutPlanes)
+{
+	const int32 Stride = FMath::Max(1, Frame.Points.Num() / MaxSamplePoints);
+	SamplePoints.Reset();
+	for (int32 i = 0; i < Frame.Points.Num(); i += Stride)
+	{
+		SamplePoints.Add(Frame.Points[i]);
+	}
+	Remaining.Reset();
+	for (int32 i = 0; i < SamplePoints.Num(); ++i)
+	{
+		Remaining.Add(i);
+	}
+	const FVector CameraLocation = Frame.DepthToSpace.GetLocation();
+	const float Threshold = Settings.DistanceThreshold;
+
+	for (int32 PlaneIndex = 0; PlaneIndex < Settings.MaxPlanesPerFrame && Remaining.Num() >= Settings.MinPoints; ++PlaneIndex)
+	{
+		FVector BestNormal(0, 0, 0);
+		float BestDistance = 0;
+		int32 BestCount = 0;
+		for (int32 Iteration = 0; Iteration < RansacIterations; ++Iteration)
+		{
+			const FVector& A = SamplePoints[Remaining[Random.RandHelper(Remaining.Num())]];
+			const FVector& B = SamplePoints[Remaining[Random.RandHelper(Remaining.Num())]];
+			const FVector& C = SamplePoints[Remaining[Random.RandHelper(Remaining.Num())]];
+			const FVector Normal = ((B - A) ^ (C - A)).GetSafeNormal();
+			if (Normal.IsNearlyZero())
+			{
+				continue;
+			}
+			const float Distance = Normal | A;
+			int32 Count = 0;
+			for (int32 i : Remaining)
+			{
+				if (FMath::Abs((Normal | SamplePoints[i]) - Distance) <= Threshold)
+				{
+					Count++;
+				}
+			}
+			if (Count > BestCount)
+			{
+				BestCount = Count;
+				BestNormal = Normal;
+				BestDistance = Distance;
+			}
+		}
+		if (BestCount < Settings.MinPoints)
+		{
+			break;
+		}
+
+		FDetectedPlane Plane;
+		for (int32 i : Remaining)
+		{
+			if (FMath::Abs((BestNormal | SamplePoints[i]) - BestDistance) <= Threshold)
+			{
+				Plane.Inliers.Add(i);
+			}
+		}
+		//Refine the hypothesis on all of its inliers and collect them again
+		if (!FitPlaneToPoints(SamplePoints, Plane.Inliers, Plane.Centroid, Plane.Normal))
+		{
+			break;
+		}
+		Plane.Inliers.Reset();
+		TArray<int32> Outliers;
+		for (int32 i : Remaining)
+		{
+			if (FMath::Abs((SamplePoints[i] - Plane.Centroid) | Plane.Normal) <= Threshold)
+			{
+				Plane.Inliers.Add(i);
+			}
+			else
+			{
+				Outliers.Add(i);
+			}
+		}
+		if (Plane.Inliers.Num() < Settings.MinPoints)
+		{
+			break;
+		}
+		if (((CameraLocation - Plane.Centroid) | Plane.Normal) < 0)
+		{
+			Plane.Normal = -Plane.Normal;
+		}
+		Remaining = MoveTemp(Outliers);
+		OutPlanes.Add(MoveTemp(Plane));
+	}
+}
+
+void TangoPlaneDetector::GetBounds(const FTrackedPlane& Plane, const TArray<int32>& Inliers, FVector2D& OutMin, FVector2D& OutMax) const
+{
+	OutMin = FVector2D(MAX_flt, MAX_flt);
+	OutMax = FVector2D(-MAX_flt, -MAX_flt);
+	for (int32 i : Inliers)
+	{
+		const FVector Offset = SamplePoints[i] - Plane.Origin;
+		const FVector2D UV(Offset | Plane.U, Offset | Plane.V);
+		OutMin.X = FMath::Min(OutMin.X, UV.X);
+		OutMin.Y = FMath::Min(OutMin.Y, UV.Y);
+		OutMax.X = FMath::Max(OutMax.X, UV.X);
+		OutMax.Y = FMath::Max(OutMax.Y, UV.Y);
+	}
+}
+
+void TangoPlaneDetector::MergePlane(const FTangoPointCloudFrame& Frame, const FDetectedPlane& Detected)
+{
+	const float MinCosine = FMath::Cos(FMath::DegreesToRadians(Settings.MergeAngle));
+	for (FTrackedPlane& Plane : TrackedPlanes)
+	{
+		if ((Plane.Normal | Detected.Normal) < MinCosine ||
+			FMath::Abs((Detected.Centroid - Plane.Origin) | Plane.Normal) > Settings.MergeDistance)
+		{
+			continue;
+		}
+		FVector2D Min, Max;
+		GetBounds(Plane, Detected.Inliers, Min, Max);
+		if (Min.X > Plane.Max.X + Settings.MergeDistance || Max.X < Plane.Min.X - Settings.MergeDistance ||
+			Min.Y > Plane.Max.Y + Settings.MergeDistance || Max.Y < Plane.Min.Y - Settings.MergeDistance)
+		{
+			continue;
+		}
+
+		//Blend towards the new observation, older planes move less
+		const float Weight = (float)FMath::Min(Plane.Observations, 10);
+		Plane.Normal = (Plane.Normal * Weight + Detected.Normal).GetSafeNormal();
+		Plane.Origin += Plane.Normal * (((Detected.Centroid - Plane.Origin) | Plane.Normal) / (Weight + 1));
+		Plane.U = (Plane.U - Plane.Normal * (Plane.U | Plane.Normal)).GetSafeNormal();
+		Plane.V = Plane.Normal ^ Plane.U;
+
+		GetBounds(Plane, Detected.Inliers, Min, Max);
+		Plane.Min.X = FMath::Min(Plane.Min.X, Min.X);
+		Plane.Min.Y = FMath::Min(Plane.Min.Y, Min.Y);
+		Plane.Max.X = FMath::Max(Plane.Max.X, Max.X);
+		Plane.Max.Y = FMath::Max(Plane.Max.Y, Max.Y);
+		Plane.Timestamp = Frame.Timestamp;
+		Plane.Observations++;
+		Plane.MissedFrames = 0;
+		Plane.LastSeenGeneration = Frame.Generation;
+		QueueEvent(EPlaneEventType::Updated, Plane);
+		return;
+	}
+
+	FTrackedPlane Plane;
+	Plane.ID = NextID++;
+	Plane.Origin = Detected.Centroid;
+	Plane.Normal = Detected.Normal;
+	Plane.Normal.FindBestAxisVectors(Plane.U, Plane.V);
+	Plane.V = Plane.Normal ^ Plane.U;
+	GetBounds(Plane, Detected.Inliers, Plane.Min, Plane.Max);
+	Plane.Timestamp = Frame.Timestamp;
+	Plane.Observations = 1;
+	Plane.MissedFrames = 0;
+	Plane.LastSeenGeneration = Frame.Generation;
+	TrackedPlanes.Add(Plane);
+	QueueEvent(EPlaneEventType::Added, Plane);
+}
+
+bool TangoPlaneDetector::IsInView(const FTangoPointCloudFrame& Frame, const FTrackedPlane& Plane) const
+{
+	//Rough depth camera frustum: about 70 by 55 degrees, from 0.3 to 4 meters
+	const FVector Local = Frame.DepthToSpace.InverseTransformPosition(ToTangoPlane(Plane).Pose.GetLocation());
+	const float Near = 0.3f * Settings.MetersToWorldScale;
+	const float Far = 4.0f * Settings.MetersToWorldScale;
+	return Local.X > Near && Local.X < Far &&
+		FMath::Abs(Local.Y) < Local.X * 0.7f &&
+		FMath::Abs(Local.Z) < Local.X * 0.5f;
+}
+
+FTangoPlane TangoPlaneDetector::ToTangoPlane(const FTrackedPlane& Plane) const
+{
+	const FVector2D Center = (Plane.Min + Plane.Max) * 0.5f;
+	FTangoPlane Result;
+	Result.ID = Plane.ID;
+	Result.Pose = FTransform(Plane.Normal, Plane.U, Plane.V, Plane.Origin + Plane.U * Center.X + Plane.V * Center.Y);
+	Result.Extents = (Plane.Max - Plane.Min) * 0.5f;
+	Result.Timestamp = Plane.Timestamp;
+	return Result;
+}
+
+void TangoPlaneDetector::QueueEvent(EPlaneEventType Type, const FTrackedPlane& Plane)
+{
+	FPlaneEvent Event;
+	Event.Type = Type;
+	Event.Plane = ToTangoPlane(Plane);
+	FScopeLock Lock(&PendingLock);
+	PendingEvents.Add(Event);
+}
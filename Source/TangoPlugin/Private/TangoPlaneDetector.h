@@ -0,0 +1,103 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+#pragma once
+
+#include "TangoPlaneComponent.h"
+#include "TangoPointCloudWorker.h"
+
+/**
+ * Segments depth frames into planes with RANSAC on its own thread and merges them into a persistent set.
+ * The resulting changes are queued until the game thread pops them.
+ */
+class TangoPlaneDetector : public TangoPointCloudWorker
+{
+public:
+	struct FSettings
+	{
+		float DistanceThreshold;
+		int32 MinPoints;
+		int32 MaxPlanesPerFrame;
+		float MergeAngle;
+		float MergeDistance;
+		int32 RemoveAfterMissedFrames;
+		float MetersToWorldScale;
+	};
+
+	enum class EPlaneEventType : uint8
+	{
+		Added,
+		Updated,
+		Removed
+	};
+
+	struct FPlaneEvent
+	{
+		EPlaneEventType Type;
+		FTangoPlane Plane;
+	};
+
+	TangoPlaneDetector(const FSettings& InSettings);
+	virtual ~TangoPlaneDetector();
+
+	/** Moves all changes since the last call into OutEvents. */
+	void PopEvents(TArray<FPlaneEvent>& OutEvents);
+
+protected:
+	virtual void ProcessFrame(const FTangoPointCloudFrame& Frame) override;
+
+private:
+	struct FTrackedPlane
+	{
+		int32 ID;
+		FVector Origin;
+		FVector Normal;
+		//Orthonormal basis of the plane, Normal ^ U == V
+		FVector U;
+		FVector V;
+		//Bounds in the U, V basis relative to Origin
+		FVector2D Min;
+		FVector2D Max;
+		double Timestamp;
+		int32 Observations;
+		int32 MissedFrames;
+		int64 LastSeenGeneration;
+	};
+
+	struct FDetectedPlane
+	{
+		FVector Centroid;
+		FVector Normal;
+		TArray<int32> Inliers;
+	};
+
+	void DetectPlanes(const FTangoPointCloudFrame& Frame, TArray<FDetectedPlane>& OutPlanes);
+	void MergePlane(const FTangoPointCloudFrame& Frame, const FDetectedPlane& Detected);
+	bool IsInView(const FTangoPointCloudFrame& Frame, const FTrackedPlane& Plane) const;
+	void GetBounds(const FTrackedPlane& Plane, const TArray<int32>& Inliers, FVector2D& OutMin, FVector2D& OutMax) const;
+	FTangoPlane ToTangoPlane(const FTrackedPlane& Plane) const;
+	void QueueEvent(EPlaneEventType Type, const FTrackedPlane& Plane);
+
+	FSettings Settings;
+
+	FCriticalSection PendingLock;
+	TArray<FPlaneEvent> PendingEvents;
+
+	//Only touched by the detector thread
+	TArray<FTrackedPlane> TrackedPlanes;
+	TArray<FVector> SamplePoints;
+	TArray<int32> Remaining;
+	FRandomStream Random;
+	int32 NextID;
+};
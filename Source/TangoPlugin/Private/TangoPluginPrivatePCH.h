@@ -15,3 +15,5 @@ limitations under the License.*/
 
 #include "Engine.h"
 #include "TangoDataTypes.h"
+
+DECLARE_STATS_GROUP(TEXT("Tango"), STATGROUP_Tango, STATCAT_Advanced);
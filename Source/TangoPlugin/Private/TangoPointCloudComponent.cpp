@@ -15,8 +15,78 @@ limitations under the License.*/
 #include "TangoPluginPrivatePCH.h"
 #include "TangoDevice.h"
 #include "TangoPointCloudComponent.h"
+#include "TangoPointCloudIndex.h"
 
-UTangoPointCloudComponent::UTangoPointCloudComponent() : Super()
+int32 FTangoPointCloudFrame::FindNearestPoint(const FVector& Location, float MaxDistance) const
+{
+	if (Index.IsValid())
+	{
+		return Index->FindNearest(DepthToSpace.InverseTransformPosition(Location), MaxDistance);
+	}
+	int32 Best = INDEX_NONE;
+	float BestDistanceSquared = MaxDistance * MaxDistance;
+	for (int32 i = 0; i < Points.Num(); ++i)
+	{
+		const float DistanceSquared = FVector::DistSquared(Points[i], Location);
+		if (DistanceSquared <= BestDistanceSquared)
+		{
+			BestDistanceSquared = DistanceSquared;
+			Best = i;
+		}
+	}
+	return Best;
+}
+
+void FTangoPointCloudFrame::FindPointsInRadius(const FVector& Location, float Radius, TArray<int32>& OutIndices) const
+{
+	if (Index.IsValid())
+	{
+		Index->FindInRadius(DepthToSpace.InverseTransformPosition(Location), Radius, OutIndices);
+		return;
+	}
+	for (int32 i = 0; i < Points.Num(); ++i)
+	{
+		if (FVector::DistSquared(Points[i], Location) <= Radius * Radius)
+		{
+			OutIndices.Add(i);
+		}
+	}
+}
+
+int32 FTangoPointCloudFrame::RaycastPoints(const FVector& Start, const FVector& Direction, float Radius, float MaxDistance, float& OutDistance) const
+{
+	const FVector Normal = Direction.GetSafeNormal();
+	if (Index.IsValid())
+	{
+		return Index->Raycast(DepthToSpace.InverseTransformPosition(Start), DepthToSpace.InverseTransformVector(Normal), Radius, MaxDistance, OutDistance);
+	}
+	int32 Best = INDEX_NONE;
+	OutDistance = MaxDistance;
+	for (int32 i = 0; i < Points.Num(); ++i)
+	{
+		const FVector ToPoint = Points[i] - Start;
+		const float Along = ToPoint | Normal;
+		if (Along >= 0 && Along < OutDistance && ToPoint.SizeSquared() - Along * Along <= Radius * Radius)
+		{
+			OutDistance = Along;
+			Best = i;
+		}
+	}
+	return Best;
+}
+
+const TArray<FVector>& UPointCloudContainer::GetPointCloudArray(float& Timestamp)
+{
+	if (!Frame.IsValid())
+	{
+		Timestamp = 0;
+		return DummyPointCloud;
+	}
+	Timestamp = Frame->Timestamp;
+	return Frame->Points;
+}
+
+UTangoPointCloudComponent::UTangoPointCloudComponent() : Super(), PointSpace(ETangoPointSpace::LOCAL), bUseFilteredPoints(false), Container(nullptr)
 {
 }
 
@@ -26,6 +96,98 @@ void UTangoPointCloudComponent::BeginPlay()
 	Super::BeginPlay();
 }
 
+void UTangoPointCloudComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UTangoDevice::Get().PointCloudComponents.Remove(this);
+	LatestFrame.Reset();
+	if (Container != nullptr)
+	{
+		Container->SetFrame(FTangoPointCloudFramePtr());
+	}
+	Super::EndPlay(EndPlayReason);
+}
+
+void UTangoPointCloudComponent::SetLatestFrame(const FTangoPointCloudFramePtr& Frame)
+{
+	LatestFrame = Frame;
+	if (Container != nullptr)
+	{
+		Container->SetFrame(LatestFrame);
+	}
+	if (LatestFrame.IsValid())
+	{
+		OnTangoXYZijAvailable.Broadcast(LatestFrame->Timestamp);
+	}
+}
+
+UPointCloudContainer* UTangoPointCloudComponent::PassPointCloudReferenceContainer()
+{
+	if (Container == nullptr)
+	{
+		Container = NewObject<UPointCloudContainer>(this);
+	}
+	Container->SetFrame(LatestFrame);
+	return Container;
+}
+
+int32 UTangoPointCloudComponent::GetCurrentPointCount(float& Timestamp)
+{
+	if (!LatestFrame.IsValid())
+	{
+		Timestamp = 0;
+		return 0;
+	}
+	Timestamp = LatestFrame->Timestamp;
+	return LatestFrame->Points.Num();
+}
+
+FTangoPointCloudFilterStats UTangoPointCloudComponent::GetFilterStats()
+{
+	return LatestFrame.IsValid() ? LatestFrame->FilterStats : FTangoPointCloudFilterStats();
+}
+
+bool UTangoPointCloudComponent::FindNearestPoint(const FVector& Location, float MaxDistance, FVector& Point, float& Timestamp)
+{
+	Timestamp = LatestFrame.IsValid() ? LatestFrame->Timestamp : 0;
+	const int32 Found = LatestFrame.IsValid() ? LatestFrame->FindNearestPoint(Location, MaxDistance) : INDEX_NONE;
+	Point = Found != INDEX_NONE ? LatestFrame->Points[Found] : FVector::ZeroVector;
+	return Found != INDEX_NONE;
+}
+
+TArray<FVector> UTangoPointCloudComponent::GetPointsInRadius(const FVector& Location, float Radius, float& Timestamp)
+{
+	TArray<FVector> Result;
+	Timestamp = 0;
+	if (LatestFrame.IsValid())
+	{
+		Timestamp = LatestFrame->Timestamp;
+		TArray<int32> Found;
+		LatestFrame->FindPointsInRadius(Location, Radius, Found);
+		Result.Reserve(Found.Num());
+		for (int32 i : Found)
+		{
+			Result.Add(LatestFrame->Points[i]);
+		}
+	}
+	return Result;
+}
+
+bool UTangoPointCloudComponent::RaycastPoints(const FVector& Start, const FVector& Direction, float Radius, float MaxDistance, FVector& HitPoint, float& Timestamp)
+{
+	Timestamp = LatestFrame.IsValid() ? LatestFrame->Timestamp : 0;
+	float Distance = 0;
+	const int32 Found = LatestFrame.IsValid() ? LatestFrame->RaycastPoints(Start, Direction, Radius, MaxDistance, Distance) : INDEX_NONE;
+	HitPoint = Found != INDEX_NONE ? LatestFrame->Points[Found] : FVector::ZeroVector;
+	return Found != INDEX_NONE;
+}
+
+FVector UTangoPointCloudComponent::GetSinglePoint(int32 Index, float& Timestamp, bool& ValidValue)
+{
+	Timestamp = LatestFrame.IsValid() ? LatestFrame->Timestamp : 0;
+	ValidValue = LatestFrame.IsValid() && LatestFrame->Points.IsValidIndex(Index);
+	return ValidValue ? LatestFrame->Points[Index] : FVector::ZeroVector;
+}
+
 int32 UTangoPointCloudComponent::GetMaxPointCount()
 {
 	if (UTangoDevice::Get().GetTangoDevicePointCloudPointer() == nullptr)
@@ -39,6 +201,11 @@ int32 UTangoPointCloudComponent::GetMaxPointCount()
 }
 
 float UTangoPointCloudComponent::GetPointCloudTimestamp()
+{
+	return GetPointCloudPreciseTimestamp();
+}
+
+double UTangoPointCloudComponent::GetPointCloudPreciseTimestamp()
 {
 	if (UTangoDevice::Get().GetTangoDevicePointCloudPointer() == nullptr)
 	{
@@ -46,13 +213,11 @@ float UTangoPointCloudComponent::GetPointCloudTimestamp()
 	}
 	else
 	{
-#if PLATFORM_ANDROID
-		auto PointCloud = UTangoDevice::Get().GetTangoDevicePointCloudPointer()->GetLatestPointCloud();
-		if (PointCloud) 
+		TangoPointCloudRing::FPin PointCloud = UTangoDevice::Get().GetTangoDevicePointCloudPointer()->PinLatestPointCloud();
+		if (PointCloud.IsValid())
 		{
-			return PointCloud->timestamp;
+			return PointCloud.GetTimestamp();
 		}
-#endif
 	}
 	return 0;
 }
@@ -78,3 +243,30 @@ bool UTangoPointCloudComponent::FitPlane(const FVector2D& ScreenPoint, FTransfor
 	return false;
 }
 
+int32 UTangoPointCloudComponent::FitPlanes(const TArray<FVector2D>& ScreenPoints, TArray<FTransform>& Poses, TArray<bool>& Successes)
+{
+	Poses.Init(FTransform::Identity, ScreenPoints.Num());
+	Successes.Init(false, ScreenPoints.Num());
+#if PLATFORM_ANDROID
+	if (UTangoDevice::Get().GetTangoDevicePointCloudPointer() != nullptr)
+	{
+		UWorld* World = GetOwner()->GetWorld();
+		if (World && World->IsGameWorld())
+		{
+			if (UGameViewportClient* ViewportClient = World->GetGameViewport())
+			{
+				FVector2D ViewportSize;
+				ViewportClient->GetViewportSize(ViewportSize);
+				TArray<FVector2D> UVs;
+				UVs.Reserve(ScreenPoints.Num());
+				for (const FVector2D& ScreenPoint : ScreenPoints)
+				{
+					UVs.Add(FVector2D(1.0f - ScreenPoint.X / ViewportSize.X, 1.0f - ScreenPoint.Y / ViewportSize.Y));
+				}
+				return UTangoDevice::Get().GetTangoDevicePointCloudPointer()->FitPlanes(UVs, Poses, Successes);
+			}
+		}
+	}
+#endif
+	return 0;
+}
@@ -0,0 +1,112 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+#include "TangoPluginPrivatePCH.h"
+#include "TangoPointCloudFilter.h"
+
+namespace
+{
+	//Voxel coordinates are packed into 21 bits per axis, so bit 63 is never set by a real key
+	static const uint64 EmptyKey = ~0ull;
+	static const int32 VoxelBias = 1 << 20;
+
+	static uint64 PackVoxel(int32 X, int32 Y, int32 Z)
+	{
+		const uint64 Mask = (1ull << 21) - 1;
+		return ((uint64)(X + VoxelBias) & Mask) | (((uint64)(Y + VoxelBias) & Mask) << 21) | (((uint64)(Z + VoxelBias) & Mask) << 42);
+	}
+
+	static uint32 HashVoxel(uint64 Key, uint32 Mask)
+	{
+		return (uint32)((Key * 0x9E3779B97F4A7C15ull) >> 32) & Mask;
+	}
+}
+
+TangoPointCloudFilter::TangoPointCloudFilter()
+	: MinConfidence(0)
+	, VoxelSize(0)
+{
+}
+
+void TangoPointCloudFilter::SetSettings(float InMinConfidence, float InVoxelSize)
+{
+	MinConfidence = FMath::Clamp(InMinConfidence, 0.0f, 1.0f);
+	VoxelSize = FMath::Max(InVoxelSize, 0.0f);
+}
+
+int32 TangoPointCloudFilter::Filter(const FVector4* In, int32 Num, TArray<FVector4>& Out)
+{
+	Out.Reset(Num);
+	if (VoxelSize <= 0)
+	{
+		for (int32 i = 0; i < Num; ++i)
+		{
+			if (In[i].W >= MinConfidence)
+			{
+				Out.Add(In[i]);
+			}
+		}
+		return Out.Num();
+	}
+
+	//Keep the table at most half full
+	const uint32 Capacity = FMath::RoundUpToPowerOfTwo(FMath::Max(Num * 2, 16));
+	const uint32 Mask = Capacity - 1;
+	Keys.SetNumUninitialized(Capacity, false);
+	CellIndices.SetNumUninitialized(Capacity, false);
+	FMemory::Memset(Keys.GetData(), 0xff, Capacity * sizeof(uint64));
+	Cells.Reset(Num);
+
+	const float InvVoxelSize = 1.0f / VoxelSize;
+	for (int32 i = 0; i < Num; ++i)
+	{
+		const FVector4& Point = In[i];
+		if (Point.W < MinConfidence)
+		{
+			continue;
+		}
+		const uint64 Key = PackVoxel(
+			FMath::FloorToInt(Point.X * InvVoxelSize),
+			FMath::FloorToInt(Point.Y * InvVoxelSize),
+			FMath::FloorToInt(Point.Z * InvVoxelSize));
+		uint32 Slot = HashVoxel(Key, Mask);
+		while (Keys[Slot] != EmptyKey && Keys[Slot] != Key)
+		{
+			Slot = (Slot + 1) & Mask;
+		}
+		if (Keys[Slot] == EmptyKey)
+		{
+			Keys[Slot] = Key;
+			CellIndices[Slot] = Cells.Num();
+			FCell Cell;
+			Cell.Sum = Point;
+			Cell.Count = 1;
+			Cells.Add(Cell);
+		}
+		else
+		{
+			FCell& Cell = Cells[CellIndices[Slot]];
+			Cell.Sum += Point;
+			Cell.Count++;
+		}
+	}
+
+	//One point per voxel at the centroid of its points, with their mean confidence
+	Out.SetNumUninitialized(Cells.Num(), false);
+	for (int32 i = 0; i < Cells.Num(); ++i)
+	{
+		Out[i] = Cells[i].Sum * (1.0f / Cells[i].Count);
+	}
+	return Out.Num();
+}
@@ -0,0 +1,48 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+#pragma once
+
+/**
+ * Reduces a depth frame before it is handed to consumers.
+ * Points below a confidence threshold are dropped, the rest are collapsed into one point per voxel
+ * using a hashed grid, so memory only depends on the number of occupied voxels.
+ * Not thread safe, the point cloud worker owns one instance and reuses its buffers every frame.
+ */
+class TangoPointCloudFilter
+{
+public:
+	TangoPointCloudFilter();
+
+	/** @param InVoxelSize Voxel edge length in meters, 0 keeps every point that passes the confidence test. */
+	void SetSettings(float InMinConfidence, float InVoxelSize);
+
+	/** Filters Num packed {X, Y, Z, C} points into Out and returns how many were kept. */
+	int32 Filter(const FVector4* In, int32 Num, TArray<FVector4>& Out);
+
+private:
+	struct FCell
+	{
+		FVector4 Sum;
+		int32 Count;
+	};
+
+	float MinConfidence;
+	float VoxelSize;
+
+	//Open addressing table from packed voxel coordinates to an index into Cells
+	TArray<uint64> Keys;
+	TArray<int32> CellIndices;
+	TArray<FCell> Cells;
+};
@@ -0,0 +1,274 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+#include "TangoPluginPrivatePCH.h"
+#include "TangoPointCloudIndex.h"
+
+namespace
+{
+	//Slab test of a ray against a box, limited to [0, MaxDistance]
+	static bool RayIntersectsBox(const FVector& Start, const FVector& Direction, const FBox& Box, float MaxDistance)
+	{
+		float Near = 0;
+		float Far = MaxDistance;
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			if (FMath::Abs(Direction[Axis]) < SMALL_NUMBER)
+			{
+				if (Start[Axis] < Box.Min[Axis] || Start[Axis] > Box.Max[Axis])
+				{
+					return false;
+				}
+				continue;
+			}
+			const float InvDirection = 1.0f / Direction[Axis];
+			float T1 = (Box.Min[Axis] - Start[Axis]) * InvDirection;
+			float T2 = (Box.Max[Axis] - Start[Axis]) * InvDirection;
+			if (T1 > T2)
+			{
+				Swap(T1, T2);
+			}
+			Near = FMath::Max(Near, T1);
+			Far = FMath::Min(Far, T2);
+			if (Near > Far)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+void TangoPointCloudIndex::Build(const FVector4* In, int32 Num, const TangoPointCloudKernels::FPointTransform& Transform)
+{
+	Points.SetNumUninitialized(Num, false);
+	Indices.SetNumUninitialized(Num, false);
+	Axes.SetNumUninitialized(Num, false);
+	TangoPointCloudKernels::TransformPoints(In, Points.GetData(), Num, Transform);
+	Bounds = FBox(ForceInit);
+	for (int32 i = 0; i < Num; ++i)
+	{
+		Indices[i] = i;
+		Bounds += Points[i];
+	}
+	BuildRange(0, Num);
+}
+
+void TangoPointCloudIndex::BuildRange(int32 Begin, int32 End)
+{
+	if (End - Begin <= LeafSize)
+	{
+		return;
+	}
+	FBox Box(ForceInit);
+	for (int32 i = Begin; i < End; ++i)
+	{
+		Box += Points[i];
+	}
+	const FVector Extent = Box.GetSize();
+	const int32 Axis = (Extent.X >= Extent.Y && Extent.X >= Extent.Z) ? 0 : (Extent.Y >= Extent.Z ? 1 : 2);
+	const int32 Mid = Begin + (End - Begin) / 2;
+	Select(Begin, End, Mid, Axis);
+	Axes[Mid] = Axis;
+	BuildRange(Begin, Mid);
+	BuildRange(Mid + 1, End);
+}
+
+void TangoPointCloudIndex::SwapPoints(int32 A, int32 B)
+{
+	Swap(Points[A], Points[B]);
+	Swap(Indices[A], Indices[B]);
+}
+
+void TangoPointCloudIndex::Select(int32 Begin, int32 End, int32 Nth, int32 Axis)
+{
+	//Quickselect: afterwards Nth holds the median, with smaller values before and larger values after it
+	int32 Left = Begin;
+	int32 Right = End - 1;
+	while (Right > Left)
+	{
+		const float Pivot = Points[Left + (Right - Left) / 2][Axis];
+		int32 i = Left;
+		int32 j = Right;
+		while (i <= j)
+		{
+			while (Points[i][Axis] < Pivot)
+			{
+				i++;
+			}
+			while (Points[j][Axis] > Pivot)
+			{
+				j--;
+			}
+			if (i <= j)
+			{
+				SwapPoints(i, j);
+				i++;
+				j--;
+			}
+		}
+		if (Nth <= j)
+		{
+			Right = j;
+		}
+		else if (Nth >= i)
+		{
+			Left = i;
+		}
+		else
+		{
+			break;
+		}
+	}
+}
+
+int32 TangoPointCloudIndex::FindNearest(const FVector& Location, float MaxDistance) const
+{
+	int32 Best = INDEX_NONE;
+	float BestDistanceSquared = MaxDistance * MaxDistance;
+	FindNearestInRange(0, Points.Num(), Location, Best, BestDistanceSquared);
+	return Best != INDEX_NONE ? Indices[Best] : INDEX_NONE;
+}
+
+void TangoPointCloudIndex::FindNearestInRange(int32 Begin, int32 End, const FVector& Location, int32& Best, float& BestDistanceSquared) const
+{
+	if (End - Begin <= LeafSize)
+	{
+		for (int32 i = Begin; i < End; ++i)
+		{
+			const float DistanceSquared = FVector::DistSquared(Points[i], Location);
+			if (DistanceSquared <= BestDistanceSquared)
+			{
+				BestDistanceSquared = DistanceSquared;
+				Best = i;
+			}
+		}
+		return;
+	}
+	const int32 Mid = Begin + (End - Begin) / 2;
+	const int32 Axis = Axes[Mid];
+	const float DistanceSquared = FVector::DistSquared(Points[Mid], Location);
+	if (DistanceSquared <= BestDistanceSquared)
+	{
+		BestDistanceSquared = DistanceSquared;
+		Best = Mid;
+	}
+	const float Delta = Location[Axis] - Points[Mid][Axis];
+	if (Delta < 0)
+	{
+		FindNearestInRange(Begin, Mid, Location, Best, BestDistanceSquared);
+		if (Delta * Delta <= BestDistanceSquared)
+		{
+			FindNearestInRange(Mid + 1, End, Location, Best, BestDistanceSquared);
+		}
+	}
+	else
+	{
+		FindNearestInRange(Mid + 1, End, Location, Best, BestDistanceSquared);
+		if (Delta * Delta <= BestDistanceSquared)
+		{
+			FindNearestInRange(Begin, Mid, Location, Best, BestDistanceSquared);
+		}
+	}
+}
+
+void TangoPointCloudIndex::FindInRadius(const FVector& Location, float Radius, TArray<int32>& OutIndices) const
+{
+	FindInRadiusInRange(0, Points.Num(), Location, Radius * Radius, Radius, OutIndices);
+}
+
+void TangoPointCloudIndex::FindInRadiusInRange(int32 Begin, int32 End, const FVector& Location, float RadiusSquared, float Radius, TArray<int32>& OutIndices) const
+{
+	if (End - Begin <= LeafSize)
+	{
+		for (int32 i = Begin; i < End; ++i)
+		{
+			if (FVector::DistSquared(Points[i], Location) <= RadiusSquared)
+			{
+				OutIndices.Add(Indices[i]);
+			}
+		}
+		return;
+	}
+	const int32 Mid = Begin + (End - Begin) / 2;
+	const int32 Axis = Axes[Mid];
+	if (FVector::DistSquared(Points[Mid], Location) <= RadiusSquared)
+	{
+		OutIndices.Add(Indices[Mid]);
+	}
+	const float Delta = Location[Axis] - Points[Mid][Axis];
+	if (Delta <= Radius)
+	{
+		FindInRadiusInRange(Begin, Mid, Location, RadiusSquared, Radius, OutIndices);
+	}
+	if (Delta >= -Radius)
+	{
+		FindInRadiusInRange(Mid + 1, End, Location, RadiusSquared, Radius, OutIndices);
+	}
+}
+
+int32 TangoPointCloudIndex::Raycast(const FVector& Start, const FVector& Direction, float Radius, float MaxDistance, float& OutDistance) const
+{
+	int32 Best = INDEX_NONE;
+	float BestDistance = MaxDistance;
+	RaycastInRange(0, Points.Num(), Bounds, Start, Direction, Radius, Best, BestDistance);
+	OutDistance = BestDistance;
+	return Best != INDEX_NONE ? Indices[Best] : INDEX_NONE;
+}
+
+void TangoPointCloudIndex::RaycastInRange(int32 Begin, int32 End, const FBox& Box, const FVector& Start, const FVector& Direction, float Radius, int32& Best, float& BestDistance) const
+{
+	if (Begin >= End || !RayIntersectsBox(Start, Direction, Box.ExpandBy(Radius), BestDistance))
+	{
+		return;
+	}
+	const float RadiusSquared = Radius * Radius;
+	auto TestPoint = [&](int32 i)
+	{
+		const FVector ToPoint = Points[i] - Start;
+		const float Along = ToPoint | Direction;
+		if (Along >= 0 && Along < BestDistance && ToPoint.SizeSquared() - Along * Along <= RadiusSquared)
+		{
+			BestDistance = Along;
+			Best = i;
+		}
+	};
+	if (End - Begin <= LeafSize)
+	{
+		for (int32 i = Begin; i < End; ++i)
+		{
+			TestPoint(i);
+		}
+		return;
+	}
+	const int32 Mid = Begin + (End - Begin) / 2;
+	const int32 Axis = Axes[Mid];
+	TestPoint(Mid);
+
+	FBox LowerBox = Box;
+	FBox UpperBox = Box;
+	LowerBox.Max[Axis] = Points[Mid][Axis];
+	UpperBox.Min[Axis] = Points[Mid][Axis];
+	//Visit the side the ray starts in first so the far side can be culled by the closer hit
+	if (Direction[Axis] >= 0)
+	{
+		RaycastInRange(Begin, Mid, LowerBox, Start, Direction, Radius, Best, BestDistance);
+		RaycastInRange(Mid + 1, End, UpperBox, Start, Direction, Radius, Best, BestDistance);
+	}
+	else
+	{
+		RaycastInRange(Mid + 1, End, UpperBox, Start, Direction, Radius, Best, BestDistance);
+		RaycastInRange(Begin, Mid, LowerBox, Start, Direction, Radius, Best, BestDistance);
+	}
+}
@@ -0,0 +1,59 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+#pragma once
+
+#include "TangoPointCloudKernels.h"
+
+/**
+ * Flat k-d tree over one depth frame.
+ * The tree is implicit: every range of the point array is split at its median along its longest axis,
+ * so no node structures are stored. Points are kept in depth camera space (Unreal axes and units),
+ * queries return indices into the point order of the frame the tree was built from.
+ */
+class TangoPointCloudIndex
+{
+public:
+	TangoPointCloudIndex() : Bounds(ForceInit) {}
+
+	/** Transforms Num packed {X, Y, Z, C} points with Transform and builds the tree over them. Reuses the previous buffers. */
+	void Build(const FVector4* In, int32 Num, const TangoPointCloudKernels::FPointTransform& Transform);
+
+	int32 Num() const { return Points.Num(); }
+
+	/** Index of the closest point within MaxDistance of Location, or INDEX_NONE. */
+	int32 FindNearest(const FVector& Location, float MaxDistance) const;
+	/** Appends the indices of all points within Radius of Location. */
+	void FindInRadius(const FVector& Location, float Radius, TArray<int32>& OutIndices) const;
+	/** Index of the first point along the ray that lies within Radius of it, or INDEX_NONE. Direction must be normalized. */
+	int32 Raycast(const FVector& Start, const FVector& Direction, float Radius, float MaxDistance, float& OutDistance) const;
+
+private:
+	enum { LeafSize = 8 };
+
+	void BuildRange(int32 Begin, int32 End);
+	void Select(int32 Begin, int32 End, int32 Nth, int32 Axis);
+	void SwapPoints(int32 A, int32 B);
+
+	void FindNearestInRange(int32 Begin, int32 End, const FVector& Location, int32& Best, float& BestDistanceSquared) const;
+	void FindInRadiusInRange(int32 Begin, int32 End, const FVector& Location, float RadiusSquared, float Radius, TArray<int32>& OutIndices) const;
+	void RaycastInRange(int32 Begin, int32 End, const FBox& Box, const FVector& Start, const FVector& Direction, float Radius, int32& Best, float& BestDistance) const;
+
+	//Points in tree order and the index each had in the frame
+	TArray<FVector> Points;
+	TArray<int32> Indices;
+	//Split axis of the node stored at each position, only meaningful for inner nodes
+	TArray<uint8> Axes;
+	FBox Bounds;
+};
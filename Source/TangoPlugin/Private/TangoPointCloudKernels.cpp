@@ -0,0 +1,222 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+#include "TangoPluginPrivatePCH.h"
+#include "TangoPointCloudKernels.h"
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define TANGO_POINT_KERNEL_NEON 1
+#include <arm_neon.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TANGO_POINT_KERNEL_SSE 1
+#include <xmmintrin.h>
+#endif
+
+static_assert(sizeof(FVector) == 3 * sizeof(float), "The point kernels write FVectors as packed float triples");
+static_assert(sizeof(FVector4) == 4 * sizeof(float), "The point kernels read FVector4s as packed float quads");
+
+TangoPointCloudKernels::FPointTransform TangoPointCloudKernels::FromMatrix(const FMatrix& Matrix)
+{
+	//FMatrix transforms row vectors, so output component j is column j
+	FPointTransform Result;
+	for (int32 j = 0; j < 3; ++j)
+	{
+		Result.Row[j][0] = Matrix.M[0][j];
+		Result.Row[j][1] = Matrix.M[1][j];
+		Result.Row[j][2] = Matrix.M[2][j];
+		Result.Row[j][3] = Matrix.M[3][j];
+	}
+	return Result;
+}
+
+TangoPointCloudKernels::FPointTransform TangoPointCloudKernels::MakeDepthToSpace(const FTransform& DepthToSpace, float MetersToWorldScale)
+{
+	//Depth camera to Unreal axes (forward = z, right = x, up = -y) and meters to world units
+	const float Scale = MetersToWorldScale;
+	const FMatrix DepthToUE(
+		FPlane(0, Scale, 0, 0),
+		FPlane(0, 0, -Scale, 0),
+		FPlane(Scale, 0, 0, 0),
+		FPlane(0, 0, 0, 1));
+	return FromMatrix(DepthToUE * DepthToSpace.ToMatrixNoScale());
+}
+
+void TangoPointCloudKernels::TransformPointsScalar(const FVector4* In, FVector* Out, int32 Num, const FPointTransform& T)
+{
+	for (int32 i = 0; i < Num; ++i)
+	{
+		const float X = In[i].X;
+		const float Y = In[i].Y;
+		const float Z = In[i].Z;
+		Out[i].X = T.Row[0][0] * X + T.Row[0][1] * Y + T.Row[0][2] * Z + T.Row[0][3];
+		Out[i].Y = T.Row[1][0] * X + T.Row[1][1] * Y + T.Row[1][2] * Z + T.Row[1][3];
+		Out[i].Z = T.Row[2][0] * X + T.Row[2][1] * Y + T.Row[2][2] * Z + T.Row[2][3];
+	}
+}
+
+#if TANGO_POINT_KERNEL_NEON
+
+static void TransformPointsNEON(const FVector4* In, FVector* Out, int32 Num, const TangoPointCloudKernels::FPointTransform& T)
+{
+	float32x4_t M[3][4];
+	for (int32 j = 0; j < 3; ++j)
+	{
+		for (int32 k = 0; k < 4; ++k)
+		{
+			M[j][k] = vdupq_n_f32(T.Row[j][k]);
+		}
+	}
+	const float* Source = reinterpret_cast<const float*>(In);
+	float* Dest = reinterpret_cast<float*>(Out);
+	int32 i = 0;
+	for (; i + 4 <= Num; i += 4)
+	{
+		//Deinterleave four XYZC points into X, Y, Z and C lanes
+		const float32x4x4_t P = vld4q_f32(Source + i * 4);
+		float32x4x3_t R;
+		for (int32 j = 0; j < 3; ++j)
+		{
+			R.val[j] = vmlaq_f32(vmlaq_f32(vmlaq_f32(M[j][3], P.val[0], M[j][0]), P.val[1], M[j][1]), P.val[2], M[j][2]);
+		}
+		//Interleave back into four packed FVectors
+		vst3q_f32(Dest + i * 3, R);
+	}
+	TangoPointCloudKernels::TransformPointsScalar(In + i, Out + i, Num - i, T);
+}
+
+#elif TANGO_POINT_KERNEL_SSE
+
+static void TransformPointsSSE(const FVector4* In, FVector* Out, int32 Num, const TangoPointCloudKernels::FPointTransform& T)
+{
+	__m128 M[3][4];
+	for (int32 j = 0; j < 3; ++j)
+	{
+		for (int32 k = 0; k < 4; ++k)
+		{
+			M[j][k] = _mm_set1_ps(T.Row[j][k]);
+		}
+	}
+	const float* Source = reinterpret_cast<const float*>(In);
+	float* Dest = reinterpret_cast<float*>(Out);
+	int32 i = 0;
+	for (; i + 4 <= Num; i += 4)
+	{
+		__m128 X = _mm_loadu_ps(Source + i * 4);
+		__m128 Y = _mm_loadu_ps(Source + i * 4 + 4);
+		__m128 Z = _mm_loadu_ps(Source + i * 4 + 8);
+		__m128 C = _mm_loadu_ps(Source + i * 4 + 12);
+		_MM_TRANSPOSE4_PS(X, Y, Z, C);
+
+		__m128 R[4];
+		for (int32 j = 0; j < 3; ++j)
+		{
+			R[j] = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(X, M[j][0]), _mm_mul_ps(Y, M[j][1])),
+				_mm_add_ps(_mm_mul_ps(Z, M[j][2]), M[j][3]));
+		}
+		R[3] = _mm_setzero_ps();
+		_MM_TRANSPOSE4_PS(R[0], R[1], R[2], R[3]);
+
+		//Each store spills one float into the next point, which the following store overwrites.
+		//The last point is written in two parts so we never touch memory past the block.
+		float* Block = Dest + i * 3;
+		_mm_storeu_ps(Block, R[0]);
+		_mm_storeu_ps(Block + 3, R[1]);
+		_mm_storeu_ps(Block + 6, R[2]);
+		_mm_storel_pi(reinterpret_cast<__m64*>(Block + 9), R[3]);
+		_mm_store_ss(Block + 11, _mm_movehl_ps(R[3], R[3]));
+	}
+	TangoPointCloudKernels::TransformPointsScalar(In + i, Out + i, Num - i, T);
+}
+
+#endif
+
+void TangoPointCloudKernels::TransformPoints(const FVector4* In, FVector* Out, int32 Num, const FPointTransform& Transform)
+{
+#if TANGO_POINT_KERNEL_NEON
+	TransformPointsNEON(In, Out, Num, Transform);
+#elif TANGO_POINT_KERNEL_SSE
+	TransformPointsSSE(In, Out, Num, Transform);
+#else
+	TransformPointsScalar(In, Out, Num, Transform);
+#endif
+}
+
+const TCHAR* TangoPointCloudKernels::GetPathName()
+{
+#if TANGO_POINT_KERNEL_NEON
+	return TEXT("NEON");
+#elif TANGO_POINT_KERNEL_SSE
+	return TEXT("SSE");
+#else
+	return TEXT("Scalar");
+#endif
+}
+
+#if !UE_BUILD_SHIPPING
+
+//Checks the vector path against the scalar reference on a synthetic frame and times both
+static void BenchmarkPointCloudKernels(const TArray<FString>& Args)
+{
+	const int32 NumPoints = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 60000;
+	const int32 Iterations = 50;
+
+	FRandomStream Random(1234);
+	TArray<FVector4> Points;
+	Points.SetNumUninitialized(NumPoints);
+	for (FVector4& Point : Points)
+	{
+		Point = FVector4(Random.FRandRange(-2, 2), Random.FRandRange(-2, 2), Random.FRandRange(0.3f, 5), Random.FRand());
+	}
+	const FTransform Pose(FRotator(12, 34, 56).Quaternion(), FVector(120, -40, 80));
+	const TangoPointCloudKernels::FPointTransform Transform = TangoPointCloudKernels::MakeDepthToSpace(Pose, 100);
+
+	TArray<FVector> Reference;
+	TArray<FVector> Result;
+	Reference.SetNumUninitialized(NumPoints);
+	Result.SetNumUninitialized(NumPoints);
+
+	double Start = FPlatformTime::Seconds();
+	for (int32 i = 0; i < Iterations; ++i)
+	{
+		TangoPointCloudKernels::TransformPointsScalar(Points.GetData(), Reference.GetData(), NumPoints, Transform);
+	}
+	const double ScalarMs = (FPlatformTime::Seconds() - Start) * 1000.0 / Iterations;
+
+	Start = FPlatformTime::Seconds();
+	for (int32 i = 0; i < Iterations; ++i)
+	{
+		TangoPointCloudKernels::TransformPoints(Points.GetData(), Result.GetData(), NumPoints, Transform);
+	}
+	const double VectorMs = (FPlatformTime::Seconds() - Start) * 1000.0 / Iterations;
+
+	float MaxError = 0;
+	for (int32 i = 0; i < NumPoints; ++i)
+	{
+		MaxError = FMath::Max(MaxError, (Result[i] - Reference[i]).GetAbsMax());
+	}
+	UE_LOG(TangoPlugin, Log, TEXT("TangoPointCloudKernels: %d points, scalar %.3f ms, %s %.3f ms, max error %f cm"),
+		NumPoints, ScalarMs, TangoPointCloudKernels::GetPathName(), VectorMs, MaxError);
+	if (MaxError > 0.01f)
+	{
+		UE_LOG(TangoPlugin, Error, TEXT("TangoPointCloudKernels: %s path does not match the scalar reference"), TangoPointCloudKernels::GetPathName());
+	}
+}
+
+static FAutoConsoleCommand TangoPointCloudBenchmarkCommand(
+	TEXT("Tango.PointCloud.Benchmark"),
+	TEXT("Checks the point cloud transform kernel against the scalar reference and times both. Optional argument: number of points."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkPointCloudKernels));
+
+#endif
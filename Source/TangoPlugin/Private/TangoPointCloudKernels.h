@@ -0,0 +1,41 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+#pragma once
+
+/**
+ * Batch transforms for whole depth frames.
+ * Points come in as packed {X, Y, Z, C} values in the depth camera frame and leave as Unreal space FVectors.
+ */
+class TangoPointCloudKernels
+{
+public:
+	/** Affine transform in a layout the kernels can broadcast from: Out[j] = Row[j].XYZ dot In + Row[j].W */
+	struct FPointTransform
+	{
+		float Row[3][4];
+	};
+
+	/** Combines the depth camera to Unreal axis swizzle, the meters to world scale and the pose of the depth camera in the target space. */
+	static FPointTransform MakeDepthToSpace(const FTransform& DepthToSpace, float MetersToWorldScale);
+	static FPointTransform FromMatrix(const FMatrix& Matrix);
+
+	/** Transforms Num points using the fastest path available on this platform. In and Out must not overlap. */
+	static void TransformPoints(const FVector4* In, FVector* Out, int32 Num, const FPointTransform& Transform);
+	/** Reference implementation the vector paths are checked against. */
+	static void TransformPointsScalar(const FVector4* In, FVector* Out, int32 Num, const FPointTransform& Transform);
+
+	/** Name of the path TransformPoints uses, for logging. */
+	static const TCHAR* GetPathName();
+};
@@ -0,0 +1,196 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+#include "TangoPluginPrivatePCH.h"
+#include "TangoPointCloudRing.h"
+
+void TangoPointCloudRing::FPin::Release()
+{
+	if (Slot != nullptr)
+	{
+		FPlatformAtomics::InterlockedDecrement(&Slot->State);
+		Slot = nullptr;
+	}
+}
+
+TangoPointCloudRing::TangoPointCloudRing(int32 NumSlots, int32 InMaxPoints)
+	: LatestGeneration(0)
+	, NextGeneration(0)
+	, MaxPoints(FMath::Max(InMaxPoints, 0))
+{
+	//One slot is always kept for the latest frame, so we need at least two to make progress.
+	//The writer tracks the slots it tried in a 32 bit mask.
+	Slots.SetNum(FMath::Clamp(NumSlots, 2, 32));
+	for (FSlot& Slot : Slots)
+	{
+		Slot.Points.SetNumZeroed(MaxPoints);
+#if PLATFORM_ANDROID
+		Slot.Cloud.version = 0;
+		Slot.Cloud.timestamp = 0;
+		Slot.Cloud.num_points = 0;
+		Slot.Cloud.points = reinterpret_cast<float(*)[4]>(Slot.Points.GetData());
+#endif
+	}
+}
+
+int64 TangoPointCloudRing::ReadGeneration(const volatile int64& Generation)
+{
+	//A plain 64 bit read may tear on 32 bit ARM
+	return FPlatformAtomics::InterlockedCompareExchange(const_cast<volatile int64*>(&Generation), 0, 0);
+}
+
+int64 TangoPointCloudRing::GetLatestGeneration() const
+{
+	return ReadGeneration(LatestGeneration);
+}
+
+bool TangoPointCloudRing::TryPin(FSlot& Slot)
+{
+	for (;;)
+	{
+		const int32 State = Slot.State;
+		if (State < 0)
+		{
+			return false;
+		}
+		if (FPlatformAtomics::InterlockedCompareExchange(&Slot.State, State + 1, State) == State)
+		{
+			return true;
+		}
+	}
+}
+
+bool TangoPointCloudRing::Write(const float(*InPoints)[4], uint32 InNumPoints, double InTimestamp)
+{
+	const int64 Latest = GetLatestGeneration();
+	uint32 TriedSlots = 0;
+	FSlot* Claimed = nullptr;
+	while (Claimed == nullptr)
+	{
+		//Recycle the oldest slot that is neither the latest frame nor pinned by a reader
+		int32 Best = INDEX_NONE;
+		for (int32 i = 0; i < Slots.Num(); ++i)
+		{
+			if ((TriedSlots & (1u << i)) != 0 || Slots[i].State != 0)
+			{
+				continue;
+			}
+			const int64 Generation = ReadGeneration(Slots[i].Generation);
+			if (Generation != 0 && Generation == Latest)
+			{
+				continue;
+			}
+			if (Best == INDEX_NONE || Generation < ReadGeneration(Slots[Best].Generation))
+			{
+				Best = i;
+			}
+		}
+		if (Best == INDEX_NONE)
+		{
+			DroppedFrames.Increment();
+			return false;
+		}
+		TriedSlots |= 1u << Best;
+		if (FPlatformAtomics::InterlockedCompareExchange(&Slots[Best].State, -1, 0) == 0)
+		{
+			Claimed = &Slots[Best];
+		}
+	}
+
+	const int32 NumPoints = FMath::Min(static_cast<int32>(InNumPoints), MaxPoints);
+	if (NumPoints > 0 && InPoints != nullptr)
+	{
+		FMemory::Memcpy(Claimed->Points.GetData(), InPoints, NumPoints * sizeof(FVector4));
+	}
+	Claimed->NumPoints = NumPoints;
+	Claimed->Timestamp = InTimestamp;
+#if PLATFORM_ANDROID
+	Claimed->Cloud.timestamp = InTimestamp;
+	Claimed->Cloud.num_points = NumPoints;
+#endif
+	const int64 Generation = ++NextGeneration;
+	FPlatformAtomics::InterlockedExchange(&Claimed->Generation, Generation);
+	//Make the frame visible to readers before anyone can find it through LatestGeneration
+	FPlatformMisc::MemoryBarrier();
+	FPlatformAtomics::InterlockedExchange(&Claimed->State, 0);
+	FPlatformAtomics::InterlockedExchange(&LatestGeneration, Generation);
+	return true;
+}
+
+TangoPointCloudRing::FPin TangoPointCloudRing::Pin(int64 Generation)
+{
+	if (Generation == 0)
+	{
+		return FPin();
+	}
+	for (FSlot& Slot : Slots)
+	{
+		if (ReadGeneration(Slot.Generation) != Generation || !TryPin(Slot))
+		{
+			continue;
+		}
+		//The slot may have been recycled between the generation check and the pin
+		if (ReadGeneration(Slot.Generation) == Generation)
+		{
+			return FPin(&Slot);
+		}
+		FPlatformAtomics::InterlockedDecrement(&Slot.State);
+	}
+	return FPin();
+}
+
+TangoPointCloudRing::FPin TangoPointCloudRing::PinLatest()
+{
+	//The latest slot is never recycled by the next write, so a retry is only needed
+	//if several frames were published while we were looking.
+	for (int32 Attempt = 0; Attempt < Slots.Num(); ++Attempt)
+	{
+		const int64 Generation = GetLatestGeneration();
+		if (Generation == 0)
+		{
+			break;
+		}
+		FPin Result = Pin(Generation);
+		if (Result.IsValid())
+		{
+			return Result;
+		}
+	}
+	return FPin();
+}
+
+TangoPointCloudRing::FPin TangoPointCloudRing::PinNearest(double Timestamp)
+{
+	FPin Best;
+	double BestDelta = 0;
+	for (FSlot& Slot : Slots)
+	{
+		if (!TryPin(Slot))
+		{
+			continue;
+		}
+		FPin Candidate(&Slot);
+		if (Candidate.GetGeneration() == 0)
+		{
+			continue;
+		}
+		const double Delta = FMath::Abs(Candidate.GetTimestamp() - Timestamp);
+		if (!Best.IsValid() || Delta < BestDelta)
+		{
+			BestDelta = Delta;
+			Best = MoveTemp(Candidate);
+		}
+	}
+	return Best;
+}
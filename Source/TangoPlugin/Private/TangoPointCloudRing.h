@@ -0,0 +1,112 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+#pragma once
+
+#if PLATFORM_ANDROID
+#include "tango_client_api.h"
+#endif
+
+/**
+ * A fixed number of owned depth frames, written by the Tango depth callback and read from any thread.
+ * The writer never waits: it claims a slot that no reader has pinned, fills it and publishes it
+ * under a new generation number. If every slot is pinned the frame is dropped instead.
+ * Readers pin a slot by generation, which keeps it from being recycled until the pin is released.
+ */
+class TangoPointCloudRing
+{
+	struct FSlot
+	{
+		FSlot() : NumPoints(0), Timestamp(0), Generation(0), State(0) {}
+
+		//Packed {X, Y, Z, C} values in meters, in the depth camera frame
+		TArray<FVector4> Points;
+		int32 NumPoints;
+		double Timestamp;
+		//0 while the slot has never been published
+		volatile int64 Generation;
+		//-1 while the writer owns the slot, otherwise the number of pins held on it
+		volatile int32 State;
+#if PLATFORM_ANDROID
+		//Points viewed as a TangoPointCloud so it can be passed to the support library
+		TangoPointCloud Cloud;
+#endif
+	};
+
+public:
+	/** A read-only reference to one published depth frame. Releases the slot when destroyed. */
+	class FPin
+	{
+	public:
+		FPin() : Slot(nullptr) {}
+		FPin(FPin&& Other) : Slot(Other.Slot) { Other.Slot = nullptr; }
+		FPin& operator=(FPin&& Other)
+		{
+			if (this != &Other)
+			{
+				Release();
+				Slot = Other.Slot;
+				Other.Slot = nullptr;
+			}
+			return *this;
+		}
+		~FPin() { Release(); }
+
+		bool IsValid() const { return Slot != nullptr; }
+		int32 Num() const { return Slot ? Slot->NumPoints : 0; }
+		const FVector4* GetPoints() const { return Slot ? Slot->Points.GetData() : nullptr; }
+		double GetTimestamp() const { return Slot ? Slot->Timestamp : 0.0; }
+		int64 GetGeneration() const { return Slot ? Slot->Generation : 0; }
+#if PLATFORM_ANDROID
+		const TangoPointCloud* GetTangoPointCloud() const { return Slot ? &Slot->Cloud : nullptr; }
+#endif
+		void Release();
+
+	private:
+		friend class TangoPointCloudRing;
+		explicit FPin(FSlot* InSlot) : Slot(InSlot) {}
+		FPin(const FPin&) = delete;
+		FPin& operator=(const FPin&) = delete;
+
+		FSlot* Slot;
+	};
+
+	TangoPointCloudRing(int32 NumSlots, int32 InMaxPoints);
+
+	/** Copies a depth frame into a free slot and publishes it. Returns false if the frame had to be dropped. */
+	bool Write(const float(*InPoints)[4], uint32 InNumPoints, double InTimestamp);
+
+	/** Pins the most recently published frame. */
+	FPin PinLatest();
+	/** Pins the published frame whose timestamp is closest to Timestamp. */
+	FPin PinNearest(double Timestamp);
+	/** Pins the frame with the given generation, if it is still held by the ring. */
+	FPin Pin(int64 Generation);
+
+	int64 GetLatestGeneration() const;
+	int32 GetDroppedFrameCount() const { return DroppedFrames.GetValue(); }
+	int32 GetMaxPoints() const { return MaxPoints; }
+	int32 GetNumSlots() const { return Slots.Num(); }
+
+private:
+	static bool TryPin(FSlot& Slot);
+	static int64 ReadGeneration(const volatile int64& Generation);
+
+	TArray<FSlot> Slots;
+	volatile int64 LatestGeneration;
+	//Only touched by the writer
+	int64 NextGeneration;
+	FThreadSafeCounter DroppedFrames;
+	int32 MaxPoints;
+};
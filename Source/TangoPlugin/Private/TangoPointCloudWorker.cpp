@@ -0,0 +1,80 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+#include "TangoPluginPrivatePCH.h"
+#include "TangoPointCloudWorker.h"
+
+TangoPointCloudWorker::TangoPointCloudWorker()
+	: Thread(nullptr)
+{
+	FrameEvent = FPlatformProcess::GetSynchEventFromPool();
+}
+
+TangoPointCloudWorker::~TangoPointCloudWorker()
+{
+	check(Thread == nullptr);
+	FPlatformProcess::ReturnSynchEventToPool(FrameEvent);
+	FrameEvent = nullptr;
+}
+
+void TangoPointCloudWorker::StartThread(const TCHAR* ThreadName)
+{
+	bRunning = true;
+	Thread = FRunnableThread::Create(this, ThreadName);
+}
+
+void TangoPointCloudWorker::StopThread()
+{
+	if (Thread != nullptr)
+	{
+		Stop();
+		Thread->WaitForCompletion();
+		delete Thread;
+		Thread = nullptr;
+	}
+}
+
+void TangoPointCloudWorker::Stop()
+{
+	bRunning = false;
+	FrameEvent->Trigger();
+}
+
+void TangoPointCloudWorker::PushFrame(const FTangoPointCloudFramePtr& Frame)
+{
+	{
+		FScopeLock Lock(&PendingLock);
+		PendingFrame = Frame;
+	}
+	FrameEvent->Trigger();
+}
+
+uint32 TangoPointCloudWorker::Run()
+{
+	while (bRunning)
+	{
+		FrameEvent->Wait(100);
+		FTangoPointCloudFramePtr Frame;
+		{
+			FScopeLock Lock(&PendingLock);
+			Frame = PendingFrame;
+			PendingFrame.Reset();
+		}
+		if (bRunning && Frame.IsValid())
+		{
+			ProcessFrame(*Frame);
+		}
+	}
+	return 0;
+}
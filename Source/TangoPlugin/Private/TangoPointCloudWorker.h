@@ -0,0 +1,49 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+#pragma once
+
+#include "TangoPointCloudComponent.h"
+
+/**
+ * Base for consumers that process converted depth frames on their own thread.
+ * Frames are pushed from the game thread. If the worker is busy, a newer frame replaces the waiting one.
+ * Derived classes must call StopThread in their destructor, before their own members are destroyed.
+ */
+class TangoPointCloudWorker : public FRunnable
+{
+public:
+	TangoPointCloudWorker();
+	virtual ~TangoPointCloudWorker();
+
+	void PushFrame(const FTangoPointCloudFramePtr& Frame);
+
+	//FRunnable interface
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+protected:
+	void StartThread(const TCHAR* ThreadName);
+	void StopThread();
+
+	/** Called on the worker thread for every frame it picks up. */
+	virtual void ProcessFrame(const FTangoPointCloudFrame& Frame) = 0;
+
+private:
+	FRunnableThread* Thread;
+	FEvent* FrameEvent;
+	FThreadSafeBool bRunning;
+	FCriticalSection PendingLock;
+	FTangoPointCloudFramePtr PendingFrame;
+};
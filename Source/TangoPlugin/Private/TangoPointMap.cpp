@@ -0,0 +1,215 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+#include "TangoPluginPrivatePCH.h"
+#include "TangoPointMap.h"
+
+DECLARE_CYCLE_STAT(TEXT("Point Map Integration"), STAT_TangoPointMapIntegration, STATGROUP_Tango);
+
+namespace
+{
+	//Rough cost of one voxel: the voxel itself plus its entry in the lookup map
+	static const int64 BytesPerVoxel = sizeof(uint64) + sizeof(int32) + 24 + 48;
+	//The mean moves slower than 1/N once a voxel has been seen this often, so it can still follow small corrections
+	static const int32 MaxMeanWeight = 64;
+}
+
+TangoPointMap::TangoPointMap(float InVoxelSize, int64 MaxMemoryBytes)
+	: VoxelSize(FMath::Max(InVoxelSize, 0.1f))
+	, MaxVoxels((int32)FMath::Clamp<int64>(MaxMemoryBytes / BytesPerVoxel, 1024, MAX_int32))
+	, Newest(INDEX_NONE)
+	, Oldest(INDEX_NONE)
+{
+	StartThread(TEXT("TangoPointMap"));
+}
+
+TangoPointMap::~TangoPointMap()
+{
+	StopThread();
+}
+
+uint64 TangoPointMap::GetKey(const FVector& Point) const
+{
+	const uint64 Mask = (1ull << 21) - 1;
+	const int32 Bias = 1 << 20;
+	const uint64 X = (uint64)(FMath::FloorToInt(Point.X / VoxelSize) + Bias) & Mask;
+	const uint64 Y = (uint64)(FMath::FloorToInt(Point.Y / VoxelSize) + Bias) & Mask;
+	const uint64 Z = (uint64)(FMath::FloorToInt(Point.Z / VoxelSize) + Bias) & Mask;
+	return X | (Y << 21) | (Z << 42);
+}
+
+void TangoPointMap::Unlink(int32 Index)
+{
+	FVoxel& Voxel = Voxels[Index];
+	if (Voxel.Newer != INDEX_NONE)
+	{
+		Voxels[Voxel.Newer].Older = Voxel.Older;
+	}
+	else
+	{
+		Newest = Voxel.Older;
+	}
+	if (Voxel.Older != INDEX_NONE)
+	{
+		Voxels[Voxel.Older].Newer = Voxel.Newer;
+	}
+	else
+	{
+		Oldest = Voxel.Newer;
+	}
+	Voxel.Newer = INDEX_NONE;
+	Voxel.Older = INDEX_NONE;
+}
+
+void TangoPointMap::LinkAsNewest(int32 Index)
+{
+	FVoxel& Voxel = Voxels[Index];
+	Voxel.Newer = INDEX_NONE;
+	Voxel.Older = Newest;
+	if (Newest != INDEX_NONE)
+	{
+		Voxels[Newest].Newer = Index;
+	}
+	Newest = Index;
+	if (Oldest == INDEX_NONE)
+	{
+		Oldest = Index;
+	}
+}
+
+void TangoPointMap::Touch(int32 Index)
+{
+	if (Newest != Index)
+	{
+		Unlink(Index);
+		LinkAsNewest(Index);
+	}
+}
+
+void TangoPointMap::EvictOldest()
+{
+	const int32 Index = Oldest;
+	Unlink(Index);
+	Lookup.Remove(Voxels[Index].Key);
+	FreeVoxels.Add(Index);
+}
+
+void TangoPointMap::ProcessFrame(const FTangoPointCloudFrame& Frame)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TangoPointMapIntegration);
+	FScopeLock Lock(&MapLock);
+	for (const FVector& Point : Frame.Points)
+	{
+		const uint64 Key = GetKey(Point);
+		int32* Found = Lookup.Find(Key);
+		if (Found != nullptr)
+		{
+			FVoxel& Voxel = Voxels[*Found];
+			Voxel.Observations++;
+			Voxel.Mean += (Point - Voxel.Mean) / (float)FMath::Min(Voxel.Observations, MaxMeanWeight);
+			Touch(*Found);
+			continue;
+		}
+
+		if (Lookup.Num() >= MaxVoxels)
+		{
+			EvictOldest();
+		}
+		int32 Index;
+		if (FreeVoxels.Num() > 0)
+		{
+			Index = FreeVoxels.Pop(false);
+		}
+		else
+		{
+			Index = Voxels.AddUninitialized();
+		}
+		FVoxel& Voxel = Voxels[Index];
+		Voxel.Mean = Point;
+		Voxel.Observations = 1;
+		Voxel.Key = Key;
+		Lookup.Add(Key, Index);
+		LinkAsNewest(Index);
+	}
+}
+
+void TangoPointMap::GetPoints(TArray<FVector>& OutPoints, int32 MinObservations) const
+{
+	FScopeLock Lock(&MapLock);
+	OutPoints.Reset(Lookup.Num());
+	for (const auto& Elem : Lookup)
+	{
+		const FVoxel& Voxel = Voxels[Elem.Value];
+		if (Voxel.Observations >= MinObservations)
+		{
+			OutPoints.Add(Voxel.Mean);
+		}
+	}
+}
+
+void TangoPointMap::GetPointsInBox(const FBox& Box, TArray<FVector>& OutPoints, int32 MinObservations) const
+{
+	FScopeLock Lock(&MapLock);
+	OutPoints.Reset();
+	const FVector Size = Box.GetSize() / VoxelSize;
+	//Small boxes are cheaper to look up voxel by voxel than to scan the whole map
+	if ((double)(Size.X + 2) * (Size.Y + 2) * (Size.Z + 2) < Lookup.Num())
+	{
+		for (float X = Box.Min.X; X < Box.Max.X + VoxelSize; X += VoxelSize)
+		{
+			for (float Y = Box.Min.Y; Y < Box.Max.Y + VoxelSize; Y += VoxelSize)
+			{
+				for (float Z = Box.Min.Z; Z < Box.Max.Z + VoxelSize; Z += VoxelSize)
+				{
+					const int32* Found = Lookup.Find(GetKey(FVector(X, Y, Z)));
+					if (Found != nullptr && Voxels[*Found].Observations >= MinObservations && Box.IsInside(Voxels[*Found].Mean))
+					{
+						OutPoints.Add(Voxels[*Found].Mean);
+					}
+				}
+			}
+		}
+		return;
+	}
+	for (const auto& Elem : Lookup)
+	{
+		const FVoxel& Voxel = Voxels[Elem.Value];
+		if (Voxel.Observations >= MinObservations && Box.IsInside(Voxel.Mean))
+		{
+			OutPoints.Add(Voxel.Mean);
+		}
+	}
+}
+
+void TangoPointMap::Clear()
+{
+	FScopeLock Lock(&MapLock);
+	Lookup.Reset();
+	Voxels.Reset();
+	FreeVoxels.Reset();
+	Newest = INDEX_NONE;
+	Oldest = INDEX_NONE;
+}
+
+int32 TangoPointMap::GetNumVoxels() const
+{
+	FScopeLock Lock(&MapLock);
+	return Lookup.Num();
+}
+
+int64 TangoPointMap::GetMemoryUsage() const
+{
+	FScopeLock Lock(&MapLock);
+	return Lookup.GetAllocatedSize() + Voxels.GetAllocatedSize() + FreeVoxels.GetAllocatedSize();
+}
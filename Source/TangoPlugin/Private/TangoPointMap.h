@@ -0,0 +1,71 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+#pragma once
+
+#include "TangoPointCloudWorker.h"
+
+/**
+ * Fuses successive depth frames into a persistent hashed voxel map.
+ * Each voxel holds the running mean of the points that fell into it. When the map reaches its memory cap,
+ * the voxels that were observed least recently are evicted first.
+ * Frames are integrated on the worker thread, the read functions may be called from any thread.
+ */
+class TangoPointMap : public TangoPointCloudWorker
+{
+public:
+	TangoPointMap(float InVoxelSize, int64 MaxMemoryBytes);
+	virtual ~TangoPointMap();
+
+	/** Voxel means of all voxels seen at least MinObservations times. */
+	void GetPoints(TArray<FVector>& OutPoints, int32 MinObservations) const;
+	/** Voxel means inside Box of all voxels seen at least MinObservations times. */
+	void GetPointsInBox(const FBox& Box, TArray<FVector>& OutPoints, int32 MinObservations) const;
+
+	void Clear();
+	int32 GetNumVoxels() const;
+	int32 GetMaxVoxels() const { return MaxVoxels; }
+	int64 GetMemoryUsage() const;
+
+protected:
+	virtual void ProcessFrame(const FTangoPointCloudFrame& Frame) override;
+
+private:
+	struct FVoxel
+	{
+		FVector Mean;
+		int32 Observations;
+		uint64 Key;
+		//Neighbours in the recency list, INDEX_NONE at the ends
+		int32 Newer;
+		int32 Older;
+	};
+
+	uint64 GetKey(const FVector& Point) const;
+	void LinkAsNewest(int32 Index);
+	void Touch(int32 Index);
+	void Unlink(int32 Index);
+	void EvictOldest();
+
+	float VoxelSize;
+	int32 MaxVoxels;
+
+	mutable FCriticalSection MapLock;
+	TMap<uint64, int32> Lookup;
+	TArray<FVoxel> Voxels;
+	//Slots in Voxels freed by eviction
+	TArray<int32> FreeVoxels;
+	int32 Newest;
+	int32 Oldest;
+};
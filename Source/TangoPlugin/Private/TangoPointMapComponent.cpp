@@ -0,0 +1,107 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+#include "TangoPluginPrivatePCH.h"
+#include "TangoPointMapComponent.h"
+#include "TangoPointMap.h"
+#include "TangoDevice.h"
+
+UTangoPointMapComponent::UTangoPointMapComponent() : Super(),
+	MapSpace(ETangoPointSpace::ADF_DEPTH),
+	bUseFilteredPoints(false),
+	VoxelSize(5.0f),
+	MaxMemoryMB(64),
+	MinObservations(2),
+	PointMap(nullptr),
+	LastPushedGeneration(0)
+{
+	bWantsInitializeComponent = false;
+	PrimaryComponentTick.bCanEverTick = true;
+}
+
+void UTangoPointMapComponent::BeginPlay()
+{
+	Super::BeginPlay();
+	if (MapSpace == ETangoPointSpace::LOCAL)
+	{
+		UE_LOG(TangoPlugin, Warning, TEXT("UTangoPointMapComponent::BeginPlay: A point map cannot be built in depth space, using ADF space instead"));
+		MapSpace = ETangoPointSpace::ADF_DEPTH;
+	}
+	PointMap = new TangoPointMap(VoxelSize, (int64)FMath::Max(MaxMemoryMB, 1) * 1024 * 1024);
+	TangoDevicePointCloud::AddStreamRequest(MapSpace, bUseFilteredPoints);
+	UE_LOG(TangoPlugin, Log, TEXT("UTangoPointMapComponent::BeginPlay: Point map holds up to %d voxels"), PointMap->GetMaxVoxels());
+}
+
+void UTangoPointMapComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (PointMap != nullptr)
+	{
+		TangoDevicePointCloud::RemoveStreamRequest(MapSpace, bUseFilteredPoints);
+		delete PointMap;
+		PointMap = nullptr;
+	}
+	Super::EndPlay(EndPlayReason);
+}
+
+void UTangoPointMapComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	if (PointMap != nullptr && UTangoDevice::Get().GetTangoDevicePointCloudPointer() != nullptr)
+	{
+		FTangoPointCloudFramePtr Frame = UTangoDevice::Get().GetTangoDevicePointCloudPointer()->GetLatestFrame(MapSpace, bUseFilteredPoints);
+		if (Frame.IsValid() && Frame->Generation != LastPushedGeneration)
+		{
+			LastPushedGeneration = Frame->Generation;
+			PointMap->PushFrame(Frame);
+		}
+	}
+}
+
+TArray<FVector> UTangoPointMapComponent::GetMapPoints()
+{
+	TArray<FVector> Result;
+	if (PointMap != nullptr)
+	{
+		PointMap->GetPoints(Result, MinObservations);
+	}
+	return Result;
+}
+
+TArray<FVector> UTangoPointMapComponent::GetMapPointsInBox(const FBox& Box)
+{
+	TArray<FVector> Result;
+	if (PointMap != nullptr)
+	{
+		PointMap->GetPointsInBox(Box, Result, MinObservations);
+	}
+	return Result;
+}
+
+int32 UTangoPointMapComponent::GetNumVoxels()
+{
+	return PointMap != nullptr ? PointMap->GetNumVoxels() : 0;
+}
+
+float UTangoPointMapComponent::GetMemoryUsage()
+{
+	return PointMap != nullptr ? PointMap->GetMemoryUsage() / (1024.0f * 1024.0f) : 0.0f;
+}
+
+void UTangoPointMapComponent::ClearMap()
+{
+	if (PointMap != nullptr)
+	{
+		PointMap->Clear();
+	}
+}
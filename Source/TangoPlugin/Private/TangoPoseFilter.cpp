@@ -0,0 +1,227 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+
+
+#include "TangoPluginPrivatePCH.h"
+#include "TangoPoseFilter.h"
+
+namespace
+{
+	//Callbacks arrive at about 100 Hz. After a longer gap the filtered pose is too stale to blend with,
+	//the filter restarts from the new pose instead of sliding across the gap.
+	static const double MaxFilterGap = 0.1;
+	//Velocity variance a Kalman filter starts with, in (meters or radians per second)^2
+	static const float InitialVelocityVariance = 1.0f;
+
+	//Blend factor of a first order low pass filter with the given cutoff frequency in Hz
+	float CutoffAlpha(float DeltaTime, float Cutoff)
+	{
+		const float Tau = 1.0f / (2.0f * PI * FMath::Max(Cutoff, KINDA_SMALL_NUMBER));
+		return 1.0f / (1.0f + Tau / DeltaTime);
+	}
+
+	//Rotation axis scaled by the angle that turns From into To, the shorter way round
+	FVector RotationBetween(const FQuat& From, const FQuat& To)
+	{
+		FVector Axis;
+		float Angle;
+		(To * From.Inverse()).ToAxisAndAngle(Axis, Angle);
+		if (Angle > PI)
+		{
+			Angle -= 2.0f * PI;
+		}
+		return Axis * Angle;
+	}
+
+	FQuat Rotate(const FQuat& Rotation, const FVector& RotationVector)
+	{
+		const float Angle = RotationVector.Size();
+		if (Angle <= KINDA_SMALL_NUMBER)
+		{
+			return Rotation;
+		}
+		FQuat Result = FQuat(RotationVector / Angle, Angle) * Rotation;
+		Result.Normalize();
+		return Result;
+	}
+}
+
+TangoPoseFilter::TangoPoseFilter()
+	: ClearGeneration(0)
+{
+}
+
+void TangoPoseFilter::SetSettings(const FTangoCoordinateFramePair& Pair, const FTangoPoseFilterSettings& InSettings)
+{
+	FSlot& Slot = Slots[TangoPoseTable::GetSlotIndex(Pair)];
+	const int32 Sequence = Slot.SettingsSequence;
+	FPlatformAtomics::InterlockedExchange(&Slot.SettingsSequence, Sequence + 1);
+	Slot.Settings = InSettings;
+	Slot.Settings.SmoothingTime = FMath::Max(InSettings.SmoothingTime, 0.0f);
+	Slot.Settings.MinCutoff = FMath::Max(InSettings.MinCutoff, 0.0f);
+	Slot.Settings.Beta = FMath::Max(InSettings.Beta, 0.0f);
+	Slot.Settings.DerivativeCutoff = FMath::Max(InSettings.DerivativeCutoff, 0.0f);
+	Slot.Settings.ProcessNoise = FMath::Max(InSettings.ProcessNoise, 0.0f);
+	Slot.Settings.MeasurementNoise = FMath::Max(InSettings.MeasurementNoise, 0.0f);
+	FPlatformAtomics::InterlockedExchange(&Slot.SettingsSequence, Sequence + 2);
+}
+
+FTangoPoseFilterSettings TangoPoseFilter::GetSettings(const FTangoCoordinateFramePair& Pair) const
+{
+	//The game thread is the only one changing the settings
+	return Slots[TangoPoseTable::GetSlotIndex(Pair)].Settings;
+}
+
+void TangoPoseFilter::Clear()
+{
+	FPlatformAtomics::InterlockedIncrement(&ClearGeneration);
+}
+
+bool TangoPoseFilter::FilterPose(const FTangoCoordinateFramePair& Pair, FTangoPoseData& Pose, double Timestamp)
+{
+	FSlot& Slot = Slots[TangoPoseTable::GetSlotIndex(Pair)];
+	const int32 SettingsSequence = Slot.SettingsSequence;
+	if (SettingsSequence != Slot.AppliedSequence && !(SettingsSequence & 1))
+	{
+		FPlatformMisc::MemoryBarrier();
+		const FTangoPoseFilterSettings Settings = Slot.Settings;
+		FPlatformMisc::MemoryBarrier();
+		//If the game thread got in the way, keep the old settings and look again with the next pose
+		if (Slot.SettingsSequence == SettingsSequence)
+		{
+			Slot.Applied = Settings;
+			Slot.AppliedSequence = SettingsSequence;
+			Slot.bHasState = false;
+		}
+	}
+	if (Slot.AppliedSequence == 0 || Slot.Applied.FilterType == ETangoPoseFilterType::NONE)
+	{
+		return false;
+	}
+
+	const int32 Generation = ClearGeneration;
+	FState& State = Slot.State;
+	if (Pose.StatusCode != ETangoPoseStatus::VALID)
+	{
+		//Tracking was lost or reset, there is nothing to smooth towards
+		Slot.bHasState = false;
+		return false;
+	}
+	if (!Slot.bHasState || Slot.ClearGeneration != Generation || Timestamp - State.Timestamp > MaxFilterGap)
+	{
+		StartState(State, Pose, Timestamp, Slot.Applied);
+		Slot.ClearGeneration = Generation;
+		Slot.bHasState = true;
+	}
+	else if (Timestamp > State.Timestamp)
+	{
+		const float DeltaTime = (float)(Timestamp - State.Timestamp);
+		switch (Slot.Applied.FilterType)
+		{
+		case ETangoPoseFilterType::EXPONENTIAL:
+			UpdateExponential(State, Pose, DeltaTime, Slot.Applied);
+			break;
+		case ETangoPoseFilterType::ONE_EURO:
+			UpdateOneEuro(State, Pose, DeltaTime, Slot.Applied);
+			break;
+		case ETangoPoseFilterType::KALMAN:
+			UpdateKalman(State, Pose, DeltaTime, Slot.Applied);
+			break;
+		default:
+			break;
+		}
+		State.Timestamp = Timestamp;
+	}
+	//Out of order or repeated poses get the current estimate without advancing it
+
+	Pose.Position = State.Position;
+	Pose.QuatRotation = State.Rotation;
+	Pose.Rotation = State.Rotation.Rotator();
+	return true;
+}
+
+void TangoPoseFilter::StartState(FState& State, const FTangoPoseData& Pose, double Timestamp, const FTangoPoseFilterSettings& Settings)
+{
+	State.Timestamp = Timestamp;
+	State.Position = Pose.Position;
+	State.Rotation = Pose.QuatRotation;
+	State.LinearVelocity = FVector::ZeroVector;
+	State.AngularVelocity = FVector::ZeroVector;
+	State.PositionCovariance.Position = Settings.MeasurementNoise;
+	State.PositionCovariance.Cross = 0.0f;
+	State.PositionCovariance.Velocity = InitialVelocityVariance;
+	State.RotationCovariance = State.PositionCovariance;
+}
+
+void TangoPoseFilter::UpdateExponential(FState& State, const FTangoPoseData& Pose, float DeltaTime, const FTangoPoseFilterSettings& Settings)
+{
+	//Behaves the same whatever the spacing of the callbacks
+	const float Alpha = Settings.SmoothingTime > 0.0f ? 1.0f - FMath::Exp(-DeltaTime / Settings.SmoothingTime) : 1.0f;
+	State.Position = FMath::Lerp(State.Position, Pose.Position, Alpha);
+	State.Rotation = FQuat::Slerp(State.Rotation, Pose.QuatRotation, Alpha);
+	State.Rotation.Normalize();
+}
+
+void TangoPoseFilter::UpdateOneEuro(FState& State, const FTangoPoseData& Pose, float DeltaTime, const FTangoPoseFilterSettings& Settings)
+{
+	//Casiez et al., the cutoff rises with speed: heavy smoothing at rest, little lag while moving
+	const float DerivativeAlpha = CutoffAlpha(DeltaTime, Settings.DerivativeCutoff);
+
+	const FVector RawLinearVelocity = (Pose.Position - State.Position) / DeltaTime;
+	State.LinearVelocity = FMath::Lerp(State.LinearVelocity, RawLinearVelocity, DerivativeAlpha);
+	const float PositionAlpha = CutoffAlpha(DeltaTime, Settings.MinCutoff + Settings.Beta * State.LinearVelocity.Size());
+	State.Position = FMath::Lerp(State.Position, Pose.Position, PositionAlpha);
+
+	const FVector RawAngularVelocity = RotationBetween(State.Rotation, Pose.QuatRotation) / DeltaTime;
+	State.AngularVelocity = FMath::Lerp(State.AngularVelocity, RawAngularVelocity, DerivativeAlpha);
+	const float RotationAlpha = CutoffAlpha(DeltaTime, Settings.MinCutoff + Settings.Beta * State.AngularVelocity.Size());
+	State.Rotation = FQuat::Slerp(State.Rotation, Pose.QuatRotation, RotationAlpha);
+	State.Rotation.Normalize();
+}
+
+void TangoPoseFilter::UpdateKalman(FState& State, const FTangoPoseData& Pose, float DeltaTime, const FTangoPoseFilterSettings& Settings)
+{
+	//Constant velocity model driven by white noise acceleration, the measurement is the pose itself.
+	//Returns the gains of the measured value and of the velocity.
+	auto Step = [DeltaTime, &Settings](FCovariance& P, float& PositionGain, float& VelocityGain)
+	{
+		const float Q = Settings.ProcessNoise;
+		const float DeltaTime2 = DeltaTime * DeltaTime;
+		P.Position += DeltaTime * (2.0f * P.Cross + DeltaTime * P.Velocity) + Q * DeltaTime2 * DeltaTime / 3.0f;
+		P.Cross += DeltaTime * P.Velocity + Q * DeltaTime2 * 0.5f;
+		P.Velocity += Q * DeltaTime;
+
+		const float Innovation = P.Position + Settings.MeasurementNoise;
+		PositionGain = Innovation > SMALL_NUMBER ? P.Position / Innovation : 1.0f;
+		VelocityGain = Innovation > SMALL_NUMBER ? P.Cross / Innovation : 0.0f;
+		P.Velocity -= VelocityGain * P.Cross;
+		P.Position *= 1.0f - PositionGain;
+		P.Cross *= 1.0f - PositionGain;
+	};
+
+	float PositionGain, VelocityGain;
+	Step(State.PositionCovariance, PositionGain, VelocityGain);
+	State.Position += State.LinearVelocity * DeltaTime;
+	const FVector PositionResidual = Pose.Position - State.Position;
+	State.Position += PositionResidual * PositionGain;
+	State.LinearVelocity += PositionResidual * VelocityGain;
+
+	//Rotations are filtered as small rotation vectors around the predicted rotation
+	Step(State.RotationCovariance, PositionGain, VelocityGain);
+	State.Rotation = Rotate(State.Rotation, State.AngularVelocity * DeltaTime);
+	const FVector RotationResidual = RotationBetween(State.Rotation, Pose.QuatRotation);
+	State.Rotation = Rotate(State.Rotation, RotationResidual * PositionGain);
+	State.AngularVelocity += RotationResidual * VelocityGain;
+}
@@ -0,0 +1,91 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+
+
+#pragma once
+
+#include "TangoDataTypes.h"
+#include "TangoPoseTable.h"
+
+/**
+ * Smooths the poses of a frame pair as they arrive from the Tango pose callback, so every consumer sees the same
+ * filtered pose instead of running its own smoothing on the game thread. The filter state of a pair is advanced by
+ * each pose, never recomputed per query. Poses are kept in Tango conventions, distances in meters.
+ * Filtering runs on the callback thread only and never waits: settings are published to it through a
+ * seqlock per frame pair, a change is picked up with the next pose of the pair.
+ */
+class TangoPoseFilter
+{
+public:
+	TangoPoseFilter();
+
+	/** Selects the filter of Pair, a filter type of NONE turns it off. Game thread only. */
+	void SetSettings(const FTangoCoordinateFramePair& Pair, const FTangoPoseFilterSettings& InSettings);
+	FTangoPoseFilterSettings GetSettings(const FTangoCoordinateFramePair& Pair) const;
+
+	/**
+	 * Advances the filter of Pair with Pose and replaces its position and rotation with the filtered ones.
+	 * Returns false and leaves Pose alone if Pair has no filter. Writer thread only.
+	 */
+	bool FilterPose(const FTangoCoordinateFramePair& Pair, FTangoPoseData& Pose, double Timestamp);
+	/** Restarts the filters of all pairs from their next pose. Any thread. */
+	void Clear();
+
+private:
+	//Covariance of a constant velocity model along one axis. The axes share it, as they have the same noise.
+	struct FCovariance
+	{
+		float Position;
+		float Cross;
+		float Velocity;
+	};
+
+	struct FState
+	{
+		double Timestamp;
+		FVector Position;
+		FQuat Rotation;
+		//One Euro: smoothed derivatives the cutoff is adapted from. Kalman: velocity estimates.
+		//Units per second, angular as a rotation axis in the base frame scaled by radians per second.
+		FVector LinearVelocity;
+		FVector AngularVelocity;
+		FCovariance PositionCovariance;
+		FCovariance RotationCovariance;
+	};
+
+	struct FSlot
+	{
+		FSlot() : SettingsSequence(0), AppliedSequence(0), ClearGeneration(0), bHasState(false) {}
+		//Odd while the game thread is changing Settings, 0 if it never did
+		volatile int32 SettingsSequence;
+		FTangoPoseFilterSettings Settings;
+
+		//The rest is only touched by the writer thread
+		int32 AppliedSequence;
+		FTangoPoseFilterSettings Applied;
+		//Value of ClearGeneration when State was started, older states are dropped
+		int32 ClearGeneration;
+		bool bHasState;
+		FState State;
+	};
+
+	static void StartState(FState& State, const FTangoPoseData& Pose, double Timestamp, const FTangoPoseFilterSettings& Settings);
+	static void UpdateExponential(FState& State, const FTangoPoseData& Pose, float DeltaTime, const FTangoPoseFilterSettings& Settings);
+	static void UpdateOneEuro(FState& State, const FTangoPoseData& Pose, float DeltaTime, const FTangoPoseFilterSettings& Settings);
+	static void UpdateKalman(FState& State, const FTangoPoseData& Pose, float DeltaTime, const FTangoPoseFilterSettings& Settings);
+
+	volatile int32 ClearGeneration;
+	FSlot Slots[TangoPoseTable::NumSlots];
+};
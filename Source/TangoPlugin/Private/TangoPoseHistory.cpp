@@ -0,0 +1,280 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+
+#include "TangoPluginPrivatePCH.h"
+#include "TangoPoseHistory.h"
+
+namespace
+{
+	//Callbacks arrive at about 100 Hz. Two poses further apart than this mean callbacks were missed,
+	//and interpolating between them would hide whatever the device did in between.
+	static const double MaxInterpolationGap = 0.1;
+}
+
+TangoPoseHistory::TangoPoseHistory(int32 InCapacity)
+	: Capacity(FMath::Max(InCapacity, 2))
+	, ClearGeneration(0)
+{
+	for (int32 i = 0; i < TangoPoseTable::NumSlots; ++i)
+	{
+		Rings[i] = nullptr;
+	}
+}
+
+TangoPoseHistory::~TangoPoseHistory()
+{
+	for (int32 i = 0; i < TangoPoseTable::NumSlots; ++i)
+	{
+		delete Rings[i];
+		Rings[i] = nullptr;
+	}
+}
+
+void TangoPoseHistory::AddPose(const FTangoCoordinateFramePair& Pair, const FTangoPoseData& Pose, double Timestamp)
+{
+	const int32 SlotIndex = TangoPoseTable::GetSlotIndex(Pair);
+	FRing* Ring = Rings[SlotIndex];
+	if (Ring == nullptr)
+	{
+		Ring = new FRing(Capacity);
+		Ring->ClearGeneration = ClearGeneration;
+		//Publish the ring only once it is fully constructed
+		FPlatformAtomics::InterlockedExchangePtr((void**)&Rings[SlotIndex], Ring);
+	}
+
+	const int32 Sequence = Ring->Sequence;
+	FPlatformAtomics::InterlockedExchange(&Ring->Sequence, Sequence + 1);
+	const int32 Generation = ClearGeneration;
+	if (Ring->ClearGeneration != Generation || Pose.StatusCode != ETangoPoseStatus::VALID)
+	{
+		Ring->Num = 0;
+		Ring->ClearGeneration = Generation;
+	}
+	//Out of order or repeated poses would break the search
+	if (Pose.StatusCode == ETangoPoseStatus::VALID && (Ring->Num == 0 || Timestamp > Ring->GetByAge(Ring->Num - 1).Timestamp))
+	{
+		FSample& Sample = Ring->Samples[Ring->Head];
+		Sample.Timestamp = Timestamp;
+		Sample.Position = Pose.Position;
+		Sample.Rotation = Pose.QuatRotation;
+		Ring->Head = (Ring->Head + 1) % Capacity;
+		Ring->Num = FMath::Min(Ring->Num + 1, Capacity);
+	}
+	FPlatformAtomics::InterlockedExchange(&Ring->Sequence, Sequence + 2);
+}
+
+void TangoPoseHistory::Clear()
+{
+	FPlatformAtomics::InterlockedIncrement(&ClearGeneration);
+}
+
+bool TangoPoseHistory::GetPoseAtTime(const FTangoCoordinateFramePair& Pair, double Timestamp, FTangoPoseData& OutPose) const
+{
+	const FRing* Ring = Rings[TangoPoseTable::GetSlotIndex(Pair)];
+	if (Ring == nullptr)
+	{
+		return false;
+	}
+	FPlatformMisc::MemoryBarrier();
+	FVector Position;
+	FQuat Rotation;
+	for (;;)
+	{
+		const int32 Begin = Ring->Sequence;
+		if (Begin & 1)
+		{
+			FPlatformProcess::Sleep(0.0f);
+			continue;
+		}
+		FPlatformMisc::MemoryBarrier();
+		double SampleTimestamp = Timestamp;
+		const bool bFound = Ring->ClearGeneration == ClearGeneration && Interpolate(*Ring, SampleTimestamp, Position, Rotation);
+		FPlatformMisc::MemoryBarrier();
+		//The writer changed the ring while we were reading it, whatever we found may be torn
+		if (Ring->Sequence != Begin)
+		{
+			continue;
+		}
+		if (!bFound)
+		{
+			return false;
+		}
+		Timestamp = SampleTimestamp;
+		break;
+	}
+
+	OutPose.Position = Position;
+	OutPose.QuatRotation = Rotation;
+	OutPose.Rotation = FRotator(Rotation);
+	OutPose.FrameOfReference = Pair;
+	OutPose.Timestamp = Timestamp;
+	OutPose.PreciseTimestamp = Timestamp;
+	OutPose.StatusCode = ETangoPoseStatus::VALID;
+	return true;
+}
+
+bool TangoPoseHistory::Interpolate(const FRing& Ring, double& InOutTimestamp, FVector& OutPosition, FQuat& OutRotation) const
+{
+	//Read once, the values may change under us and are only trusted once the sequence was validated
+	const int32 Num = FMath::Clamp(Ring.Num, 0, Capacity);
+	if (Num == 0)
+	{
+		return false;
+	}
+	const double Timestamp = InOutTimestamp;
+	const FSample& Newest = Ring.GetByAge(Num - 1);
+	if (Timestamp == 0 || Timestamp == Newest.Timestamp)
+	{
+		InOutTimestamp = Newest.Timestamp;
+		OutPosition = Newest.Position;
+		OutRotation = Newest.Rotation;
+		return true;
+	}
+	if (Timestamp < Ring.GetByAge(0).Timestamp || Timestamp > Newest.Timestamp)
+	{
+		return false;
+	}
+	//First sample at or after Timestamp, there is one before it as the oldest sample is not it
+	int32 Low = 0;
+	int32 High = Num - 1;
+	while (Low < High)
+	{
+		const int32 Middle = (Low + High) / 2;
+		if (Ring.GetByAge(Middle).Timestamp < Timestamp)
+		{
+			Low = Middle + 1;
+		}
+		else
+		{
+			High = Middle;
+		}
+	}
+	return InterpolateAt(Ring, Low, Timestamp, OutPosition, OutRotation);
+}
+
+bool TangoPoseHistory::InterpolateAt(const FRing& Ring, int32 AfterAge, double Timestamp, FVector& OutPosition, FQuat& OutRotation)
+{
+	const FSample& After = Ring.GetByAge(AfterAge);
+	if (After.Timestamp == Timestamp || AfterAge == 0)
+	{
+		OutPosition = After.Position;
+		OutRotation = After.Rotation;
+		return true;
+	}
+	const FSample& Before = Ring.GetByAge(AfterAge - 1);
+	const double Gap = After.Timestamp - Before.Timestamp;
+	if (Gap <= 0 || Gap > MaxInterpolationGap)
+	{
+		return false;
+	}
+	const float Alpha = (float)((Timestamp - Before.Timestamp) / Gap);
+	OutPosition = FMath::Lerp(Before.Position, After.Position, Alpha);
+	OutRotation = FQuat::Slerp(Before.Rotation, After.Rotation, Alpha);
+	return true;
+}
+
+void TangoPoseHistory::GetPosesAtTimes(const FTangoCoordinateFramePair& Pair, const TArray<double>& Timestamps, TArray<FTangoPoseData>& OutPoses) const
+{
+	OutPoses.SetNum(Timestamps.Num());
+	for (FTangoPoseData& Pose : OutPoses)
+	{
+		Pose = FTangoPoseData();
+		Pose.StatusCode = ETangoPoseStatus::INVALID;
+	}
+	const FRing* Ring = Rings[TangoPoseTable::GetSlotIndex(Pair)];
+	if (Ring == nullptr || Timestamps.Num() == 0)
+	{
+		return;
+	}
+	FPlatformMisc::MemoryBarrier();
+
+	//Visit the timestamps in ascending order so the ring is walked once instead of searched for each of them
+	TArray<int32> Order;
+	Order.SetNumUninitialized(Timestamps.Num());
+	bool bIsSorted = true;
+	for (int32 i = 0; i < Timestamps.Num(); ++i)
+	{
+		Order[i] = i;
+		bIsSorted = bIsSorted && (i == 0 || Timestamps[i - 1] <= Timestamps[i]);
+	}
+	if (!bIsSorted)
+	{
+		Order.Sort([&Timestamps](int32 A, int32 B) { return Timestamps[A] < Timestamps[B]; });
+	}
+
+	TArray<bool> Found;
+	Found.SetNumUninitialized(Timestamps.Num());
+	for (;;)
+	{
+		const int32 Begin = Ring->Sequence;
+		if (Begin & 1)
+		{
+			FPlatformProcess::Sleep(0.0f);
+			continue;
+		}
+		FPlatformMisc::MemoryBarrier();
+		const int32 Num = Ring->ClearGeneration == ClearGeneration ? FMath::Clamp(Ring->Num, 0, Capacity) : 0;
+		int32 Cursor = 0;
+		for (int32 Index : Order)
+		{
+			FTangoPoseData& Pose = OutPoses[Index];
+			double Timestamp = Timestamps[Index];
+			Found[Index] = false;
+			if (Num == 0)
+			{
+				continue;
+			}
+			const FSample& Newest = Ring->GetByAge(Num - 1);
+			if (Timestamp == 0)
+			{
+				//The newest pose, without moving the cursor as 0 sorts first
+				Timestamp = Newest.Timestamp;
+				Found[Index] = InterpolateAt(*Ring, Num - 1, Timestamp, Pose.Position, Pose.QuatRotation);
+				Pose.PreciseTimestamp = Timestamp;
+				continue;
+			}
+			if (Timestamp < Ring->GetByAge(0).Timestamp || Timestamp > Newest.Timestamp)
+			{
+				continue;
+			}
+			//Bounded as well, in case the ring changed under us and the timestamps are torn
+			while (Cursor < Num - 1 && Ring->GetByAge(Cursor).Timestamp < Timestamp)
+			{
+				++Cursor;
+			}
+			Found[Index] = InterpolateAt(*Ring, Cursor, Timestamp, Pose.Position, Pose.QuatRotation);
+			Pose.PreciseTimestamp = Timestamp;
+		}
+		FPlatformMisc::MemoryBarrier();
+		//The writer changed the ring while we were reading it, whatever we found may be torn
+		if (Ring->Sequence == Begin)
+		{
+			break;
+		}
+	}
+
+	for (int32 i = 0; i < OutPoses.Num(); ++i)
+	{
+		if (!Found[i])
+		{
+			continue;
+		}
+		FTangoPoseData& Pose = OutPoses[i];
+		Pose.Rotation = FRotator(Pose.QuatRotation);
+		Pose.FrameOfReference = Pair;
+		Pose.Timestamp = Pose.PreciseTimestamp;
+		Pose.StatusCode = ETangoPoseStatus::VALID;
+	}
+}
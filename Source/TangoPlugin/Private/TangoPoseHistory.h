@@ -0,0 +1,84 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+
+#pragma once
+
+#include "TangoDataTypes.h"
+#include "TangoPoseTable.h"
+
+/**
+ * Recent poses per frame pair, as delivered by the Tango pose callback, so pose queries can be answered
+ * without a round trip to the service. Queries between two buffered poses are interpolated; queries outside
+ * the buffered window fail and should go to the service instead.
+ * Poses are kept in Tango conventions, exactly as the service would return them.
+ * Like TangoPoseTable, every frame pair has a fixed slot published through a seqlock: AddPose must only be
+ * called from one thread and never blocks, queries can come from any thread.
+ */
+class TangoPoseHistory
+{
+public:
+	TangoPoseHistory(int32 InCapacity = 256);
+	~TangoPoseHistory();
+
+	/** Adds a pose of Pair. An invalid pose drops the history of Pair, as tracking was lost or reset. Writer thread only. */
+	void AddPose(const FTangoCoordinateFramePair& Pair, const FTangoPoseData& Pose, double Timestamp);
+	/** Drops the history of all pairs. Any thread. */
+	void Clear();
+
+	/**
+	 * Pose of Pair at Timestamp, or the newest pose if Timestamp is 0.
+	 * Returns false if Timestamp is outside the buffered window or falls into a gap in the callbacks.
+	 */
+	bool GetPoseAtTime(const FTangoCoordinateFramePair& Pair, double Timestamp, FTangoPoseData& OutPose) const;
+
+	/**
+	 * GetPoseAtTime for many timestamps of one pair in a single pass over the buffered poses.
+	 * OutPoses matches Timestamps, poses that could not be answered have the status INVALID.
+	 */
+	void GetPosesAtTimes(const FTangoCoordinateFramePair& Pair, const TArray<double>& Timestamps, TArray<FTangoPoseData>& OutPoses) const;
+
+private:
+	struct FSample
+	{
+		double Timestamp;
+		FVector Position;
+		FQuat Rotation;
+	};
+
+	struct FRing
+	{
+		FRing(int32 Capacity) : Sequence(0), Head(0), Num(0), ClearGeneration(0) { Samples.SetNumUninitialized(Capacity); }
+		//Odd while the writer is changing the ring
+		volatile int32 Sequence;
+		TArray<FSample> Samples;
+		//Index the next sample is written to
+		int32 Head;
+		int32 Num;
+		//Value of ClearGeneration when the ring was last emptied, older rings count as empty
+		int32 ClearGeneration;
+
+		//Age 0 is the oldest buffered sample
+		const FSample& GetByAge(int32 Age) const { return Samples[(Head - Num + Age + Samples.Num()) % Samples.Num()]; }
+	};
+
+	bool Interpolate(const FRing& Ring, double& InOutTimestamp, FVector& OutPosition, FQuat& OutRotation) const;
+	//Pose at Timestamp from the first sample at or after it and the one before
+	static bool InterpolateAt(const FRing& Ring, int32 AfterAge, double Timestamp, FVector& OutPosition, FQuat& OutRotation);
+
+	int32 Capacity;
+	volatile int32 ClearGeneration;
+	//Created by the writer the first time a pair is seen and kept until destruction, so readers never see one go away
+	FRing* volatile Rings[TangoPoseTable::NumSlots];
+};
@@ -0,0 +1,193 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+
+#include "TangoPluginPrivatePCH.h"
+#include "TangoPosePredictor.h"
+
+namespace
+{
+	//Callbacks arrive at about 100 Hz. Two poses further apart than this mean callbacks were missed,
+	//the motion between them says little about the current velocity.
+	static const double MaxVelocityGap = 0.1;
+
+	FVector SmoothVelocity(const FVector& Previous, const FVector& Raw, double DeltaTime, float SmoothingTime)
+	{
+		if (SmoothingTime <= 0.0f)
+		{
+			return Raw;
+		}
+		//Exponential smoothing that behaves the same whatever the spacing of the callbacks
+		const float Alpha = 1.0f - FMath::Exp(-(float)(DeltaTime / SmoothingTime));
+		return Previous + (Raw - Previous) * Alpha;
+	}
+}
+
+TangoPosePredictor::TangoPosePredictor()
+	: ClearGeneration(0)
+{
+	SetSettings(FTangoPosePredictionSettings());
+}
+
+void TangoPosePredictor::SetSettings(const FTangoPosePredictionSettings& InSettings)
+{
+	VelocitySmoothingTime = FMath::Max(InSettings.VelocitySmoothingTime, 0.0f);
+	AngularVelocitySmoothingTime = FMath::Max(InSettings.AngularVelocitySmoothingTime, 0.0f);
+	MaxPredictionTime = FMath::Max(InSettings.MaxPredictionTime, 0.0f);
+}
+
+FTangoPosePredictionSettings TangoPosePredictor::GetSettings() const
+{
+	FTangoPosePredictionSettings Result;
+	Result.VelocitySmoothingTime = VelocitySmoothingTime;
+	Result.AngularVelocitySmoothingTime = AngularVelocitySmoothingTime;
+	Result.MaxPredictionTime = MaxPredictionTime;
+	return Result;
+}
+
+void TangoPosePredictor::AddPose(const FTangoCoordinateFramePair& Pair, const FTangoPoseData& Pose, double Timestamp)
+{
+	FSlot& Slot = Slots[TangoPoseTable::GetSlotIndex(Pair)];
+	const int32 Generation = ClearGeneration;
+	//Only this thread writes the slot, so it can be read without the sequence
+	const bool bHasPrevious = Slot.bHasPose && Slot.ClearGeneration == Generation;
+	const FMotion& Previous = Slot.Motion;
+	const bool bIsValid = Pose.StatusCode == ETangoPoseStatus::VALID;
+	if (bIsValid && bHasPrevious && Timestamp <= Previous.Timestamp)
+	{
+		//Out of order or repeated, there is no motion to learn from it
+		return;
+	}
+
+	FMotion Motion;
+	Motion.Timestamp = Timestamp;
+	Motion.Position = Pose.Position;
+	Motion.Rotation = Pose.QuatRotation;
+	Motion.LinearVelocity = FVector::ZeroVector;
+	Motion.AngularVelocity = FVector::ZeroVector;
+	Motion.bHasVelocity = false;
+	if (bIsValid && bHasPrevious && Timestamp - Previous.Timestamp <= MaxVelocityGap)
+	{
+		const double DeltaTime = Timestamp - Previous.Timestamp;
+		const FVector RawLinearVelocity = (Motion.Position - Previous.Position) / (float)DeltaTime;
+		FVector Axis;
+		float Angle;
+		(Motion.Rotation * Previous.Rotation.Inverse()).ToAxisAndAngle(Axis, Angle);
+		//The shorter way round, a delta of more than half a turn between two callbacks is not plausible
+		if (Angle > PI)
+		{
+			Angle -= 2.0f * PI;
+		}
+		const FVector RawAngularVelocity = Axis * (Angle / (float)DeltaTime);
+		if (Previous.bHasVelocity)
+		{
+			Motion.LinearVelocity = SmoothVelocity(Previous.LinearVelocity, RawLinearVelocity, DeltaTime, VelocitySmoothingTime);
+			Motion.AngularVelocity = SmoothVelocity(Previous.AngularVelocity, RawAngularVelocity, DeltaTime, AngularVelocitySmoothingTime);
+		}
+		else
+		{
+			Motion.LinearVelocity = RawLinearVelocity;
+			Motion.AngularVelocity = RawAngularVelocity;
+		}
+		Motion.bHasVelocity = true;
+	}
+
+	const int32 Sequence = Slot.Sequence;
+	FPlatformAtomics::InterlockedExchange(&Slot.Sequence, Sequence + 1);
+	Slot.ClearGeneration = Generation;
+	Slot.bHasPose = bIsValid;
+	Slot.Motion = Motion;
+	FPlatformAtomics::InterlockedExchange(&Slot.Sequence, Sequence + 2);
+}
+
+void TangoPosePredictor::Clear()
+{
+	FPlatformAtomics::InterlockedIncrement(&ClearGeneration);
+}
+
+bool TangoPosePredictor::ReadMotion(const FTangoCoordinateFramePair& Pair, FMotion& OutMotion) const
+{
+	const FSlot& Slot = Slots[TangoPoseTable::GetSlotIndex(Pair)];
+	for (;;)
+	{
+		const int32 Begin = Slot.Sequence;
+		if (Begin == 0)
+		{
+			return false;
+		}
+		if (Begin & 1)
+		{
+			FPlatformProcess::Sleep(0.0f);
+			continue;
+		}
+		FPlatformMisc::MemoryBarrier();
+		const bool bHasPose = Slot.bHasPose && Slot.ClearGeneration == ClearGeneration;
+		OutMotion = Slot.Motion;
+		FPlatformMisc::MemoryBarrier();
+		if (Slot.Sequence == Begin)
+		{
+			return bHasPose;
+		}
+	}
+}
+
+bool TangoPosePredictor::PredictPoseAtTime(const FTangoCoordinateFramePair& Pair, double Timestamp, FTangoPoseData& OutPose, double MaxHorizon) const
+{
+	FMotion Motion;
+	if (!ReadMotion(Pair, Motion))
+	{
+		return false;
+	}
+	const double Horizon = Timestamp - Motion.Timestamp;
+	if (Horizon < 0.0 || Horizon > FMath::Min((double)MaxPredictionTime, MaxHorizon) || (Horizon > 0.0 && !Motion.bHasVelocity))
+	{
+		return false;
+	}
+	Extrapolate(Motion, Timestamp, OutPose);
+	OutPose.FrameOfReference = Pair;
+	return true;
+}
+
+bool TangoPosePredictor::PredictPoseAhead(const FTangoCoordinateFramePair& Pair, double LookAhead, FTangoPoseData& OutPose) const
+{
+	FMotion Motion;
+	if (!ReadMotion(Pair, Motion))
+	{
+		return false;
+	}
+	if (LookAhead < 0.0 || LookAhead > MaxPredictionTime || (LookAhead > 0.0 && !Motion.bHasVelocity))
+	{
+		return false;
+	}
+	Extrapolate(Motion, Motion.Timestamp + LookAhead, OutPose);
+	OutPose.FrameOfReference = Pair;
+	return true;
+}
+
+void TangoPosePredictor::Extrapolate(const FMotion& Motion, double Timestamp, FTangoPoseData& OutPose)
+{
+	const float Horizon = (float)(Timestamp - Motion.Timestamp);
+	OutPose.Position = Motion.Position + Motion.LinearVelocity * Horizon;
+	OutPose.QuatRotation = Motion.Rotation;
+	const float AngularSpeed = Motion.AngularVelocity.Size();
+	if (AngularSpeed > KINDA_SMALL_NUMBER)
+	{
+		OutPose.QuatRotation = FQuat(Motion.AngularVelocity / AngularSpeed, AngularSpeed * Horizon) * Motion.Rotation;
+		OutPose.QuatRotation.Normalize();
+	}
+	OutPose.Rotation = OutPose.QuatRotation.Rotator();
+	OutPose.StatusCode = ETangoPoseStatus::VALID;
+	OutPose.Timestamp = Timestamp;
+	OutPose.PreciseTimestamp = Timestamp;
+}
@@ -0,0 +1,85 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+
+#pragma once
+
+#include "TangoDataTypes.h"
+#include "TangoPoseTable.h"
+
+/**
+ * Predicts poses a short time past the newest pose delivered by the Tango pose callback.
+ * Every pose updates a smoothed estimate of the linear and angular velocity of its frame pair, predictions continue
+ * the newest pose at that velocity. Poses are kept in Tango conventions, exactly as the service would return them.
+ * Like TangoPoseTable, every frame pair has a fixed slot published through a seqlock: AddPose must only be
+ * called from one thread and never blocks, predictions can be made from any thread.
+ */
+class TangoPosePredictor
+{
+public:
+	TangoPosePredictor();
+
+	/** Changes how velocities are smoothed and how far ahead predictions may reach. Any thread. */
+	void SetSettings(const FTangoPosePredictionSettings& InSettings);
+	FTangoPosePredictionSettings GetSettings() const;
+
+	/** Feeds a pose of Pair. An invalid pose drops the estimate of Pair, as tracking was lost or reset. Writer thread only. */
+	void AddPose(const FTangoCoordinateFramePair& Pair, const FTangoPoseData& Pose, double Timestamp);
+	/** Drops the estimates of all pairs. Any thread. */
+	void Clear();
+
+	/**
+	 * Pose of Pair at Timestamp, which must not be older than the newest pose fed and at most
+	 * MaxPredictionTime, or MaxHorizon if smaller, ahead of it.
+	 */
+	bool PredictPoseAtTime(const FTangoCoordinateFramePair& Pair, double Timestamp, FTangoPoseData& OutPose, double MaxHorizon = DBL_MAX) const;
+	/** Pose of Pair LookAhead seconds past the newest pose fed. */
+	bool PredictPoseAhead(const FTangoCoordinateFramePair& Pair, double LookAhead, FTangoPoseData& OutPose) const;
+
+private:
+	struct FMotion
+	{
+		double Timestamp;
+		FVector Position;
+		FQuat Rotation;
+		//Units per second in the base frame
+		FVector LinearVelocity;
+		//Rotation axis in the base frame scaled by radians per second
+		FVector AngularVelocity;
+		//False until two poses close enough in time were seen
+		bool bHasVelocity;
+	};
+
+	struct FSlot
+	{
+		FSlot() : Sequence(0), ClearGeneration(0), bHasPose(false) {}
+		//Odd while the writer is in the middle of publishing, 0 if never published
+		volatile int32 Sequence;
+		//Value of ClearGeneration when the slot was written, older slots count as empty
+		int32 ClearGeneration;
+		bool bHasPose;
+		FMotion Motion;
+	};
+
+	bool ReadMotion(const FTangoCoordinateFramePair& Pair, FMotion& OutMotion) const;
+	static void Extrapolate(const FMotion& Motion, double Timestamp, FTangoPoseData& OutPose);
+
+	//Written by any thread, each value is read on its own so a change may take effect one pose late
+	volatile float VelocitySmoothingTime;
+	volatile float AngularVelocitySmoothingTime;
+	volatile float MaxPredictionTime;
+
+	volatile int32 ClearGeneration;
+	FSlot Slots[TangoPoseTable::NumSlots];
+};
@@ -0,0 +1,66 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+
+#include "TangoPluginPrivatePCH.h"
+#include "TangoPoseTable.h"
+
+TangoPoseTable::TangoPoseTable()
+{
+}
+
+void TangoPoseTable::Publish(int32 SlotIndex, const FTangoPoseData& Pose)
+{
+	check(SlotIndex >= 0 && SlotIndex < NumSlots);
+	FSlot& Slot = Slots[SlotIndex];
+	const int32 Sequence = Slot.Sequence;
+	//Both exchanges are full barriers, so the pose cannot be written outside of the odd window
+	FPlatformAtomics::InterlockedExchange(&Slot.Sequence, Sequence + 1);
+	Slot.Pose = Pose;
+	FPlatformAtomics::InterlockedExchange(&Slot.Sequence, Sequence + 2);
+}
+
+const FTangoPoseData* TangoPoseTable::GetPublished(int32 SlotIndex) const
+{
+	check(SlotIndex >= 0 && SlotIndex < NumSlots);
+	return Slots[SlotIndex].Sequence != 0 ? &Slots[SlotIndex].Pose : nullptr;
+}
+
+bool TangoPoseTable::ReadIfNewer(int32 SlotIndex, FTangoPoseData& OutPose, int32& InOutSequence) const
+{
+	check(SlotIndex >= 0 && SlotIndex < NumSlots);
+	const FSlot& Slot = Slots[SlotIndex];
+	for (;;)
+	{
+		const int32 Begin = Slot.Sequence;
+		if (Begin == InOutSequence)
+		{
+			return false;
+		}
+		if (Begin & 1)
+		{
+			//A pose is only a few dozen bytes, the writer will be done in a moment
+			FPlatformProcess::Sleep(0.0f);
+			continue;
+		}
+		FPlatformMisc::MemoryBarrier();
+		OutPose = Slot.Pose;
+		FPlatformMisc::MemoryBarrier();
+		if (Slot.Sequence == Begin)
+		{
+			InOutSequence = Begin;
+			return true;
+		}
+	}
+}
@@ -0,0 +1,61 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+
+#pragma once
+
+#include "TangoDataTypes.h"
+
+/**
+ * Latest pose per frame pair, published by the Tango pose callback without taking a lock.
+ * Every frame pair has a fixed slot guarded by a sequence counter (a seqlock): the writer makes the counter odd
+ * while it writes, readers copy the slot and retry if the counter changed or was odd meanwhile.
+ * There must only be one writer thread, readers can be on any thread and never block it.
+ */
+class TangoPoseTable
+{
+public:
+	enum { NumFrames = (int32)ETangoCoordinateFrameType::CAMERA_FISHEYE + 1 };
+	enum { NumSlots = NumFrames * NumFrames };
+
+	static int32 GetSlotIndex(const FTangoCoordinateFramePair& Pair)
+	{
+		return (int32)Pair.BaseFrame * NumFrames + (int32)Pair.TargetFrame;
+	}
+
+	TangoPoseTable();
+
+	/** Publishes Pose in the slot of its frame of reference. Writer thread only. */
+	void Publish(int32 SlotIndex, const FTangoPoseData& Pose);
+
+	/** The pose last published in a slot, or null if there is none. Writer thread only. */
+	const FTangoPoseData* GetPublished(int32 SlotIndex) const;
+
+	/**
+	 * Copies the latest pose of a slot if it was published after InOutSequence, and updates InOutSequence.
+	 * Start with a sequence of 0. Any thread.
+	 */
+	bool ReadIfNewer(int32 SlotIndex, FTangoPoseData& OutPose, int32& InOutSequence) const;
+
+private:
+	struct FSlot
+	{
+		FSlot() : Sequence(0) {}
+		//Odd while the writer is in the middle of publishing, 0 if never published
+		volatile int32 Sequence;
+		FTangoPoseData Pose;
+	};
+
+	FSlot Slots[NumSlots];
+};
@@ -0,0 +1,224 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+
+#include "TangoPluginPrivatePCH.h"
+#include "TangoUndistortion.h"
+#include "Async/ParallelFor.h"
+
+DECLARE_CYCLE_STAT(TEXT("Camera Undistortion"), STAT_TangoCameraUndistortion, STATGROUP_Tango);
+DECLARE_CYCLE_STAT(TEXT("Camera Undistortion Table Build"), STAT_TangoUndistortionTableBuild, STATGROUP_Tango);
+
+namespace
+{
+	//A few image layouts per camera are expected, luma levels and converted frames
+	enum { MaxCachedTables = 8 };
+
+	FCriticalSection CacheLock;
+	TArray<TangoUndistortion::FRemapTablePtr> Cache;
+
+	uint32 GetIntrinsicsHash(const FTangoCameraIntrinsics& Intrinsics, const TangoUndistortion::FImageMapping& Mapping)
+	{
+		uint32 Hash = GetTypeHash((uint8)Intrinsics.CalibrationType);
+		Hash = HashCombine(Hash, GetTypeHash(Intrinsics.Fx));
+		Hash = HashCombine(Hash, GetTypeHash(Intrinsics.Fy));
+		Hash = HashCombine(Hash, GetTypeHash(Intrinsics.Cx));
+		Hash = HashCombine(Hash, GetTypeHash(Intrinsics.Cy));
+		for (float Coefficient : Intrinsics.Distortion)
+		{
+			Hash = HashCombine(Hash, GetTypeHash(Coefficient));
+		}
+		Hash = HashCombine(Hash, GetTypeHash(Mapping.Offset));
+		Hash = HashCombine(Hash, GetTypeHash(Mapping.Scale));
+		Hash = HashCombine(Hash, GetTypeHash(Mapping.Width));
+		return HashCombine(Hash, GetTypeHash(Mapping.Height));
+	}
+
+	bool IsSameCamera(const FTangoCameraIntrinsics& A, const FTangoCameraIntrinsics& B)
+	{
+		return A.CalibrationType == B.CalibrationType && A.Fx == B.Fx && A.Fy == B.Fy && A.Cx == B.Cx && A.Cy == B.Cy
+			&& A.Width == B.Width && A.Height == B.Height && A.Distortion == B.Distortion;
+	}
+
+	TangoUndistortion::FRemapTablePtr FindCachedTable(uint32 Hash, const FTangoCameraIntrinsics& Intrinsics, const TangoUndistortion::FImageMapping& Mapping)
+	{
+		for (const TangoUndistortion::FRemapTablePtr& Table : Cache)
+		{
+			if (Table->Hash == Hash && Table->Mapping == Mapping && IsSameCamera(Table->Intrinsics, Intrinsics))
+			{
+				return Table;
+			}
+		}
+		return nullptr;
+	}
+}
+
+TangoUndistortion::FImageMapping TangoUndistortion::GetMapping(const FTangoCameraImage& Image, int32 LumaLevel)
+{
+	//A pixel of a luma level averages a block of pixels of the image, so it sits at the centre of that block
+	const int32 LevelScale = 1 << FMath::Clamp(LumaLevel, 0, (int32)FTangoCameraImage::NumLumaLevels - 1);
+	FImageMapping Mapping;
+	Mapping.Scale = Image.Decimation * LevelScale;
+	Mapping.Offset = FVector2D(Image.Origin) + FVector2D(1, 1) * (Image.Decimation * (LevelScale - 1) * 0.5f);
+	Mapping.Width = Image.Width / LevelScale;
+	Mapping.Height = Image.Height / LevelScale;
+	return Mapping;
+}
+
+TangoUndistortion::FImageMapping TangoUndistortion::GetMapping(const FTangoCameraFrame& Frame)
+{
+	const int32 FrameScale = 1 << (int32)Frame.Scale;
+	FImageMapping Mapping;
+	Mapping.Scale = FrameScale;
+	Mapping.Offset = FVector2D(1, 1) * ((FrameScale - 1) * 0.5f);
+	Mapping.Width = Frame.Width;
+	Mapping.Height = Frame.Height;
+	return Mapping;
+}
+
+FVector2D TangoUndistortion::Distort(const FTangoCameraIntrinsics& Intrinsics, const FVector2D& Pixel)
+{
+	auto K = [&Intrinsics](int32 Index) { return Intrinsics.Distortion.IsValidIndex(Index) ? (double)Intrinsics.Distortion[Index] : 0.0; };
+	const double X = (Pixel.X - Intrinsics.Cx) / Intrinsics.Fx;
+	const double Y = (Pixel.Y - Intrinsics.Cy) / Intrinsics.Fy;
+	const double R2 = X * X + Y * Y;
+	double DistortedX = X;
+	double DistortedY = Y;
+	switch (Intrinsics.CalibrationType)
+	{
+	case ETangoCalibrationType::EQUIDISTANT:
+	{
+		//FOV model of Devernay and Faugeras, Distortion[0] being the field of view w: rd = atan(2 r tan(w / 2)) / w
+		const double W = K(0);
+		const double R = FMath::Sqrt(R2);
+		if (W > SMALL_NUMBER && R > SMALL_NUMBER)
+		{
+			const double Scale = FMath::Atan(2.0 * R * FMath::Tan(W * 0.5)) / (W * R);
+			DistortedX = X * Scale;
+			DistortedY = Y * Scale;
+		}
+		break;
+	}
+	case ETangoCalibrationType::POLYNOMIAL_2_PARAMETERS:
+	{
+		const double Radial = 1.0 + R2 * (K(0) + R2 * K(1));
+		DistortedX = X * Radial;
+		DistortedY = Y * Radial;
+		break;
+	}
+	case ETangoCalibrationType::POLYNOMIAL_3_PARAMETERS:
+	{
+		const double Radial = 1.0 + R2 * (K(0) + R2 * (K(1) + R2 * K(2)));
+		DistortedX = X * Radial;
+		DistortedY = Y * Radial;
+		break;
+	}
+	case ETangoCalibrationType::POLYNOMIAL_5_PARAMETERS:
+	{
+		//Brown-Conrady with k1, k2, p1, p2, k3
+		const double Radial = 1.0 + R2 * (K(0) + R2 * (K(1) + R2 * K(4)));
+		DistortedX = X * Radial + 2.0 * K(2) * X * Y + K(3) * (R2 + 2.0 * X * X);
+		DistortedY = Y * Radial + K(2) * (R2 + 2.0 * Y * Y) + 2.0 * K(3) * X * Y;
+		break;
+	}
+	default:
+		//Without a model the image is taken as undistorted
+		break;
+	}
+	return FVector2D(DistortedX * Intrinsics.Fx + Intrinsics.Cx, DistortedY * Intrinsics.Fy + Intrinsics.Cy);
+}
+
+TangoUndistortion::FRemapTablePtr TangoUndistortion::GetRemapTable(const FTangoCameraIntrinsics& Intrinsics, const FImageMapping& Mapping)
+{
+	if (Intrinsics.Fx <= 0 || Intrinsics.Fy <= 0 || Mapping.Width < 2 || Mapping.Height < 2 || Mapping.Width > MAX_int16 || Mapping.Height > MAX_int16)
+	{
+		UE_LOG(TangoPlugin, Warning, TEXT("TangoUndistortion::GetRemapTable: Cannot undistort %dx%d images with focal lengths %f, %f"), Mapping.Width, Mapping.Height, Intrinsics.Fx, Intrinsics.Fy);
+		return nullptr;
+	}
+	const uint32 Hash = GetIntrinsicsHash(Intrinsics, Mapping);
+	{
+		FScopeLock Lock(&CacheLock);
+		FRemapTablePtr Cached = FindCachedTable(Hash, Intrinsics, Mapping);
+		if (Cached.IsValid())
+		{
+			return Cached;
+		}
+	}
+
+	//Built outside the lock, so consumers of other tables are not held up
+	SCOPE_CYCLE_COUNTER(STAT_TangoUndistortionTableBuild);
+	TSharedPtr<FRemapTable, ESPMode::ThreadSafe> Table = MakeShareable(new FRemapTable());
+	Table->Intrinsics = Intrinsics;
+	Table->Mapping = Mapping;
+	Table->Hash = Hash;
+	Table->Entries.SetNumUninitialized(Mapping.Width * Mapping.Height);
+	TangoImageKernels::FRemapEntry* Entries = Table->Entries.GetData();
+	ParallelFor(Mapping.Height, [&Intrinsics, &Mapping, Entries](int32 Y)
+	{
+		for (int32 X = 0; X < Mapping.Width; ++X)
+		{
+			const FVector2D Camera = Mapping.Offset + FVector2D(X, Y) * Mapping.Scale;
+			const FVector2D Source = (Distort(Intrinsics, Camera) - Mapping.Offset) / Mapping.Scale;
+			TangoImageKernels::FRemapEntry& Entry = Entries[Y * Mapping.Width + X];
+			//The right and lower neighbours are read too, so the last row and column cannot be the top left of a block
+			if (!(Source.X >= 0 && Source.Y >= 0 && Source.X < Mapping.Width - 1 && Source.Y < Mapping.Height - 1))
+			{
+				Entry.X = 0;
+				Entry.Y = 0;
+				Entry.FracX = TangoImageKernels::InvalidRemapFrac;
+				Entry.FracY = 0;
+				continue;
+			}
+			const int32 FixedX = FMath::RoundToInt(Source.X * TangoImageKernels::RemapFracOne);
+			const int32 FixedY = FMath::RoundToInt(Source.Y * TangoImageKernels::RemapFracOne);
+			Entry.X = (int16)FMath::Min(FixedX >> TangoImageKernels::RemapFracBits, Mapping.Width - 2);
+			Entry.Y = (int16)FMath::Min(FixedY >> TangoImageKernels::RemapFracBits, Mapping.Height - 2);
+			Entry.FracX = (uint8)FMath::Min(FixedX - (Entry.X << TangoImageKernels::RemapFracBits), (int32)TangoImageKernels::RemapFracOne);
+			Entry.FracY = (uint8)FMath::Min(FixedY - (Entry.Y << TangoImageKernels::RemapFracBits), (int32)TangoImageKernels::RemapFracOne);
+		}
+	});
+
+	FScopeLock Lock(&CacheLock);
+	FRemapTablePtr Cached = FindCachedTable(Hash, Intrinsics, Mapping);
+	if (Cached.IsValid())
+	{
+		return Cached;
+	}
+	if (Cache.Num() >= MaxCachedTables)
+	{
+		Cache.RemoveAt(0);
+	}
+	Cache.Add(Table);
+	return Table;
+}
+
+void TangoUndistortion::ClearCache()
+{
+	FScopeLock Lock(&CacheLock);
+	Cache.Reset();
+}
+
+void TangoUndistortion::UndistortLuma(const FRemapTable& Table, const FTangoLumaImage& In, uint8* Out, int32 OutStride)
+{
+	check(In.Width == Table.Mapping.Width && In.Height == Table.Mapping.Height);
+	SCOPE_CYCLE_COUNTER(STAT_TangoCameraUndistortion);
+	TangoImageKernels::RemapLuma(Table.Entries.GetData(), In.Width, In.Height, In.Data, In.Stride, Out, OutStride);
+}
+
+void TangoUndistortion::UndistortFrame(const FRemapTable& Table, const FTangoCameraFrame& In, uint8* Out)
+{
+	check(In.Width == Table.Mapping.Width && In.Height == Table.Mapping.Height);
+	SCOPE_CYCLE_COUNTER(STAT_TangoCameraUndistortion);
+	TangoImageKernels::RemapRGBA(Table.Entries.GetData(), In.Width, In.Height, In.Pixels.GetData(), In.Width * 4, Out, In.Width * 4);
+}
@@ -0,0 +1,77 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+
+#pragma once
+
+#include "TangoDataTypes.h"
+#include "TangoImageComponent.h"
+#include "TangoImageKernels.h"
+
+/**
+ * Undistortion of colour camera images on the CPU, for consumers that need the pinhole images metric vision algorithms expect.
+ * The camera model is evaluated once per pixel into a remap table, cached for the intrinsics and image layout it was built for,
+ * and every image is then resampled bilinearly through the table.
+ * The undistorted image keeps the focal lengths and principal point of the intrinsics.
+ */
+class TangoUndistortion
+{
+public:
+	/** How the pixels of an image relate to the pixels of the full camera image: Camera = Offset + Image * Scale. */
+	struct FImageMapping
+	{
+		FImageMapping() : Offset(0, 0), Scale(1), Width(0), Height(0) {}
+
+		FVector2D Offset;
+		float Scale;
+		int32 Width;
+		int32 Height;
+
+		bool operator==(const FImageMapping& Other) const
+		{
+			return Offset == Other.Offset && Scale == Other.Scale && Width == Other.Width && Height == Other.Height;
+		}
+	};
+
+	/** Mapping of level LumaLevel of the luma pyramid of Image, see FTangoCameraImage::GetLuma. */
+	static FImageMapping GetMapping(const FTangoCameraImage& Image, int32 LumaLevel = 0);
+	/** Mapping of a converted camera frame, whose pixels average blocks of camera pixels at lower scales. */
+	static FImageMapping GetMapping(const FTangoCameraFrame& Frame);
+
+	struct FRemapTable
+	{
+		FTangoCameraIntrinsics Intrinsics;
+		FImageMapping Mapping;
+		uint32 Hash;
+		//One entry per pixel of the undistorted image, in row order
+		TArray<TangoImageKernels::FRemapEntry> Entries;
+	};
+	typedef TSharedPtr<const FRemapTable, ESPMode::ThreadSafe> FRemapTablePtr;
+
+	/**
+	 * Table undistorting images of Mapping taken by the camera with Intrinsics. Built on first use and cached, thread safe.
+	 * Building evaluates the camera model for every pixel, so ask for it ahead of the first image where that matters.
+	 */
+	static FRemapTablePtr GetRemapTable(const FTangoCameraIntrinsics& Intrinsics, const FImageMapping& Mapping);
+	/** Drops the cached tables. Tables still held by consumers stay valid. */
+	static void ClearCache();
+
+	/** Undistorts a luma plane of the layout Table was built for into Out, a plane of the same size with rows of OutStride bytes. */
+	static void UndistortLuma(const FRemapTable& Table, const FTangoLumaImage& In, uint8* Out, int32 OutStride);
+	/** Undistorts a converted camera frame of the layout Table was built for into Out, packed pixels of the same size and byte order. */
+	static void UndistortFrame(const FRemapTable& Table, const FTangoCameraFrame& In, uint8* Out);
+
+	/** Where a pixel of the undistorted camera image is seen in the distorted camera image, in camera pixels. */
+	static FVector2D Distort(const FTangoCameraIntrinsics& Intrinsics, const FVector2D& Pixel);
+};
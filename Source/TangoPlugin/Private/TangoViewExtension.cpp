@@ -0,0 +1,124 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+
+#include "TangoPluginPrivatePCH.h"
+#include "TangoViewExtension.h"
+#include "TangoARCamera.h"
+#include "TangoDevice.h"
+#include "TangoDeviceMotion.h"
+#include "TangoDeviceImage.h"
+#include "PrimitiveSceneProxy.h"
+
+DECLARE_CYCLE_STAT(TEXT("AR Camera Late Update"), STAT_TangoARLateUpdate, STATGROUP_Tango);
+
+namespace
+{
+	//How far past the newest pose callback the motion may be continued. About one callback interval and a half,
+	//beyond that the guess is worse than the stale pose.
+	static const double MaxLateUpdateExtrapolation = 0.015;
+	//Views further than this from the camera look through something else and are left alone
+	static const float MaxCameraDistance = 1.0f;
+}
+
+UTangoARCamera::~UTangoARCamera()
+{
+}
+
+FTangoViewExtension::FTangoViewExtension(UTangoARCamera* InCamera)
+	: Camera(InCamera)
+	, bApplyToViews(false)
+	, LateUpdateTransform(FMatrix::Identity)
+{
+}
+
+void FTangoViewExtension::BeginRenderViewFamily(FSceneViewFamily& InViewFamily)
+{
+	FLateUpdateState State;
+	UTangoARCamera* ARCamera = Camera.Get();
+	AActor* Owner = ARCamera != nullptr ? ARCamera->GetOwner() : nullptr;
+	if (Owner != nullptr && ARCamera->bLateUpdate && ARCamera->bHasCameraPose)
+	{
+		State.Motion = UTangoDevice::Get().GetTangoDeviceMotionPointer();
+		State.Image = UTangoDevice::Get().GetTangoDeviceImagePointer();
+		State.bEnabled = State.Motion != nullptr && State.Image != nullptr;
+		State.FrameOfReference = ARCamera->FrameOfReference;
+		State.OwnerTransform = Owner->GetActorTransform();
+		State.CameraLocation = ARCamera->ComponentToWorld.GetLocation();
+		//Render state is up to date at this point, so the proxy stays valid until this family is rendered
+		if (ARCamera->ARScreen != nullptr && ARCamera->ARScreen->SceneProxy != nullptr)
+		{
+			State.ScreenProxy = ARCamera->ARScreen->SceneProxy;
+			State.ScreenToWorld = ARCamera->ARScreen->ComponentToWorld.ToMatrixWithScale();
+		}
+	}
+	ENQUEUE_UNIQUE_RENDER_COMMAND_TWOPARAMETER(SetTangoLateUpdateState,
+		FTangoViewExtension*, Extension, this,
+		FTangoViewExtension::FLateUpdateState, State, State,
+		{
+			Extension->SetLateUpdateState_RenderThread(State);
+		});
+}
+
+void FTangoViewExtension::SetLateUpdateState_RenderThread(const FLateUpdateState& State)
+{
+	check(IsInRenderingThread());
+	RenderState = State;
+}
+
+void FTangoViewExtension::PreRenderViewFamily_RenderThread(FRHICommandListImmediate& RHICmdList, FSceneViewFamily& InViewFamily)
+{
+	check(IsInRenderingThread());
+	SCOPE_CYCLE_COUNTER(STAT_TangoARLateUpdate);
+	bApplyToViews = false;
+	if (!RenderState.bEnabled)
+	{
+		return;
+	}
+	//The game thread posed the camera for the image it latched a frame ago. Latching the newest image here
+	//and posing the view for it keeps the view registered with the image it is drawn with.
+	RenderState.Image->LatchNewestImage_RenderThread();
+	const double Timestamp = RenderState.Image->GetRenderThreadTimestamp();
+	FTangoPoseData LatePose;
+	if (Timestamp <= 0.0 || !RenderState.Motion->GetBufferedPoseAtTime(RenderState.FrameOfReference, Timestamp, MaxLateUpdateExtrapolation, LatePose))
+	{
+		return;
+	}
+	FTransform LateOwnerTransform = RenderState.OwnerTransform;
+	LateOwnerTransform.SetRotation(LatePose.QuatRotation);
+	LateOwnerTransform.SetTranslation(LatePose.Position);
+	LateUpdateTransform = RenderState.OwnerTransform.ToMatrixWithScale().Inverse() * LateOwnerTransform.ToMatrixWithScale();
+	bApplyToViews = true;
+
+	//The screen is attached to the camera and has to stay in front of the moved view.
+	//The proxy may still carry the late update of an earlier frame if the screen did not move since.
+	if (RenderState.ScreenProxy != nullptr)
+	{
+		const FMatrix LateScreenToWorld = RenderState.ScreenToWorld * LateUpdateTransform;
+		RenderState.ScreenProxy->ApplyLateUpdateTransform(RenderState.ScreenProxy->GetLocalToWorld().Inverse() * LateScreenToWorld);
+	}
+}
+
+void FTangoViewExtension::PreRenderView_RenderThread(FRHICommandListImmediate& RHICmdList, FSceneView& InView)
+{
+	check(IsInRenderingThread());
+	if (!bApplyToViews || !InView.ViewLocation.Equals(RenderState.CameraLocation, MaxCameraDistance))
+	{
+		return;
+	}
+	const FMatrix ViewToWorld = FRotationTranslationMatrix(InView.ViewRotation, InView.ViewLocation) * LateUpdateTransform;
+	InView.ViewLocation = ViewToWorld.GetOrigin();
+	InView.ViewRotation = ViewToWorld.Rotator();
+	InView.UpdateViewMatrix();
+}
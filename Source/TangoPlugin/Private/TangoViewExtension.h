@@ -0,0 +1,72 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+
+#pragma once
+
+#include "SceneViewExtension.h"
+#include "TangoDataTypes.h"
+
+class UTangoARCamera;
+class UTangoDeviceMotion;
+class UTangoDeviceImage;
+class FPrimitiveSceneProxy;
+
+/**
+ * Late update for a UTangoARCamera. The game thread moves the camera to the pose of the camera image it latched,
+ * but newer images and poses arrive while the frame waits to be rendered. Right before the view is set up,
+ * the render thread latches the newest camera image into the environment map, samples the pose for it and moves
+ * the view and the AR screen by the difference. When the buffered poses do not reach that image yet,
+ * the newest motion is extrapolated for a short time instead.
+ * The device objects in the state are kept alive by their release fences until the frame is rendered.
+ */
+class FTangoViewExtension : public ISceneViewExtension
+{
+public:
+	FTangoViewExtension(UTangoARCamera* InCamera);
+
+	//ISceneViewExtension
+	virtual void SetupViewFamily(FSceneViewFamily& InViewFamily) override {}
+	virtual void SetupView(FSceneViewFamily& InViewFamily, FSceneView& InView) override {}
+	virtual void BeginRenderViewFamily(FSceneViewFamily& InViewFamily) override;
+	virtual void PreRenderViewFamily_RenderThread(FRHICommandListImmediate& RHICmdList, FSceneViewFamily& InViewFamily) override;
+	virtual void PreRenderView_RenderThread(FRHICommandListImmediate& RHICmdList, FSceneView& InView) override;
+
+	//What the game thread did with the camera this frame, handed to the render thread
+	struct FLateUpdateState
+	{
+		FLateUpdateState() : bEnabled(false), ScreenProxy(nullptr), Motion(nullptr), Image(nullptr) {}
+
+		bool bEnabled;
+		FTangoCoordinateFramePair FrameOfReference;
+		//The owner as moved to the camera pose by the game thread
+		FTransform OwnerTransform;
+		FVector CameraLocation;
+		FMatrix ScreenToWorld;
+		FPrimitiveSceneProxy* ScreenProxy;
+		UTangoDeviceMotion* Motion;
+		UTangoDeviceImage* Image;
+	};
+
+	void SetLateUpdateState_RenderThread(const FLateUpdateState& State);
+
+private:
+	TWeakObjectPtr<UTangoARCamera> Camera;
+
+	//Render thread only
+	FLateUpdateState RenderState;
+	bool bApplyToViews;
+	//Moves a world transform set from the game thread pose to where the late pose puts it
+	FMatrix LateUpdateTransform;
+};
@@ -35,8 +35,12 @@ public:
 	/** Whether the camera preview is shown */
 	UPROPERTY(BlueprintReadWrite, Category = "Tango|Camera")
 		bool bScreenIsVisible;
+	/** Whether the camera pose is sampled again on the render thread, right before the view is set up */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tango|Camera", meta = (ToolTip = "Samples the camera pose again on the render thread for the camera image being shown, right before the view is set up. Reduces the swim between the camera image and virtual content."))
+		bool bLateUpdate;
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void InitializeComponent() override;
 	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction) override;
 	virtual bool WantToDoAR() override { return true; }
@@ -44,4 +48,9 @@ private:
 	FTangoCoordinateFramePair FrameOfReference;
 	UPROPERTY()
 		UTangoARScreenComponent* ARScreen;
+	//Set once the owner was moved to a camera pose
+	bool bHasCameraPose;
+
+	TSharedPtr< FTangoViewExtension, ESPMode::ThreadSafe > ViewExtension;
+	friend class FTangoViewExtension;
 };
@@ -334,6 +334,21 @@ struct TANGOPLUGIN_API FTangoConfig
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tango", meta = (ToolTip = "The maximum number of points"))
 		int32 MaxPointCloudElements;
 
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tango", meta = (ToolTip = "How many depth frames are kept for readers. Frames are dropped if readers hold on to all of them", ClampMin = "2", ClampMax = "32"))
+		int32 PointCloudBufferCount = 4;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tango", meta = (ToolTip = "How many colour camera images are kept for consumers. Images are dropped if consumers hold on to all of them", ClampMin = "2", ClampMax = "16"))
+		int32 CameraImageBufferCount = 4;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tango", meta = (ToolTip = "Points with a lower confidence are removed from the filtered point cloud stream", ClampMin = "0", ClampMax = "1"))
+		float PointCloudMinConfidence = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tango", meta = (ToolTip = "Edge length in Unreal units of the voxels the filtered point cloud stream is collapsed into. 0 disables downsampling", ClampMin = "0"))
+		float PointCloudVoxelSize = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tango", meta = (ToolTip = "Build a spatial index over every depth frame so nearest point, radius and ray queries on the point cloud are fast"))
+		bool bBuildPointCloudIndex = true;
+
 };
 USTRUCT(BlueprintType)
 struct TANGOPLUGIN_API FWGS_84_PoseData
@@ -347,6 +362,9 @@ struct TANGOPLUGIN_API FWGS_84_PoseData
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tango", meta = (ToolTip = "Pose time in seconds since the device was started"))
 		float Timestamp;
+
+	/** Timestamp in full precision, Timestamp only keeps milliseconds after a few hours of uptime */
+	double PreciseTimestamp = 0.0;
 	
 	/** Maintains required precision */
 	double Position[3];
@@ -390,8 +408,75 @@ struct TANGOPLUGIN_API FTangoPoseData
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tango", meta = (ToolTip = "Pose time in seconds since the device was started"))
 		float Timestamp;
 
+	//@NOTE: Blueprint has no doubles. Timestamp only keeps milliseconds after a few hours of uptime,
+	//C++ code matching poses against other timestamps should use this instead.
+	double PreciseTimestamp;
+
 	FTangoPoseData(FVector NewPosition = FVector(), FRotator NewRotation = FRotator(), FQuat NewQuatRotation = FQuat::Identity, FTangoCoordinateFramePair NewFrameOfReference = FTangoCoordinateFramePair(),
-		ETangoPoseStatus NewStatusCode = ETangoPoseStatus::UNKNOWN, float NewTimestamp = 0.0f);
+		ETangoPoseStatus NewStatusCode = ETangoPoseStatus::UNKNOWN, double NewTimestamp = 0.0);
+};
+
+/*
+	FTangoPosePredictionSettings
+	Controls how poses are predicted past the newest pose delivered by the Tango service.
+*/
+USTRUCT(BlueprintType)
+struct TANGOPLUGIN_API FTangoPosePredictionSettings
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tango", meta = (ToolTip = "Time constant in seconds the linear velocity is smoothed over. Longer is steadier but reacts later to changes in motion, 0 uses the motion between the two newest poses."))
+		float VelocitySmoothingTime = 0.03f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tango", meta = (ToolTip = "Time constant in seconds the angular velocity is smoothed over. Longer is steadier but reacts later to changes in motion, 0 uses the motion between the two newest poses."))
+		float AngularVelocitySmoothingTime = 0.02f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tango", meta = (ToolTip = "How many seconds past the newest pose a prediction may reach. Requests further ahead fail."))
+		float MaxPredictionTime = 0.1f;
+};
+
+/*
+	ETangoPoseFilterType
+	How the poses of a frame pair are smoothed before they reach motion components and pose events.
+*/
+UENUM(BlueprintType)
+enum class ETangoPoseFilterType : uint8
+{
+	NONE			UMETA(DisplayName = "None"),
+	EXPONENTIAL		UMETA(DisplayName = "Exponential"),
+	ONE_EURO		UMETA(DisplayName = "One Euro"),
+	KALMAN			UMETA(DisplayName = "Constant Velocity Kalman")
+};
+
+/*
+	FTangoPoseFilterSettings
+	Selects and tunes the filter applied to the poses of a frame pair. Distances are in meters, as delivered by the Tango service.
+*/
+USTRUCT(BlueprintType)
+struct TANGOPLUGIN_API FTangoPoseFilterSettings
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tango", meta = (ToolTip = "Filter applied to the poses, None passes them through unchanged."))
+		ETangoPoseFilterType FilterType = ETangoPoseFilterType::NONE;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tango", meta = (ToolTip = "Exponential: time constant in seconds the poses are smoothed over. Longer is steadier but lags further behind."))
+		float SmoothingTime = 0.05f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tango", meta = (ToolTip = "One Euro: cutoff frequency in Hz while the device is still. Lower removes more jitter."))
+		float MinCutoff = 1.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tango", meta = (ToolTip = "One Euro: how much the cutoff rises with speed, per meter or radian per second. Higher lags less during fast motion."))
+		float Beta = 0.5f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tango", meta = (ToolTip = "One Euro: cutoff frequency in Hz of the speed estimate the cutoff is adapted from."))
+		float DerivativeCutoff = 1.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tango", meta = (ToolTip = "Kalman: how much the velocity is expected to change, as acceleration variance per second. Higher follows changes in motion sooner."))
+		float ProcessNoise = 1.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tango", meta = (ToolTip = "Kalman: variance of the jitter of the poses, in square meters or radians. Higher smooths more."))
+		float MeasurementNoise = 0.00001f;
 };
 
 /*
@@ -404,7 +489,7 @@ struct TANGOPLUGIN_API FTangoCameraIntrinsics
 	GENERATED_USTRUCT_BODY()
 
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Tango", meta = (ToolTip = "Calibration type of the camera"))
-		ETangoCalibrationType CalibrationType;
+		ETangoCalibrationType CalibrationType = ETangoCalibrationType::UNKNOWN;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tango", meta = (ToolTip = "Determines to which camera these intrinsics belong"))
 		ETangoCameraType CameraID;
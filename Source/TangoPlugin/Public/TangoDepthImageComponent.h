@@ -0,0 +1,112 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+
+#pragma once
+
+#include "Components/ActorComponent.h"
+#include "TangoPointCloudComponent.h"
+#include "TangoDepthImageComponent.generated.h"
+
+UENUM(BlueprintType)
+enum class ETangoDepthHoleFilling : uint8
+{
+	NONE		UMETA(DisplayName = "None"),
+	NEAREST		UMETA(DisplayName = "Nearest Neighbor"),
+	BILATERAL	UMETA(DisplayName = "Bilateral")
+};
+
+/**
+ * A dense depth image seen from the color camera, rasterized from one depth frame.
+ * Depth is the distance along the color camera's view axis in Unreal units, 0 where it is unknown.
+ */
+struct TANGOPLUGIN_API FTangoDepthImage
+{
+	FTangoDepthImage() : Width(0), Height(0), Timestamp(0), ColorTimestamp(0), Generation(0), NumProjectedPoints(0) {}
+
+	TArray<float> Depth;
+	int32 Width;
+	int32 Height;
+	//Timestamp of the depth frame
+	double Timestamp;
+	//Timestamp of the color image the depth frame was projected into
+	double ColorTimestamp;
+	//Generation of the depth frame, increases with every new frame
+	int64 Generation;
+	int32 NumProjectedPoints;
+
+	float GetDepth(int32 X, int32 Y) const;
+	/** Depth at normalized image coordinates, (0, 0) being the top left corner of the color image. */
+	float GetDepthAtUV(const FVector2D& UV) const;
+	/** True if the real surface at UV is closer than Depth by more than Tolerance. */
+	bool IsOccluded(const FVector2D& UV, float InDepth, float Tolerance = 0.0f) const;
+};
+
+typedef TSharedPtr<const FTangoDepthImage, ESPMode::ThreadSafe> FTangoDepthImagePtr;
+
+class TangoDepthRasterizer;
+
+/**
+ * Projects every depth frame into the color camera on a background thread, producing a dense depth image
+ * for per-pixel depth and occlusion queries. The image can optionally be uploaded to a float texture.
+ */
+UCLASS(ClassGroup = Tango, Blueprintable, meta = (BlueprintSpawnableComponent))
+class TANGOPLUGIN_API UTangoDepthImageComponent : public UActorComponent
+{
+	GENERATED_BODY()
+public:
+	UTangoDepthImageComponent();
+
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction) override;
+
+	UFUNCTION(Category = "Tango|Depth", meta = (ToolTip = "Depth in Unreal units at normalized color image coordinates. Returns false where the depth is unknown.", keyword = "depth, image, pixel, distance"), BlueprintPure)
+		bool GetDepthAtUV(FVector2D UV, float& Depth);
+
+	UFUNCTION(Category = "Tango|Depth", meta = (ToolTip = "True if the real surface at normalized color image coordinates is closer than Depth by more than Tolerance.", keyword = "depth, image, occlusion, hidden"), BlueprintPure)
+		bool IsOccludedAtUV(FVector2D UV, float Depth, float Tolerance = 1.0f);
+
+	/** Latest depth image, or null if none was produced yet. */
+	FTangoDepthImagePtr GetLatestImage() const { return LatestImage; }
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Tango|Depth", meta = (ToolTip = "Rasterize the filtered point stream instead of every point."))
+		bool bUseFilteredPoints;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Tango|Depth", meta = (ToolTip = "The depth image is the color image size divided by this factor.", ClampMin = "1", ClampMax = "16"))
+		int32 Downscale;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Tango|Depth", meta = (ToolTip = "How pixels that no depth point fell into are filled."))
+		ETangoDepthHoleFilling HoleFilling;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Tango|Depth", meta = (ToolTip = "Largest distance in depth image pixels that hole filling reaches.", ClampMin = "1", ClampMax = "8"))
+		int32 FillRadius;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Tango|Depth", meta = (ToolTip = "Bilateral filling only: depth difference in Unreal units over which a neighbour's weight falls off.", ClampMin = "0.1"))
+		float BilateralDepthSigma;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Tango|Depth", meta = (ToolTip = "Upload every new depth image to Depth Texture."))
+		bool bUpdateTexture;
+
+	UPROPERTY(Transient, BlueprintReadOnly, Category = "Tango|Depth", meta = (ToolTip = "Single channel float texture holding the latest depth image, when Update Texture is enabled."))
+		UTexture2D* DepthTexture;
+
+private:
+	void UpdateTexture();
+
+	TangoDepthRasterizer* Rasterizer;
+	bool bHasIntrinsics;
+	int64 LastPushedGeneration;
+	FTangoDepthImagePtr LatestImage;
+};
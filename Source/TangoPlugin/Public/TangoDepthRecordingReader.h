@@ -0,0 +1,78 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+
+#pragma once
+
+#include "TangoDataTypes.h"
+
+/** One decoded frame of a depth recording. */
+struct TANGOPLUGIN_API FTangoDepthRecordingFrame
+{
+	FTangoDepthRecordingFrame() : Timestamp(0), bPoseValid(false), Translation(FVector::ZeroVector), Orientation(FQuat::Identity) {}
+
+	double Timestamp;
+	//Packed {X, Y, Z, C} values in meters, in the depth camera frame, as delivered by the Tango service
+	TArray<FVector4> Points;
+	//Pose of the depth camera in the recording's base frame in Tango conventions, translation in meters
+	bool bPoseValid;
+	FVector Translation;
+	FQuat Orientation;
+};
+
+/**
+ * Random access to depth recordings written by the depth recorder.
+ * On Android and Linux the file is memory mapped so only the frames that are read are paged in,
+ * elsewhere it is loaded into memory as a whole. Frames can be read from several threads at once.
+ */
+class TANGOPLUGIN_API TangoDepthRecordingReader
+{
+public:
+	TangoDepthRecordingReader();
+	~TangoDepthRecordingReader();
+
+	bool Open(const FString& Filename);
+	void Close();
+	bool IsOpen() const { return Data != nullptr; }
+
+	int32 GetNumFrames() const { return Index.Num(); }
+	double GetFrameTimestamp(int32 FrameIndex) const;
+	ETangoCoordinateFrameType GetBaseFrame() const { return BaseFrame; }
+
+	/** Index of the frame whose timestamp is closest to Timestamp, INDEX_NONE if the recording is empty. */
+	int32 FindFrame(double Timestamp) const;
+	bool ReadFrame(int32 FrameIndex, FTangoDepthRecordingFrame& OutFrame) const;
+
+private:
+	bool ReadIndex();
+	void RebuildIndex();
+
+	TangoDepthRecordingReader(const TangoDepthRecordingReader&) = delete;
+	TangoDepthRecordingReader& operator=(const TangoDepthRecordingReader&) = delete;
+
+	uint8* Data;
+	int64 Size;
+	bool bMapped;
+	TArray<uint8> LoadedData;
+
+	ETangoCoordinateFrameType BaseFrame;
+	float QuantizationStep;
+	struct FFrameLocation
+	{
+		double Timestamp;
+		int64 Offset;
+	};
+	//Sorted by timestamp
+	TArray<FFrameLocation> Index;
+};
@@ -100,6 +100,47 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Tango|Core", meta = (Keywords = "tango, camera, camera type, device"))
 		static FTangoCameraIntrinsics GetCameraIntrinsics(ETangoCameraType CameraID);
 
+	/*
+	*	Starts recording every depth frame and the depth camera pose at its timestamp to a compact binary file.
+	* Points are quantized to half a millimeter and compressed. The recording can be read back with TangoDepthRecordingReader.
+	* @param Filename Absolute path of the file to create.
+	* @param BaseFrame The frame the depth camera poses are recorded relative to, typically Start of Service or Area Description.
+	* @return True if the file could be created and the recording started.
+	*/
+	UFUNCTION(Category = "Tango|Depth", BlueprintCallable, meta = (ToolTip = "Starts recording the depth frames and their poses to a file", Keywords = "tango, depth, point cloud, record, capture, file"))
+		static bool StartDepthRecording(const FString& Filename, ETangoCoordinateFrameType BaseFrame = ETangoCoordinateFrameType::START_OF_SERVICE);
+
+	/*
+	*	Writes the remaining queued depth frames and the frame index, then closes the recording.
+	*/
+	UFUNCTION(Category = "Tango|Depth", BlueprintCallable, meta = (ToolTip = "Stops the current depth recording", Keywords = "tango, depth, point cloud, record, capture, stop"))
+		static void StopDepthRecording();
+
+	UFUNCTION(Category = "Tango|Depth", BlueprintPure, meta = (ToolTip = "Inidicates if depth frames are currently being recorded", Keywords = "tango, depth, point cloud, record, capture"))
+		static bool IsDepthRecording();
+
+	/*
+	*	Sets how poses are predicted past the newest pose delivered by the Tango service, see GetPredictedTangoPose.
+	* @param Settings Smoothing of the velocity estimates and the furthest a prediction may reach.
+	*/
+	UFUNCTION(Category = "Tango|Motion", BlueprintCallable, meta = (ToolTip = "Sets how poses are predicted past the newest pose", Keywords = "tango, motion, pose, predict, prediction, latency"))
+		static void SetPosePredictionSettings(const FTangoPosePredictionSettings& Settings);
+
+	UFUNCTION(Category = "Tango|Motion", BlueprintPure, meta = (ToolTip = "Returns how poses are predicted past the newest pose", Keywords = "tango, motion, pose, predict, prediction, latency"))
+		static FTangoPosePredictionSettings GetPosePredictionSettings();
+
+	/*
+	*	Smooths the poses of a frame pair inside the plugin, before they move motion components and reach pose events.
+	* Pairs derived from the same device pose, e.g. the device and its cameras, share one filter.
+	* @param FrameOfReference The frame pair whose poses are filtered.
+	* @param Settings The filter and its tuning, a filter type of None turns filtering off.
+	*/
+	UFUNCTION(Category = "Tango|Motion", BlueprintCallable, meta = (ToolTip = "Sets the filter that smooths the poses of a frame pair", Keywords = "tango, motion, pose, filter, smooth, jitter"))
+		static bool SetPoseFilter(FTangoCoordinateFramePair FrameOfReference, const FTangoPoseFilterSettings& Settings);
+
+	UFUNCTION(Category = "Tango|Motion", BlueprintPure, meta = (ToolTip = "Returns the filter that smooths the poses of a frame pair", Keywords = "tango, motion, pose, filter, smooth, jitter"))
+		static FTangoPoseFilterSettings GetPoseFilter(FTangoCoordinateFramePair FrameOfReference);
+
 	/*
 	* Utility to get a rotation as a quaternion
 	*/
@@ -15,8 +15,157 @@ limitations under the License.*/
 #pragma once
 
 #include "Components/ActorComponent.h"
+#include "TangoDataTypes.h"
+
+#if PLATFORM_ANDROID
+#include "tango_client_api.h"
+#endif
+
 #include "TangoImageComponent.generated.h"
 
+UENUM(BlueprintType)
+enum class ETangoCameraFrameFormat : uint8
+{
+	RGBA	UMETA(DisplayName = "RGBA"),
+	BGRA	UMETA(DisplayName = "BGRA")
+};
+
+UENUM(BlueprintType)
+enum class ETangoCameraFrameScale : uint8
+{
+	FULL	UMETA(DisplayName = "Full Resolution"),
+	HALF	UMETA(DisplayName = "Half Resolution"),
+	QUARTER	UMETA(DisplayName = "Quarter Resolution")
+};
+
+/**
+ * One colour camera image converted to packed 8 bit pixels.
+ * Frames are filled once by the camera image worker and then shared read-only by every consumer.
+ */
+struct TANGOPLUGIN_API FTangoCameraFrame
+{
+	FTangoCameraFrame() : Width(0), Height(0), Timestamp(0), FrameNumber(0), Format(ETangoCameraFrameFormat::RGBA), Scale(ETangoCameraFrameScale::FULL) {}
+
+	//Width * Height pixels of 4 bytes, rows without padding. BGRA frames can be read as FColor.
+	TArray<uint8> Pixels;
+	int32 Width;
+	int32 Height;
+	double Timestamp;
+	int64 FrameNumber;
+	ETangoCameraFrameFormat Format;
+	ETangoCameraFrameScale Scale;
+};
+
+typedef TSharedPtr<const FTangoCameraFrame, ESPMode::ThreadSafe> FTangoCameraFramePtr;
+
+/** One level of the luma pyramid of a camera image, only read. */
+struct FTangoLumaImage
+{
+	FTangoLumaImage() : Data(nullptr), Width(0), Height(0), Stride(0) {}
+
+	const uint8* Data;
+	int32 Width;
+	int32 Height;
+	//Row length in bytes
+	int32 Stride;
+};
+
+/**
+ * One colour camera image in the YUV layout the Tango service delivered it in.
+ * The device copies every image once into a pooled buffer, consumers on any thread keep it alive by holding the pointer.
+ * Images held for long keep the pool from recycling them, newer images are dropped once all of them are held.
+ */
+struct TANGOPLUGIN_API FTangoCameraImage
+{
+	enum { NumLumaLevels = 4 };
+
+	FTangoCameraImage() : Width(0), Height(0), Stride(0), ChromaStride(0), Format(ETangoImageFormat::TANGO_HAL_PIXEL_FORMAT_YCrCb_420_SP), Timestamp(0), FrameNumber(0), Origin(0, 0), Decimation(1), NumBuiltLumaLevels(1) {}
+
+	//The luma plane followed by the chroma planes
+	TArray<uint8> Data;
+	int32 Width;
+	int32 Height;
+	//Row lengths in bytes of the luma and chroma planes
+	int32 Stride;
+	int32 ChromaStride;
+	ETangoImageFormat Format;
+	double Timestamp;
+	int64 FrameNumber;
+	//For images copied for an FTangoCameraImageRequest: pixel (X, Y) of this image is pixel Origin + (X, Y) * Decimation of the camera image
+	FIntPoint Origin;
+	int32 Decimation;
+#if PLATFORM_ANDROID
+	//Data viewed as a TangoImageBuffer, so it can be passed to the support and reconstruction libraries
+	TangoImageBuffer Buffer;
+#endif
+
+	const uint8* GetY() const { return Data.GetData(); }
+	//NV21: the interleaved VU plane. YV12: the V plane.
+	const uint8* GetV() const { return Data.GetData() + Stride * Height; }
+	//YV12 only, null for NV21
+	const uint8* GetU() const { return Format == ETangoImageFormat::TANGO_HAL_PIXEL_FORMAT_YV12 ? GetV() + ChromaStride * Height / 2 : nullptr; }
+
+	/**
+	 * The luma plane with 1 << Level times fewer pixels along each side, each pixel averaging a 2x2 block of the level above.
+	 * Level 0 is the camera image itself, levels up to NumLumaLevels - 1 are built the first time any consumer asks and then shared.
+	 * Valid while the image is held. Thread safe.
+	 */
+	FTangoLumaImage GetLuma(int32 Level) const;
+
+	/** Forgets the luma pyramid of the previous image when the pool reuses this one. */
+	void ResetLumaPyramid() { NumBuiltLumaLevels = 1; }
+
+private:
+	//Where a level is or will be stored, without building it
+	FTangoLumaImage GetLumaLayout(int32 Level) const;
+
+	//Levels 1 and above, one after the other with rows of their width. Allocated once for all levels, so built levels never move.
+	mutable TArray<uint8> LumaPyramid;
+	//Published after the level's pixels, so readers of built levels do not take the lock
+	mutable volatile int32 NumBuiltLumaLevels;
+	mutable FCriticalSection LumaPyramidLock;
+};
+
+typedef TSharedPtr<const FTangoCameraImage, ESPMode::ThreadSafe> FTangoCameraImagePtr;
+
+DECLARE_DELEGATE_OneParam(FOnTangoCameraImageAvailable, const FTangoCameraImagePtr&);
+
+/** The part of the camera images a listener needs, and how often. Listeners asking for the same region and decimation share one copy. */
+struct FTangoCameraImageRequest
+{
+	FTangoCameraImageRequest() : Region(FVector2D(0, 0), FVector2D(1, 1)), Decimation(1), MaxRate(0) {}
+
+	//Part of the image to copy, as fractions of its width and height. Widened to whole chroma samples of the decimated image.
+	FBox2D Region;
+	//Only every Decimation-th pixel of every Decimation-th row is copied, without filtering. 1, 2, 4 or 8.
+	int32 Decimation;
+	//Most images per second delivered to the listener, 0 for every image
+	float MaxRate;
+
+	bool IsFullImage() const { return Decimation == 1 && Region.Min.IsNearlyZero() && Region.Max.Equals(FVector2D(1, 1)); }
+};
+
+USTRUCT(BlueprintType)
+struct TANGOPLUGIN_API FTangoCameraImagePoolStats
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tango|Camera", meta = (ToolTip = "Number of camera images the pool holds, set by CameraImageBufferCount in the Tango config"))
+		int32 PoolSize = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tango|Camera", meta = (ToolTip = "Number of pooled images currently held by consumers, including the latest image"))
+		int32 ImagesHeld = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tango|Camera", meta = (ToolTip = "Number of camera images copied into the pool since the camera was connected"))
+		int32 CopiedImages = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tango|Camera", meta = (ToolTip = "Number of camera images dropped because consumers held every pooled image"))
+		int32 DroppedImages = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tango|Camera", meta = (ToolTip = "Number of camera frame conversions skipped because consumers held every converted frame"))
+		int32 SkippedConversions = 0;
+};
+
 
 UCLASS(ClassGroup = Tango, Blueprintable, meta = (BlueprintSpawnableComponent))
 class TANGOPLUGIN_API UTangoImageComponent : public UActorComponent
@@ -30,6 +179,8 @@ public:
 	UPROPERTY(BlueprintAssignable)
 		FOnTangoImageAvailable OnTangoImageAvailable;
 
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction) override;
 
 	
@@ -50,7 +201,43 @@ public:
 	*/
 	UFUNCTION(Category = "Tango|Camera", BluePrintPure, meta = (ToolTip = "Get the latest cameraimage timestamp.", keyword = "image, timestamp, time, seconds, camera"))
 		float  GetLatestImageTimeStamp();
+
+	/** GetLatestImageTimeStamp in full precision, for matching against pose and depth timestamps in C++. */
+	double GetLatestImagePreciseTimestamp();
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Tango|Camera", meta = (ToolTip = "Keep the camera image converted to packed pixels on a worker thread, for C++ code reading GetLatestCameraFrame. Read on BeginPlay."))
+		bool bConvertCameraFrames = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Tango|Camera", meta = (ToolTip = "Byte order of the converted camera image."))
+		ETangoCameraFrameFormat CameraFrameFormat = ETangoCameraFrameFormat::RGBA;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Tango|Camera", meta = (ToolTip = "Resolution of the converted camera image, lower resolutions average blocks of pixels."))
+		ETangoCameraFrameScale CameraFrameScale = ETangoCameraFrameScale::FULL;
+
+	/** The newest camera image converted as set by CameraFrameFormat and CameraFrameScale, or null if there is none yet. */
+	FTangoCameraFramePtr GetLatestCameraFrame() const;
+
+	/**
+	 * Calls Listener on the camera thread with the colour camera images, copied once for all listeners asking for the same part of them.
+	 * Request limits the copy to a region, every Decimation-th pixel and MaxRate images per second.
+	 * Keep the pointer to read the image on another thread and return quickly, the camera callback waits for listeners.
+	 * Listeners stay registered across Tango reconnects. Thread safe, listeners may add and remove listeners,
+	 * but one removed on another thread can still be called once for an image already being delivered.
+	 */
+	static FDelegateHandle AddCameraImageListener(const FOnTangoCameraImageAvailable& Listener, const FTangoCameraImageRequest& Request = FTangoCameraImageRequest());
+	static void RemoveCameraImageListener(FDelegateHandle Handle);
+
+	/*
+	* Returns the size of the camera image pool and how many images it had to drop.
+	* Images are dropped when consumers hold on to every pooled image, raise CameraImageBufferCount in the Tango config if that happens regularly.
+	*/
+	UFUNCTION(Category = "Tango|Camera", BlueprintPure, meta = (ToolTip = "Returns the size of the camera image pool and how many images it had to drop.", keyword = "image, camera, pool, buffer, dropped, stats"))
+		FTangoCameraImagePoolStats GetCameraImagePoolStats();
 private:
-	float LastBroadCastedTimestamp = 0;
+	double LastBroadCastedTimestamp = 0;
+	//The stream asked for on BeginPlay, which EndPlay gives back
+	bool bRequestedCameraFrames = false;
+	ETangoCameraFrameFormat RequestedFormat;
+	ETangoCameraFrameScale RequestedScale;
 
 };
\ No newline at end of file
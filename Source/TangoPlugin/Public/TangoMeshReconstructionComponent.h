@@ -3,6 +3,7 @@
 #pragma once
 
 #include "Components/ActorComponent.h"
+#include "TangoImageComponent.h"
 #if PLATFORM_ANDROID
 #include "tango_client_api.h"
 #include "tango_support_api.h"
@@ -105,9 +106,11 @@ public:
 	FCriticalSection ImageBufferMutex; // Protects above state related to processing image buffers
 	// The point cloud of the most recent depth received.  Stored
 	// as float tuples (X,Y,Z,C).
-	void OnImageBufferAvailable(const TangoImageBuffer* ImageBuffer);
+	void OnCameraImageAvailable(const FTangoCameraImagePtr& Image);
 
-	TangoSupportImageBufferManager* ImageBufferManager;
+	//The newest camera image not yet processed by RunGen
+	FCriticalSection LatestImageMutex;
+	FTangoCameraImagePtr LatestImage;
 
 	
 	FCriticalSection UpdatedIndicesMutex; // protects UpdatedIndices
@@ -32,6 +32,8 @@ class TANGOPLUGIN_API UTangoMotionComponent : public USceneComponent, public ITa
 	~UTangoMotionComponent(); //In TangoViewExtension.cpp!
 	virtual void BeginDestroy() override;
 	virtual void InitializeComponent() override;
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
 
@@ -40,6 +42,7 @@ public:
 		FOnTangoPoseAvailable OnTangoPoseAvailable;
 
 	//The Frame of Reference which will drive the position and rotation of this component.
+	//The device moves all components with the same frame of reference from a single pose, relative to their parent.
 	UPROPERTY(Category = "Tango|Motion", meta = (ToolTip = "The Frame of Reference which will drive the position and rotation of this component.", keyword = "motion, frame, coordinate pair, frame of reference, position, rotation", ExposeOnSpawn), BlueprintReadWrite, EditAnywhere)
 		FTangoCoordinateFramePair MotionComponentFrameOfReference;
 
@@ -77,6 +80,45 @@ public:
 	UFUNCTION(Category = "Tango|Motion", meta = (ToolTip = "Returns the component transform for the given time.", keyword = "motion, time, timestamp, transform"), BlueprintPure)
 		FTransform GetComponentTransformAtTime(float Timestamp);
 
+	/** GetTangoPoseAtTime and GetComponentTransformAtTime with a full precision timestamp, for C++ callers. */
+	FTangoPoseData GetTangoPoseAtPreciseTime(FTangoCoordinateFramePair FrameOfReference, double Timestamp);
+	FTransform GetComponentTransformAtPreciseTime(double Timestamp);
+
+	/*
+	*	Returns Tango pose objects for many timestamps at once, relative to a specific frame of reference.
+	* Much cheaper than calling GetTangoPoseAtTime for each of them, e.g. to draw a trajectory.
+	* @param Specifies the frame of reference and target frame of reference.
+	*	@param Timestamps The timestamps for which the Tango pose data should be retrieved, in any order.
+	* @param Poses One pose per timestamp, in the same order.
+	*/
+	UFUNCTION(Category = "Tango|Motion", meta = (ToolTip = "Returns the Tango pose objects for many timestamps at once.", keyword = "motion, time, timestamp, pose, trajectory, batch"), BlueprintCallable)
+		void GetTangoPosesAtTimes(FTangoCoordinateFramePair FrameOfReference, const TArray<float>& Timestamps, TArray<FTangoPoseData>& Poses);
+
+	/** GetTangoPosesAtTimes with full precision timestamps, for C++ callers. */
+	void GetPosesAtTimes(FTangoCoordinateFramePair FrameOfReference, const TArray<double>& Timestamps, TArray<FTangoPoseData>& Poses);
+
+	/*
+	*	Predicts the pose a short time past the newest pose delivered by the Tango service, from the velocity the device moved at recently.
+	* How far ahead a prediction may reach and how the velocity is smoothed is set with SetPosePredictionSettings.
+	* @param Specifies the frame of reference and target frame of reference.
+	*	@param LookAhead Seconds past the newest pose, typically the time until the frame is displayed.
+	* @return TangoPoseData The predicted pose. Its status is Invalid if the pose could not be predicted that far ahead.
+	*/
+	UFUNCTION(Category = "Tango|Motion", meta = (ToolTip = "Predicts the pose a short time past the newest pose.", keyword = "motion, pose, predict, prediction, latency, extrapolate"), BlueprintPure)
+		FTangoPoseData GetPredictedTangoPose(FTangoCoordinateFramePair FrameOfReference, float LookAhead);
+
+	/** Predicts the pose at a full precision timestamp past the newest pose, for C++ callers. */
+	FTangoPoseData GetTangoPoseAtPredictedTime(FTangoCoordinateFramePair FrameOfReference, double Timestamp);
+
+	/*
+	*	Returns the newest pose delivered by the Tango service after the filter set for its frame pair with SetPoseFilter.
+	* Components and pose events already get filtered poses, this is for pairs read on demand.
+	* @param Specifies the frame of reference and target frame of reference.
+	* @return TangoPoseData The filtered pose. Its status is Invalid if no pose of the pair was delivered yet.
+	*/
+	UFUNCTION(Category = "Tango|Motion", meta = (ToolTip = "Returns the newest pose after the filter of its frame pair.", keyword = "motion, pose, filter, smooth, jitter"), BlueprintPure)
+		FTangoPoseData GetFilteredTangoPose(FTangoCoordinateFramePair FrameOfReference);
+
 	/*
 	*	Returns the status of the pose information returned by the Tango Device.
 	* @param Timestamp The function will return the pose status of the pose which most closely matches this timestamp.
@@ -0,0 +1,102 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+#pragma once
+
+#include "Components/ActorComponent.h"
+#include "TangoPointCloudComponent.h"
+#include "TangoPlaneComponent.generated.h"
+
+USTRUCT(BlueprintType)
+struct TANGOPLUGIN_API FTangoPlane
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tango|Depth", meta = (ToolTip = "Identifier of this plane, stays the same for as long as the plane is tracked"))
+		int32 ID = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tango|Depth", meta = (ToolTip = "Center of the plane. The X axis is the plane normal pointing towards the device when it was seen, Y and Z span the plane"))
+		FTransform Pose;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tango|Depth", meta = (ToolTip = "Half the size of the plane along the Y and Z axes of its pose"))
+		FVector2D Extents = FVector2D::ZeroVector;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tango|Depth", meta = (ToolTip = "Timestamp of the depth frame the plane was last seen in"))
+		float Timestamp = 0.0f;
+};
+
+class TangoPlaneDetector;
+
+/**
+ * Finds planes in the depth frames on a background thread and tracks them over time.
+ * Every plane keeps its ID while it is tracked. Planes that should be in view but are not seen for
+ * a number of frames are removed.
+ */
+UCLASS(ClassGroup = Tango, Blueprintable, meta = (BlueprintSpawnableComponent))
+class TANGOPLUGIN_API UTangoPlaneComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnTangoPlaneEvent, const FTangoPlane&, Plane);
+public:
+	UTangoPlaneComponent();
+
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction) override;
+
+	UPROPERTY(BlueprintAssignable, Category = "Tango|Depth")
+		FOnTangoPlaneEvent OnPlaneAdded;
+
+	UPROPERTY(BlueprintAssignable, Category = "Tango|Depth")
+		FOnTangoPlaneEvent OnPlaneUpdated;
+
+	UPROPERTY(BlueprintAssignable, Category = "Tango|Depth")
+		FOnTangoPlaneEvent OnPlaneRemoved;
+
+	UFUNCTION(Category = "Tango|Depth", meta = (ToolTip = "Returns all planes that are currently tracked.", keyword = "depth, plane, surface"), BlueprintPure)
+		TArray<FTangoPlane> GetPlanes();
+
+	UFUNCTION(Category = "Tango|Depth", meta = (ToolTip = "Finds a tracked plane by its ID.", keyword = "depth, plane, surface, id"), BlueprintPure)
+		bool GetPlane(int32 ID, FTangoPlane& Plane);
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Tango|Depth", meta = (ToolTip = "The space the planes are tracked in. Depth Space is not supported as planes would not persist."))
+		TEnumAsByte<ETangoPointSpace::Type> PlaneSpace;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Tango|Depth", meta = (ToolTip = "Detect planes on the filtered point stream instead of every point."))
+		bool bUseFilteredPoints;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Tango|Depth", meta = (ToolTip = "Maximum distance in Unreal units of a point from a plane to count towards it.", ClampMin = "0.1"))
+		float DistanceThreshold;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Tango|Depth", meta = (ToolTip = "Minimum number of sampled points supporting a plane.", ClampMin = "3"))
+		int32 MinPoints;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Tango|Depth", meta = (ToolTip = "Maximum number of planes extracted from a single depth frame.", ClampMin = "1"))
+		int32 MaxPlanesPerFrame;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Tango|Depth", meta = (ToolTip = "Maximum angle in degrees between the normals of two planes to merge them.", ClampMin = "0", ClampMax = "90"))
+		float MergeAngle;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Tango|Depth", meta = (ToolTip = "Maximum distance in Unreal units between two planes to merge them.", ClampMin = "0"))
+		float MergeDistance;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Tango|Depth", meta = (ToolTip = "Number of depth frames a plane may be in view without being seen before it is removed.", ClampMin = "1"))
+		int32 RemoveAfterMissedFrames;
+
+private:
+	TangoPlaneDetector* Detector;
+	int64 LastPushedGeneration;
+	TMap<int32, FTangoPlane> Planes;
+};
@@ -17,30 +17,83 @@ limitations under the License.*/
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnTangoXYZijDataAvailable, float, TimeStamp);
 
+UENUM(BlueprintType)
+namespace ETangoPointSpace
+{
+	enum Type
+	{
+		LOCAL UMETA(DisplayName = "Depth Space"),
+		ADF_DEPTH UMETA(DisplayName = "ADF Space"),
+		STARTOFSERVICE_DEPTH UMETA(DisplayName = "Start of Service Space")
+	};
+}
+
+USTRUCT(BlueprintType)
+struct TANGOPLUGIN_API FTangoPointCloudFilterStats
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tango|Depth", meta = (ToolTip = "Number of points in the depth frame before filtering"))
+		int32 InputPoints = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tango|Depth", meta = (ToolTip = "Number of points left after the confidence filter and voxel downsampling"))
+		int32 OutputPoints = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tango|Depth", meta = (ToolTip = "Time in milliseconds the filter took for this frame"))
+		float FilterTime = 0.0f;
+};
+
+class TangoPointCloudIndex;
+
+/**
+ * One depth frame converted to Unreal axes and units.
+ * Frames are filled once by the point cloud worker and then shared read-only by every consumer.
+ */
+struct TANGOPLUGIN_API FTangoPointCloudFrame
+{
+	FTangoPointCloudFrame() : Timestamp(0), Generation(0), Space(ETangoPointSpace::LOCAL), bFiltered(false) {}
+
+	TArray<FVector> Points;
+	double Timestamp;
+	//Generation of the depth frame in the point cloud ring this was converted from
+	int64 Generation;
+	ETangoPointSpace::Type Space;
+	//Whether the points went through the confidence and voxel filter, FilterStats is only set if so
+	bool bFiltered;
+	FTangoPointCloudFilterStats FilterStats;
+	//Pose of the depth camera in Space at Timestamp, identity for LOCAL
+	FTransform DepthToSpace;
+	//Spatial index of the points, built in LOCAL space and shared by the frames of every space. Null if indexing is disabled.
+	TSharedPtr<TangoPointCloudIndex, ESPMode::ThreadSafe> Index;
+
+	/** Index of the point closest to Location within MaxDistance, or INDEX_NONE. Location is in Space. */
+	int32 FindNearestPoint(const FVector& Location, float MaxDistance) const;
+	/** Adds the indices of all points within Radius of Location to OutIndices. Location is in Space. */
+	void FindPointsInRadius(const FVector& Location, float Radius, TArray<int32>& OutIndices) const;
+	/** Index of the first point within Radius of the ray, or INDEX_NONE. OutDistance is set to its distance along the ray. */
+	int32 RaycastPoints(const FVector& Start, const FVector& Direction, float Radius, float MaxDistance, float& OutDistance) const;
+};
+
+typedef TSharedPtr<const FTangoPointCloudFrame, ESPMode::ThreadSafe> FTangoPointCloudFramePtr;
 
 UCLASS(ClassGroup = Tango, Blueprintable)
 class TANGOPLUGIN_API UPointCloudContainer : public UObject
 {
 	GENERATED_BODY()
 public:
+	/** Returns the points of the held frame. The array stays valid until the container is given a new frame. */
 	const TArray<FVector>& GetPointCloudArray(float& Timestamp);
 
+	/** Keeping a copy of the returned pointer keeps the frame alive independently of the container. */
+	FTangoPointCloudFramePtr GetFrame() const { return Frame; }
+	void SetFrame(const FTangoPointCloudFramePtr& InFrame) { Frame = InFrame; }
+
 private:
+	FTangoPointCloudFramePtr Frame;
 	//The Dummy Point cloud is returned in the event that the Point Cloud pointer is null.
 	TArray<FVector> DummyPointCloud;
 };
 
-UENUM(BlueprintType)
-namespace ETangoPointSpace
-{
-	enum Type
-	{
-		LOCAL UMETA(DisplayName = "Depth Space"),
-		ADF_DEPTH UMETA(DisplayName = "ADF Space"),
-		STARTOFSERVICE_DEPTH UMETA(DisplayName = "Start of Service Space")
-	};
-}
-
 UCLASS(ClassGroup = Tango, Blueprintable, meta = (BlueprintSpawnableComponent))
 class TANGOPLUGIN_API UTangoPointCloudComponent : public UActorComponent
 {
@@ -49,6 +102,7 @@ class TANGOPLUGIN_API UTangoPointCloudComponent : public UActorComponent
 
 public:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	/**
 	* Returns the pose along the plane at the specified screen point
@@ -56,6 +110,14 @@ public:
 	UFUNCTION(Category = "Tango|Depth", meta = (ToolTip = "Returns the pose along the plane at the specified screen point", keyword = "fit, plane"), BlueprintPure)
 		bool FitPlane(const FVector2D& ScreenPoint, FTransform& Pose);
 
+	/**
+	* Fits a plane at each of the screen points against the same depth frame.
+	* Much cheaper than calling FitPlane for each point.
+	* @return The number of planes that were found.
+	*/
+	UFUNCTION(Category = "Tango|Depth", meta = (ToolTip = "Returns the poses along the planes at the specified screen points", keyword = "fit, plane, batch"), BlueprintCallable)
+		int32 FitPlanes(const TArray<FVector2D>& ScreenPoints, TArray<FTransform>& Poses, TArray<bool>& Successes);
+
 	/*
 	* Get the max number of points a single frame from the point cloud can contain.
 	* @param Target The Unreal Engine / Tango Point Cloud interface object.
@@ -66,5 +128,52 @@ public:
 
 	UFUNCTION(Category = "Tango|Depth", meta = (ToolTip = "Get current timestamp", keyword = "depth, point cloud, timestamp"), BlueprintPure)
 		float GetPointCloudTimestamp();
-};
 
+	/** GetPointCloudTimestamp in full precision, for matching against pose and image timestamps in C++. */
+	double GetPointCloudPreciseTimestamp();
+
+	/*
+	* Passes a container for the latest point cloud around, so C++ code can read it without copying.
+	* @return Container holding the latest frame in PointSpace.
+	*/
+	UFUNCTION(Category = "Tango|Depth", meta = (ToolTip = "Passes a container object for the point cloud data around without copying it.", keyword = "depth, point cloud, container, reference"), BlueprintPure)
+		UPointCloudContainer* PassPointCloudReferenceContainer();
+
+	UFUNCTION(Category = "Tango|Depth", meta = (ToolTip = "Retrieves the number of points contained within the latest frame from the point cloud.", keyword = "depth, point cloud, count, number"), BlueprintPure)
+		int32 GetCurrentPointCount(float& Timestamp);
+
+	UFUNCTION(Category = "Tango|Depth", meta = (ToolTip = "Retrieve a single point from the point cloud in Unreal coordinates.", keyword = "depth, point cloud, point, single"), BlueprintPure)
+		FVector GetSinglePoint(int32 Index, float& Timestamp, bool& ValidValue);
+
+	UFUNCTION(Category = "Tango|Depth", meta = (ToolTip = "Point counts and filter time of the latest filtered frame.", keyword = "depth, point cloud, filter, voxel, stats"), BlueprintPure)
+		FTangoPointCloudFilterStats GetFilterStats();
+
+	UFUNCTION(Category = "Tango|Depth", meta = (ToolTip = "Finds the point of the latest frame closest to Location. Location and Point are in PointSpace.", keyword = "depth, point cloud, nearest, closest"), BlueprintPure)
+		bool FindNearestPoint(const FVector& Location, float MaxDistance, FVector& Point, float& Timestamp);
+
+	UFUNCTION(Category = "Tango|Depth", meta = (ToolTip = "Returns all points of the latest frame within Radius of Location. Location and points are in PointSpace.", keyword = "depth, point cloud, radius, area"), BlueprintPure)
+		TArray<FVector> GetPointsInRadius(const FVector& Location, float Radius, float& Timestamp);
+
+	UFUNCTION(Category = "Tango|Depth", meta = (ToolTip = "Returns the first point of the latest frame along the ray that lies within Radius of it. Start, Direction and HitPoint are in PointSpace.", keyword = "depth, point cloud, ray, hit, trace"), BlueprintPure)
+		bool RaycastPoints(const FVector& Start, const FVector& Direction, float Radius, float MaxDistance, FVector& HitPoint, float& Timestamp);
+
+	/** The latest frame in PointSpace, or null if none has arrived yet. */
+	FTangoPointCloudFramePtr GetLatestFrame() const { return LatestFrame; }
+
+	/** Called on the game thread by the device when a new frame in PointSpace is available. */
+	void SetLatestFrame(const FTangoPointCloudFramePtr& Frame);
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tango|Depth", meta = (ToolTip = "The space the points of this component are expressed in."))
+		TEnumAsByte<ETangoPointSpace::Type> PointSpace;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tango|Depth", meta = (ToolTip = "Receive the confidence filtered and voxel downsampled stream instead of every point. Configured through the Tango config."))
+		bool bUseFilteredPoints;
+
+	UPROPERTY(BlueprintAssignable, Category = "Tango|Depth", meta = (ToolTip = "Fired on the tick a new depth frame becomes available."))
+		FOnTangoXYZijDataAvailable OnTangoXYZijAvailable;
+
+private:
+	FTangoPointCloudFramePtr LatestFrame;
+	UPROPERTY(transient)
+		UPointCloudContainer* Container;
+};
@@ -0,0 +1,75 @@
+/*Copyright 2016 Google
+Author: Opaque Media Group
+ 
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.*/
+
+#pragma once
+
+#include "Components/ActorComponent.h"
+#include "TangoPointCloudComponent.h"
+#include "TangoPointMapComponent.generated.h"
+
+class TangoPointMap;
+
+/**
+ * Accumulates the depth frames into a persistent voxel map in ADF or Start of Service space.
+ * Each voxel stores the mean of the points that fell into it. Memory is capped, the voxels that were
+ * observed least recently are evicted first.
+ */
+UCLASS(ClassGroup = Tango, Blueprintable, meta = (BlueprintSpawnableComponent))
+class TANGOPLUGIN_API UTangoPointMapComponent : public UActorComponent
+{
+	GENERATED_BODY()
+public:
+	UTangoPointMapComponent();
+
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction) override;
+
+	UFUNCTION(Category = "Tango|Depth", meta = (ToolTip = "Returns the mean point of every voxel in the map.", keyword = "depth, point cloud, map, accumulate"), BlueprintCallable)
+		TArray<FVector> GetMapPoints();
+
+	UFUNCTION(Category = "Tango|Depth", meta = (ToolTip = "Returns the mean point of every voxel inside the box.", keyword = "depth, point cloud, map, box, area"), BlueprintCallable)
+		TArray<FVector> GetMapPointsInBox(const FBox& Box);
+
+	UFUNCTION(Category = "Tango|Depth", meta = (ToolTip = "Number of voxels currently held by the map.", keyword = "depth, point cloud, map, count"), BlueprintPure)
+		int32 GetNumVoxels();
+
+	UFUNCTION(Category = "Tango|Depth", meta = (ToolTip = "Approximate memory used by the map in megabytes.", keyword = "depth, point cloud, map, memory"), BlueprintPure)
+		float GetMemoryUsage();
+
+	UFUNCTION(Category = "Tango|Depth", meta = (ToolTip = "Removes all points from the map.", keyword = "depth, point cloud, map, clear, reset"), BlueprintCallable)
+		void ClearMap();
+
+	/** The map itself, for C++ code that wants to query it without going through Blueprint arrays. */
+	TangoPointMap* GetPointMap() const { return PointMap; }
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Tango|Depth", meta = (ToolTip = "The space the map is built in. Depth Space is not supported as points would not persist."))
+		TEnumAsByte<ETangoPointSpace::Type> MapSpace;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Tango|Depth", meta = (ToolTip = "Accumulate the filtered point stream instead of every point."))
+		bool bUseFilteredPoints;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Tango|Depth", meta = (ToolTip = "Edge length of the voxels in Unreal units.", ClampMin = "0.1"))
+		float VoxelSize;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Tango|Depth", meta = (ToolTip = "Memory cap of the map in megabytes. The least recently observed voxels are evicted beyond it.", ClampMin = "1"))
+		int32 MaxMemoryMB;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tango|Depth", meta = (ToolTip = "Voxels observed fewer times than this are left out of the results to suppress noise.", ClampMin = "1"))
+		int32 MinObservations;
+
+private:
+	TangoPointMap* PointMap;
+	int64 LastPushedGeneration;
+};